@@ -0,0 +1,340 @@
+#include <cpp++/json/yy_json.h>
+#include <cpp++/json/nlohmann_json.h>
+#include <cpp++/toml/marzer_toml.h>
+#include <cpp++/proto/google_protobuf.h>
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+
+/*
+ * Allocation counter, every `operator new` of the process goes through here
+ */
+namespace {
+    std::atomic<size_t> allocations = 0;
+} // namespace
+
+#if defined(__GNUC__) && !defined(__clang__)
+// `free` on a pointer from `new` is fine here since `new` itself is replaced by `malloc`
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size, std::align_val_t al) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    // `aligned_alloc` wants a size that is a multiple of the alignment
+    const size_t align   = static_cast<size_t>(al);
+    const size_t rounded = size ? (size + align - 1) / align * align : align;
+    if (void *ptr = std::aligned_alloc(align, rounded))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC diagnostic pop
+#endif
+
+
+/*
+ * Fixtures
+ */
+namespace {
+    using cppxx::Tag;
+
+    struct Person {
+        Tag<std::string>                name       = "json:`name` toml:`name` proto:`1`";
+        Tag<int>                        age        = "json:`age` toml:`age` proto:`2`";
+        Tag<std::optional<std::string>> address    = "json:`address` toml:`address` proto:`3`";
+        Tag<std::string>                department = {"json:`department,skipmissing` toml:`department,skipmissing` proto:`4`", "unset"};
+        Tag<int>                        salary     = "json:`salary,omitempty` toml:`salary,omitempty` proto:`5`";
+        Tag<std::tm>                    created_at = "json:`createdAt` toml:`createdAt`";
+    };
+
+    template <int D>
+    struct Nested {
+        Tag<int>           depth = "json:`depth` toml:`depth` proto:`1`";
+        Tag<std::string>   label = "json:`label` toml:`label` proto:`2`";
+        Tag<Nested<D - 1>> child = "json:`child` toml:`child` proto:`3`";
+    };
+
+    template <>
+    struct Nested<0> {
+        Tag<int>         depth = "json:`depth` toml:`depth` proto:`1`";
+        Tag<std::string> label = "json:`label` toml:`label` proto:`2`";
+    };
+
+    // TOML documents must be tables, so every payload is wrapped
+    template <typename T>
+    struct Payload {
+        Tag<T> items = "json:`items` toml:`items` proto:`1`";
+    };
+
+    constexpr size_t n_items = 1000;
+
+    Person make_person(size_t i) {
+        Person p;
+        p.name()       = "Sucipto " + std::to_string(i);
+        p.age()        = int(20 + i % 50);
+        p.address()    = i % 3 ? std::optional<std::string>("Jl. Sudirman No. " + std::to_string(i) + ", Jakarta") : std::nullopt;
+        p.department() = i % 2 ? "Engineering" : "Finance";
+        p.salary()     = int(1000 + i);
+        p.created_at() = cppxx::tm_from_string("2024-01-02T03:04:05Z");
+        return p;
+    }
+
+    template <int D>
+    Nested<D> make_nested() {
+        Nested<D> n;
+        n.depth() = D;
+        n.label() = "level " + std::to_string(D);
+        if constexpr (D > 0)
+            n.child() = make_nested<D - 1>();
+        return n;
+    }
+
+    Payload<std::vector<Person>> make_vector() {
+        Payload<std::vector<Person>> p;
+        for (size_t i = 0; i < n_items; ++i)
+            p.items().push_back(make_person(i));
+        return p;
+    }
+
+    Payload<std::unordered_map<std::string, Person>> make_map() {
+        Payload<std::unordered_map<std::string, Person>> p;
+        for (size_t i = 0; i < n_items; ++i)
+            p.items().emplace("person_" + std::to_string(i), make_person(i));
+        return p;
+    }
+
+    Payload<std::vector<std::variant<int, std::string, Person>>> make_variant() {
+        Payload<std::vector<std::variant<int, std::string, Person>>> p;
+        for (size_t i = 0; i < n_items; ++i)
+            switch (i % 3) {
+            case 0:
+                p.items().emplace_back(int(i));
+                break;
+            case 1:
+                p.items().emplace_back("item " + std::to_string(i));
+                break;
+            default:
+                p.items().emplace_back(make_person(i));
+            }
+        return p;
+    }
+
+    Payload<std::vector<std::string>> make_strings() {
+        Payload<std::vector<std::string>> p;
+        for (size_t i = 0; i < n_items; ++i)
+            p.items().push_back(
+                std::string(64 + i % 192, char('a' + i % 26)) + " \"quoted\" \\ tab\t unicode é中 " + std::to_string(i)
+            );
+        return p;
+    }
+} // namespace
+
+
+/*
+ * Backends
+ */
+namespace {
+    struct YyJson {
+        static constexpr const char *name = "yy_json";
+
+        template <typename T>
+        static std::string dump(const T &v) {
+            return cppxx::json::yy_json::dump(v);
+        }
+
+        template <typename T>
+        static void parse(const std::string &src, T &v) {
+            cppxx::json::yy_json::parse(src, v);
+        }
+    };
+
+    // same as `YyJson` with the per-thread parser and dumper, whose memory is kept between iterations
+    struct YyJsonReuse {
+        static constexpr const char *name = "yy_json_reuse";
+
+        template <typename T>
+        static std::string dump(const T &v) {
+            return cppxx::json::yy_json::Dumper::local().dump(v);
+        }
+
+        template <typename T>
+        static void parse(const std::string &src, T &v) {
+            cppxx::json::yy_json::Parser::local().parse(src, v);
+        }
+    };
+
+    struct NlohmannJson {
+        static constexpr const char *name = "nlohmann_json";
+
+        template <typename T>
+        static std::string dump(const T &v) {
+            return cppxx::json::nlohmann_json::Dump{}.from(v);
+        }
+
+        template <typename T>
+        static void parse(const std::string &src, T &v) {
+            cppxx::json::nlohmann_json::Parse<>{src}.into(v);
+        }
+    };
+
+    struct MarzerToml {
+        static constexpr const char *name = "marzer_toml";
+
+        template <typename T>
+        static std::string dump(const T &v) {
+            return cppxx::serde::Dump<::toml::table, std::string>{}.from(v);
+        }
+
+        template <typename T>
+        static void parse(const std::string &src, T &v) {
+            cppxx::toml::marzer_toml::parse(src, v);
+        }
+    };
+
+    struct GoogleProtobuf {
+        static constexpr const char *name = "google_protobuf";
+
+        template <typename T>
+        static std::string dump(const T &v) {
+            return cppxx::proto::google_protobuf::dump(v);
+        }
+
+        template <typename T>
+        static void parse(const std::string &src, T &v) {
+            cppxx::proto::google_protobuf::parse(src, v);
+        }
+    };
+} // namespace
+
+
+/*
+ * Benchmarks
+ */
+namespace {
+    void set_counters(benchmark::State &state, size_t bytes, size_t items, size_t allocs) {
+        state.SetBytesProcessed(int64_t(state.iterations() * bytes));
+        state.SetItemsProcessed(int64_t(state.iterations() * items));
+        state.counters["allocs/op"] = benchmark::Counter(double(allocs), benchmark::Counter::kAvgIterations);
+    }
+
+    template <typename Backend, typename T>
+    void bench_dump(benchmark::State &state, const T &fixture, size_t items) {
+        size_t bytes  = 0;
+        size_t allocs = allocations.load();
+        for (auto _ : state) {
+            std::string out = Backend::dump(fixture);
+            bytes           = out.size();
+            benchmark::DoNotOptimize(out);
+        }
+        set_counters(state, bytes, items, allocations.load() - allocs);
+    }
+
+    template <typename Backend, typename T>
+    void bench_parse(benchmark::State &state, const std::string &src, size_t items) {
+        size_t allocs = allocations.load();
+        for (auto _ : state) {
+            T out = {};
+            Backend::parse(src, out);
+            benchmark::DoNotOptimize(out);
+        }
+        set_counters(state, src.size(), items, allocations.load() - allocs);
+    }
+
+    template <typename Backend, typename T>
+    void register_dump(const std::string &payload, const T &fixture, size_t items) {
+        benchmark::RegisterBenchmark(
+            (std::string(Backend::name) + "/dump/" + payload).c_str(),
+            [fixture, items](benchmark::State &state) { bench_dump<Backend>(state, fixture, items); }
+        );
+    }
+
+    template <typename Backend, typename T>
+    void register_parse(const std::string &payload, const T &fixture, size_t items) {
+        benchmark::RegisterBenchmark(
+            (std::string(Backend::name) + "/parse/" + payload).c_str(),
+            [src = Backend::dump(fixture), items](benchmark::State &state) { bench_parse<Backend, T>(state, src, items); }
+        );
+    }
+
+    template <typename... Backends, typename T>
+    void register_payload(const std::string &payload, const T &fixture, size_t items) {
+        (register_dump<Backends>(payload, fixture, items), ...);
+        (register_parse<Backends>(payload, fixture, items), ...);
+    }
+
+    void register_all() {
+        const auto person  = make_person(42);
+        const auto nested  = make_nested<16>();
+        const auto vector  = make_vector();
+        const auto map     = make_map();
+        const auto variant = make_variant();
+        const auto strings = make_strings();
+
+        register_payload<YyJson, YyJsonReuse, NlohmannJson, MarzerToml>("flat", person, 1);
+        register_payload<YyJson, YyJsonReuse, NlohmannJson, MarzerToml>("nested", nested, 17);
+        register_payload<YyJson, YyJsonReuse, NlohmannJson, MarzerToml>("vector", vector, n_items);
+        register_payload<YyJson, YyJsonReuse, NlohmannJson, MarzerToml>("map", map, n_items);
+        register_payload<YyJson, YyJsonReuse, NlohmannJson, MarzerToml>("variant", variant, n_items);
+        register_payload<YyJson, YyJsonReuse, NlohmannJson, MarzerToml>("strings", strings, n_items);
+
+        // protobuf has no maps nor variants here
+        register_payload<GoogleProtobuf>("flat", person, 1);
+        register_payload<GoogleProtobuf>("nested", nested, 17);
+        register_payload<GoogleProtobuf>("vector", vector, n_items);
+        register_payload<GoogleProtobuf>("strings", strings, n_items);
+    }
+} // namespace
+
+
+int main(int argc, char **argv) {
+    // besides the console report, write the results as JSON unless told otherwise, so that runs can be compared
+    std::vector<char *> args(argv, argv + argc);
+    std::string         out = "--benchmark_out=bench_serde.json";
+    std::string         fmt = "--benchmark_out_format=json";
+
+    bool has_out = false;
+    for (char *arg : args)
+        has_out |= std::strncmp(arg, "--benchmark_out=", 16) == 0;
+    if (!has_out) {
+        args.push_back(out.data());
+        args.push_back(fmt.data());
+    }
+
+    int n = int(args.size());
+    benchmark::Initialize(&n, args.data());
+    if (benchmark::ReportUnrecognizedArguments(n, args.data()))
+        return 1;
+
+    register_all();
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -11,8 +11,8 @@ namespace cppxx::cli {
         bool             positional = false;
         std::string_view help;
 
-        template <typename T>
-        static constexpr TagInfo from_tagged(const Tag<T> &field) {
+        template <typename T, typename S>
+        static constexpr TagInfo from_tagged(const Tag<T, S> &field) {
             TagInfo opt = {};
 
             for (std::string_view sv = field.get_tag("opt"); !sv.empty();) {
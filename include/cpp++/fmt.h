@@ -13,9 +13,9 @@
 #    include <fmt/chrono.h>
 #endif
 
-template <typename T>
-struct fmt::formatter<cppxx::Tag<T>, char, std::enable_if_t<fmt::is_formattable<T, char>::value>> : fmt::formatter<T> {
-    fmt::context::iterator format(const cppxx::Tag<T> &v, fmt::context &c) const {
+template <typename T, typename S>
+struct fmt::formatter<cppxx::Tag<T, S>, char, std::enable_if_t<fmt::is_formattable<T, char>::value>> : fmt::formatter<T> {
+    fmt::context::iterator format(const cppxx::Tag<T, S> &v, fmt::context &c) const {
         if (cppxx::serde::TagInfo ti = cppxx::serde::get_tag_info(v, "fmt"); ti.key != "") {
             fmt::context::iterator out = c.out();
 
@@ -2,8 +2,11 @@
 #define CPPXX_JSON_JSON_H
 
 #include <cpp++/serde/tag_info.h>
+#include <cpp++/serde/key_map.h>
 
 namespace cppxx::json {
+    using TagKey = tag_string<'j', 's', 'o', 'n'>;
+
     template <typename T>
     constexpr serde::TagInfo get_tag_info(const T &field) {
         return serde::get_tag_info(field, "json");
@@ -11,7 +14,20 @@ namespace cppxx::json {
 
     template <typename... T>
     constexpr serde::TagInfoTuple<sizeof...(T)> get_tag_info_from_tuple(const std::tuple<T...> &fields) {
-        return serde::get_tag_info_from_tuple(fields, "json");
+        if constexpr (serde::has_static_tags_v<std::tuple<T...>>)
+            return serde::static_tag_info_tuple_v<TagKey, std::tuple<T...>>;
+        else
+            return serde::get_tag_info_from_tuple(fields, "json");
+    }
+
+    template <typename... T, typename F>
+    decltype(auto) with_tag_info_tuple(const std::tuple<T...> &fields, F &&fn) {
+        return serde::with_tag_info_tuple<TagKey>(fields, std::forward<F>(fn));
+    }
+
+    template <typename... T, typename F>
+    decltype(auto) with_key_map(const std::tuple<T...> &fields, const serde::TagInfoTuple<sizeof...(T)> &ti, F &&fn) {
+        return serde::with_key_map<TagKey>(fields, ti, std::forward<F>(fn));
     }
 } // namespace cppxx::json
 
@@ -4,7 +4,11 @@
 #include <cpp++/json/json.h>
 #include <cpp++/serde/serialize.h>
 #include <cpp++/serde/deserialize.h>
+#include <cpp++/serde/enum.h>
 #include <cpp++/serde/error.h>
+#include <cpp++/serde/projection.h>
+#include <cpp++/serde/result.h>
+#include <cpp++/serde/variant.h>
 #include <cpp++/time.h>
 #include <variant>
 
@@ -37,6 +41,56 @@ namespace cppxx::json::nlohmann_json {
     using Parse = ::cppxx::serde::Parse<nlohmann::json, From>;
 } // namespace cppxx::json::nlohmann_json
 
+namespace cppxx::json::nlohmann_json::detail {
+    /// Node of `serde::detail::deserialize_variant` over a DOM
+    struct variant_node {
+        const nlohmann::json &j;
+
+        unsigned kinds() const {
+            namespace kind = serde::node_kind;
+            switch (j.type()) {
+                case nlohmann::json::value_t::null:
+                    return kind::null;
+                // arithmetic types are read from any number, and from booleans
+                case nlohmann::json::value_t::boolean:
+                    return kind::boolean | kind::uint | kind::sint | kind::real;
+                case nlohmann::json::value_t::number_integer:
+                case nlohmann::json::value_t::number_unsigned:
+                case nlohmann::json::value_t::number_float:
+                    return kind::uint | kind::sint | kind::real;
+                case nlohmann::json::value_t::string:
+                    return kind::string;
+                case nlohmann::json::value_t::array:
+                    return kind::array;
+                case nlohmann::json::value_t::object:
+                    return kind::object;
+                default:
+                    return 0;
+            }
+        }
+
+        std::string type_name() const {
+            return j.type_name();
+        }
+
+        bool has_key(std::string_view key) const {
+            return j.find(key) != j.end();
+        }
+
+        std::optional<std::string_view> string_at(std::string_view key) const {
+            auto it = j.find(key);
+            if (it == j.end() || !it->is_string())
+                return std::nullopt;
+            return std::string_view(it->template get_ref<const std::string &>());
+        }
+
+        template <typename A>
+        bool into(A &a, serde::error *err) const {
+            return serde::Deserialize<nlohmann::json, A>{j}.into(a, err);
+        }
+    };
+} // namespace cppxx::json::nlohmann_json::detail
+
 namespace nlohmann {
     // optional
     template <typename T>
@@ -48,110 +102,192 @@ namespace nlohmann {
                 j = nullptr;
         }
 
+        /// `as_int` is the `int` option of the field, for an optional enum
+        static void to_json(json &j, const std::optional<T> &opt, bool as_int) {
+            if (opt.has_value())
+                adl_serializer<T>::to_json(j, *opt, as_int);
+            else
+                j = nullptr;
+        }
+
         static void from_json(const json &j, std::optional<T> &opt) {
             if (j.is_null())
                 opt.reset();
             else
                 opt = j.get<T>();
         }
+
+        static void from_json(const json &j, std::optional<T> &opt, bool as_int) {
+            if (j.is_null())
+                return opt.reset();
+            if (!opt)
+                opt.emplace();
+            adl_serializer<T>::from_json(j, *opt, as_int);
+        }
     };
 
     // tuple
     template <typename... Ts>
     struct adl_serializer<std::tuple<Ts...>> {
         static void to_json(json &j, const std::tuple<Ts...> &tpl) {
-            const cppxx::serde::TagInfoTuple<sizeof...(Ts)>         ts     = cppxx::json::get_tag_info_from_tuple(tpl);
-            const std::array<cppxx::serde::TagInfo, sizeof...(Ts)> &ti     = ts.ts;
-            const bool                                              is_obj = ts.is_obj;
-
-            if (is_obj)
-                j = nlohmann::json::object();
-            else
-                j = nlohmann::json::array();
-
-            cppxx::tuple_for_each(tpl, [&](const auto &item, const size_t i) {
-                const cppxx::serde::TagInfo &t = ti[i];
-                const auto                  &v = cppxx::serde::detail::get_underlying_value(item);
-                using T                        = std::decay_t<decltype(v)>;
-                constexpr bool serializable    = cppxx::serde::is_serializable_v<nlohmann::json, T>;
-
-                if (!serializable || (is_obj && t.key == "") || (t.omitempty && cppxx::serde::detail::is_empty_value(v)))
-                    return;
-
-                auto &val = is_obj ? j[t.key] : j[i];
-                try {
-                    if (t.noserde)
-                        if constexpr (std::is_same_v<T, std::string>)
-                            val = nlohmann::json::parse(v);
-                        else
-                            throw cppxx::serde::error("field with tag `noserde` can only be serialized from std::string");
-                    else {
-                        if constexpr (serializable)
+            cppxx::json::with_tag_info_tuple(tpl, [&](const cppxx::serde::TagInfoTuple<sizeof...(Ts)> &ts) {
+                const std::array<cppxx::serde::TagInfo, sizeof...(Ts)> &ti     = ts.ts;
+                const bool                                              is_obj = ts.is_obj;
+
+                if (is_obj)
+                    j = nlohmann::json::object();
+                else
+                    j = nlohmann::json::array();
+
+                cppxx::tuple_for_each(tpl, [&](const auto &item, auto i) {
+                    const cppxx::serde::TagInfo &t = ti[i];
+                    const auto                  &v = cppxx::serde::detail::get_underlying_value(item);
+                    using T                        = std::decay_t<decltype(v)>;
+                    constexpr bool serializable    = cppxx::serde::is_serializable_v<nlohmann::json, T>;
+                    constexpr cppxx::serde::TagFlags f =
+                        cppxx::serde::tag_flags_v<cppxx::json::TagKey, std::tuple<Ts...>, i>;
+
+                    if constexpr (serializable) {
+                        if constexpr (f.unkeyed)
+                            if (is_obj && t.key == "")
+                                return;
+                        if constexpr (f.omitempty)
+                            if (t.omitempty && cppxx::serde::detail::is_empty_value(v))
+                                return;
+
+                        auto &val    = is_obj ? j[t.key] : j[size_t(i)];
+                        auto  encode = [&] {
+                            if constexpr (f.noserde)
+                                if (t.noserde) {
+                                    if constexpr (std::is_same_v<T, std::string>)
+                                        val = nlohmann::json::parse(v);
+                                    else
+                                        throw cppxx::serde::error(
+                                            "field with tag `noserde` can only be serialized from std::string"
+                                        );
+                                    return;
+                                }
+                            cppxx::serde::detail::check_as_int<T, f.is_static, f.as_int>(t.as_int);
                             try {
-                                val = v;
+                                if constexpr (cppxx::serde::detail::takes_as_int_v<T> && f.as_int)
+                                    adl_serializer<T>::to_json(val, v, t.as_int);
+                                else
+                                    val = v;
                             } catch (nlohmann::json::exception &e) {
                                 throw cppxx::serde::error(e.what());
                             }
+                        };
+
+                        try {
+                            encode();
+                        } catch (cppxx::serde::error &e) {
+                            if (is_obj)
+                                e.add_context(t.key);
+                            else
+                                e.add_context(i);
+                            throw;
+                        }
                     }
-                } catch (cppxx::serde::error &e) {
-                    if (is_obj)
-                        e.add_context(t.key);
-                    else
-                        e.add_context(i);
-                    throw;
-                }
+                });
             });
         }
 
         static void from_json(const json &j, std::tuple<Ts...> &tpl) {
-            const cppxx::serde::TagInfoTuple<sizeof...(Ts)>         ts     = cppxx::json::get_tag_info_from_tuple(tpl);
-            const std::array<cppxx::serde::TagInfo, sizeof...(Ts)> &ti     = ts.ts;
-            const bool                                              is_obj = ts.is_obj;
-
-            if (is_obj && !j.is_object())
-                throw cppxx::serde::type_mismatch_error("object", j.type_name());
-            if (!is_obj && !j.is_array())
-                throw cppxx::serde::type_mismatch_error("array", j.type_name());
-
-            cppxx::tuple_for_each(tpl, [&](auto &item, const size_t i) {
-                const cppxx::serde::TagInfo &t = ti[i];
-                auto                        &v = cppxx::serde::detail::get_underlying_value(item);
-                using T                        = std::decay_t<decltype(v)>;
-                constexpr bool deserializable  = cppxx::serde::is_deserializable_v<nlohmann::json, T>;
-
-                if (!deserializable || (is_obj && t.key == ""))
-                    return;
-
-                const nlohmann::json *ptr = nullptr;
-                try {
-                    try {
-                        ptr = is_obj ? &j.at(t.key) : &j.at(i);
-                    } catch (nlohmann::json::exception &e) {
-                        if (t.skipmissing)
-                            return;
-                        else
-                            throw cppxx::serde::error(e.what());
-                    }
-                    if (t.noserde)
-                        if constexpr (std::is_same_v<T, std::string>)
-                            v = ptr->dump();
-                        else
-                            throw cppxx::serde::error("field with tag `noserde` can only be deserialized into std::string");
-                    else {
-                        if constexpr (deserializable)
+            from_json(j, tpl, nullptr);
+        }
+
+        /// `selected` are the fields to decode by index, all when null, see `cppxx::serde::fields`
+        static void from_json(const json &j, std::tuple<Ts...> &tpl, const bool *selected) {
+            cppxx::json::with_tag_info_tuple(tpl, [&](const cppxx::serde::TagInfoTuple<sizeof...(Ts)> &ts) {
+                const std::array<cppxx::serde::TagInfo, sizeof...(Ts)> &ti     = ts.ts;
+                const bool                                              is_obj = ts.is_obj;
+
+                if (is_obj && !j.is_object())
+                    throw cppxx::serde::type_mismatch_error("object", j.type_name());
+                if (!is_obj && !j.is_array())
+                    throw cppxx::serde::type_mismatch_error("array", j.type_name());
+
+                auto field = [&](auto &item, auto i, const nlohmann::json *ptr) {
+                    const cppxx::serde::TagInfo &t = ti[i];
+                    auto                        &v = cppxx::serde::detail::get_underlying_value(item);
+                    using T                        = std::decay_t<decltype(v)>;
+                    constexpr bool deserializable  = cppxx::serde::is_deserializable_v<nlohmann::json, T>;
+                    constexpr cppxx::serde::TagFlags f =
+                        cppxx::serde::tag_flags_v<cppxx::json::TagKey, std::tuple<Ts...>, i>;
+
+                    if constexpr (deserializable) {
+                        if constexpr (f.unkeyed)
+                            if (is_obj && t.key == "")
+                                return;
+
+                        auto decode = [&] {
+                            if (!ptr)
+                                try {
+                                    ptr = is_obj ? &j.at(t.key) : &j.at(size_t(i));
+                                } catch (nlohmann::json::exception &e) {
+                                    if constexpr (f.skipmissing)
+                                        if (t.skipmissing)
+                                            return;
+                                    throw cppxx::serde::error(e.what());
+                                }
+                            if constexpr (f.noserde)
+                                if (t.noserde) {
+                                    if constexpr (std::is_same_v<T, std::string>)
+                                        v = ptr->dump();
+                                    else
+                                        throw cppxx::serde::error(
+                                            "field with tag `noserde` can only be deserialized into std::string"
+                                        );
+                                    return;
+                                }
+                            cppxx::serde::detail::check_as_int<T, f.is_static, f.as_int>(t.as_int);
                             try {
-                                ptr->get_to(v);
+                                if constexpr (cppxx::serde::detail::is_variant<T>::value)
+                                    adl_serializer<T>::from_json(*ptr, v, t.tag);
+                                else if constexpr (cppxx::serde::detail::takes_as_int_v<T> && f.as_int)
+                                    adl_serializer<T>::from_json(*ptr, v, t.as_int);
+                                else
+                                    ptr->get_to(v);
                             } catch (nlohmann::json::exception &e) {
                                 throw cppxx::serde::error(e.what());
                             }
+                        };
+
+                        try {
+                            decode();
+                        } catch (cppxx::serde::error &e) {
+                            if (is_obj)
+                                e.add_context(t.key);
+                            else
+                                e.add_context(i);
+                            throw;
+                        }
                     }
-                } catch (cppxx::serde::error &e) {
-                    if (is_obj)
-                        e.add_context(t.key);
-                    else
-                        e.add_context(i);
-                    throw;
-                }
+                };
+
+                if (!is_obj)
+                    return cppxx::tuple_for_each(tpl, [&](auto &item, auto i) {
+                        if (!selected || selected[i])
+                            field(item, i, nullptr);
+                    });
+
+                // walk the object once, dispatching each key to its field
+                cppxx::json::with_key_map(tpl, ts, [&](const cppxx::serde::KeyMap<sizeof...(Ts)> &km) {
+                    std::array<bool, sizeof...(Ts)> seen = {};
+
+                    for (auto it = j.begin(); it != j.end(); ++it) {
+                        const size_t i = km.find(it.key());
+                        if (i == km.npos || (selected && !selected[i]) || std::exchange(seen[i], true))
+                            continue;
+                        cppxx::tuple_visit(tpl, i, [&](auto &item, auto i) { field(item, i, &*it); });
+                    }
+
+                    // missing fields, looked up again so that the error is the one of `json::at`
+                    cppxx::tuple_for_each(tpl, [&](auto &item, auto i) {
+                        if (!seen[i] && (!selected || selected[i]))
+                            field(item, i, nullptr);
+                    });
+                });
             });
         }
     };
@@ -159,37 +295,18 @@ namespace nlohmann {
     template <typename... T>
     struct adl_serializer<std::variant<T...>> {
         static void from_json(const json &j, std::variant<T...> &v) {
-            try_for_each(j, v, std::index_sequence_for<T...>{});
+            from_json(j, v, {});
         }
 
-        static void to_json(json &j, const std::variant<T...> &v) {
-            std::visit([&](const auto &var) { j = var; }, v);
+        /// `tag` is the key naming the alternative, from the `tag=` option of the field
+        static void from_json(const json &j, std::variant<T...> &v, std::string_view tag) {
+            cppxx::serde::detail::deserialize_variant<json, cppxx::json::TagKey>(
+                v, cppxx::json::nlohmann_json::detail::variant_node{j}, tag
+            );
         }
 
-        template <size_t... I>
-        static void try_for_each(const json &j, std::variant<T...> &v, std::index_sequence<I...>) {
-            bool        done = false;
-            std::string type_names;
-            (
-                [&]() {
-                    using Elem = std::tuple_element_t<I, std::tuple<T...>>;
-                    try {
-                        if (!done) {
-                            auto element = Elem{};
-                            cppxx::serde::Deserialize<nlohmann::json, Elem>{j}.into(element);
-                            v    = std::move(element);
-                            done = true;
-                        }
-                    } catch (cppxx::serde::type_mismatch_error &e) {
-                        type_names += e.expected_type + '|';
-                    }
-                }(),
-                ...
-            );
-            if (!done) {
-                type_names.pop_back();
-                throw cppxx::serde::type_mismatch_error(type_names, j.type_name());
-            }
+        static void to_json(json &j, const std::variant<T...> &v) {
+            std::visit([&](const auto &var) { j = var; }, v);
         }
     };
 
@@ -213,6 +330,11 @@ namespace nlohmann {
             j.get_to(tpl);
         }
 
+        static void from_json(const json &j, S &v, const bool *selected) {
+            auto tpl = boost::pfr::structure_tie(v);
+            adl_serializer<decltype(tpl)>::from_json(j, tpl, selected);
+        }
+
         static void to_json(json &j, const S &v) {
             j = boost::pfr::structure_tie(v);
         }
@@ -223,26 +345,34 @@ namespace nlohmann {
     template <typename S>
     struct adl_serializer<S, std::enable_if_t<std::is_enum_v<S>>> {
         static void from_json(const json &j, S &v) {
-            auto str = j.get<std::string>();
-            auto e   = magic_enum::enum_cast<S>(str);
-            if (!e.has_value()) {
-                std::string what = "invalid value `" + str + "`, expected one of {";
-                for (std::string_view name : magic_enum::enum_names<S>()) {
-                    what += std::string(name) + ",";
-                }
-                what += "}";
-                throw cppxx::serde::error(what);
-            }
-            v = *e;
+            from_json(j, v, false);
+        }
+
+        /// `as_int` is the `int` option of the field
+        static void from_json(const json &j, S &v, bool as_int) {
+            if (as_int)
+                cppxx::serde::detail::enum_from_int<S>(j.get<std::underlying_type_t<S>>(), v);
+            else
+                cppxx::serde::detail::enum_from_name<S>(j.get_ref<const std::string &>(), v);
         }
 
         static void to_json(json &j, const S &v) {
-            j = magic_enum::enum_name(v);
+            to_json(j, v, false);
+        }
+
+        static void to_json(json &j, const S &v, bool as_int) {
+            if (as_int)
+                j = std::underlying_type_t<S>(v);
+            else
+                j = magic_enum::enum_name(v);
         }
     };
 #endif
 } // namespace nlohmann
 
+// after the serializers above, which it instantiates
+#include <cpp++/json/nlohmann_json_sax.h>
+
 namespace cppxx::serde {
     template <typename T>
     struct Serialize<nlohmann::json, T, std::enable_if_t<std::is_convertible_v<T, nlohmann::json>>> {
@@ -262,14 +392,21 @@ namespace cppxx::serde {
         std::void_t<decltype(std::declval<const nlohmann::json &>().get_to(std::declval<T &>()))>> {
         const nlohmann::json &j;
 
-        void into(T &v) const {
+        /// `nlohmann::json` converts by throwing, so its errors are caught here, and returned when `err` is not null
+        bool into(T &v, error *err = nullptr) const {
             try {
                 j.get_to(v);
+                return true;
             } catch (nlohmann::json::type_error &e) {
                 auto [expected, got] = extract_types(e.what());
-                throw type_mismatch_error(expected, got);
+                return detail::fail(err, type_mismatch_error(expected, got));
             } catch (nlohmann::json::exception &e) {
-                throw error(e.what());
+                return detail::fail(err, error(e.what()));
+            } catch (error &e) {
+                if (!err)
+                    throw;
+                *err = std::move(e);
+                return false;
             }
         }
 
@@ -291,6 +428,7 @@ namespace cppxx::serde {
         }
     };
 
+    /// Decodes straight into the value from the events of `nlohmann::json::sax_parse`, without building a DOM
     template <>
     struct Parse<nlohmann::json, std::string> {
         const std::string &str;
@@ -298,12 +436,36 @@ namespace cppxx::serde {
 
         template <typename T>
         void into(T &val) const {
-            try {
-                auto j = nlohmann::json::parse(str, nullptr, true, ignore_comments);
-                Deserialize<nlohmann::json, T>{j}.into(val);
-            } catch (nlohmann::json::exception &e) {
-                throw error(e.what());
-            }
+            json::nlohmann_json::detail::sax_value<T> root(&val);
+            read(root);
+        }
+
+#ifdef BOOST_PFR_HPP
+        /// Same as `into`, decoding only the fields selected by `p`, the others keep their value
+        template <typename T>
+        void into(T &val, const projection<T> &p) const {
+            json::nlohmann_json::detail::sax_value<T> root(&val);
+            root.selected = p.data();
+            read(root);
+        }
+#endif
+
+        /// Same as `into`, with the errors returned instead of thrown. The sinks of the reader report the errors of
+        /// decoding by return value, so that an invalid document throws nothing.
+        template <typename T>
+        result<void> try_into(T &val) const {
+            json::nlohmann_json::detail::sax_value<T> root(&val);
+            json::nlohmann_json::detail::sax_reader   reader(root);
+            if (!reader.read(str, ignore_comments))
+                return reader.error();
+            return {};
+        }
+
+    protected:
+        void read(json::nlohmann_json::detail::sax_sink &root) const {
+            json::nlohmann_json::detail::sax_reader reader(root);
+            if (!reader.read(str, ignore_comments))
+                throw reader.error();
         }
     };
 
@@ -313,13 +475,21 @@ namespace cppxx::serde {
         bool         ignore_comments = false;
 
         template <typename T>
-        void into(T &val) const {
-            try {
-                auto j = nlohmann::json::parse(std::move(stream), nullptr, true, ignore_comments);
-                Deserialize<nlohmann::json, T>{j}.into(val);
-            } catch (nlohmann::json::exception &e) {
-                throw error(e.what());
-            }
+        void into(T &val) {
+            json::nlohmann_json::detail::sax_value<T> root(&val);
+            json::nlohmann_json::detail::sax_reader   reader(root);
+            if (!reader.read(stream, ignore_comments))
+                throw reader.error();
+        }
+
+        /// Same as `into`, with the errors returned instead of thrown, see `Parse<nlohmann::json, std::string>`
+        template <typename T>
+        result<void> try_into(T &val) {
+            json::nlohmann_json::detail::sax_value<T> root(&val);
+            json::nlohmann_json::detail::sax_reader   reader(root);
+            if (!reader.read(stream, ignore_comments))
+                return reader.error();
+            return {};
         }
     };
 
@@ -330,12 +500,20 @@ namespace cppxx::serde {
 
         template <typename T>
         void into(T &val) const {
-            try {
-                auto j = nlohmann::json::parse(file, nullptr, true, ignore_comments);
-                Deserialize<nlohmann::json, T>{j}.into(val);
-            } catch (nlohmann::json::exception &e) {
-                throw error(e.what());
-            }
+            json::nlohmann_json::detail::sax_value<T> root(&val);
+            json::nlohmann_json::detail::sax_reader   reader(root);
+            if (!reader.read(file, ignore_comments))
+                throw reader.error();
+        }
+
+        /// Same as `into`, with the errors returned instead of thrown, see `Parse<nlohmann::json, std::string>`
+        template <typename T>
+        result<void> try_into(T &val) const {
+            json::nlohmann_json::detail::sax_value<T> root(&val);
+            json::nlohmann_json::detail::sax_reader   reader(root);
+            if (!reader.read(file, ignore_comments))
+                return reader.error();
+            return {};
         }
     };
 
@@ -353,6 +531,12 @@ namespace cppxx::serde {
                 throw error(e.what());
             }
         }
+
+        /// Same as `from`, with the errors caught and returned instead of thrown
+        template <typename T>
+        result<std::string> try_from(const T &val) const {
+            return capture([&]() { return from(val); });
+        }
     };
 } // namespace cppxx::serde
 #endif
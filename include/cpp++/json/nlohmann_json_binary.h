@@ -0,0 +1,708 @@
+#ifndef CPPXX_JSON_NLOHMANN_JSON_BINARY_H
+#define CPPXX_JSON_NLOHMANN_JSON_BINARY_H
+
+#include <cpp++/json/nlohmann_json.h>
+#include <cpp++/serde/serialize.h>
+#include <cpp++/serde/enum.h>
+#include <cpp++/serde/error.h>
+#include <cpp++/time.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#ifndef BOOST_PFR_HPP
+#    if __has_include(<boost/pfr.hpp>)
+#        include <boost/pfr.hpp>
+#    endif
+#endif
+
+#ifndef NEARGYE_MAGIC_ENUM_HPP
+#    if __has_include(<magic_enum/magic_enum.hpp>)
+#        include <magic_enum/magic_enum.hpp>
+#    endif
+#endif
+
+namespace cppxx::json::nlohmann_json {
+    /// Binary encodings of JSON values
+    enum class format {
+        msgpack, ///< MessagePack
+        cbor,    ///< CBOR, RFC 8949
+        bson,    ///< BSON, whose root must be an object
+    };
+
+    /// Writes MessagePack, CBOR or BSON straight into a byte buffer, without building a `nlohmann::json` first.
+    ///
+    /// Numbers and strings take the smallest encoding, as with `nlohmann::json::to_msgpack` and friends, so the output
+    /// is read back by `nlohmann::json::from_msgpack` and friends. Arrays and objects are given their size up front; in
+    /// BSON, the length of a document is patched when it ends.
+    class BinaryWriter {
+    public:
+        BinaryWriter(std::vector<uint8_t> *out, format fmt)
+            : out(out)
+            , fmt(fmt) {}
+
+        void null() {
+            switch (fmt) {
+            case format::msgpack:
+                return put(0xc0);
+            case format::cbor:
+                return put(0xf6);
+            case format::bson:
+                return element(0x0a);
+            }
+        }
+
+        void boolean(bool v) {
+            switch (fmt) {
+            case format::msgpack:
+                return put(v ? 0xc3 : 0xc2);
+            case format::cbor:
+                return put(v ? 0xf5 : 0xf4);
+            case format::bson:
+                element(0x08);
+                return put(v ? 1 : 0);
+            }
+        }
+
+        void sint(int64_t v) {
+            if (v >= 0)
+                return uint(uint64_t(v));
+
+            switch (fmt) {
+            case format::msgpack:
+                if (v >= -32)
+                    return put(uint8_t(int8_t(v)));
+                if (v >= INT8_MIN)
+                    return put(0xd0), put_be(int8_t(v));
+                if (v >= INT16_MIN)
+                    return put(0xd1), put_be(int16_t(v));
+                if (v >= INT32_MIN)
+                    return put(0xd2), put_be(int32_t(v));
+                return put(0xd3), put_be(v);
+            case format::cbor:
+                return cbor_head(0x20, uint64_t(-1 - v));
+            case format::bson:
+                if (v >= INT32_MIN)
+                    return element(0x10), put_le(int32_t(v));
+                return element(0x12), put_le(v);
+            }
+        }
+
+        void uint(uint64_t v) {
+            switch (fmt) {
+            case format::msgpack:
+                if (v < 128)
+                    return put(uint8_t(v));
+                if (v <= UINT8_MAX)
+                    return put(0xcc), put_be(uint8_t(v));
+                if (v <= UINT16_MAX)
+                    return put(0xcd), put_be(uint16_t(v));
+                if (v <= UINT32_MAX)
+                    return put(0xce), put_be(uint32_t(v));
+                return put(0xcf), put_be(v);
+            case format::cbor:
+                return cbor_head(0x00, v);
+            case format::bson:
+                if (v <= uint64_t(INT32_MAX))
+                    return element(0x10), put_le(int32_t(v));
+                if (v <= uint64_t(INT64_MAX))
+                    return element(0x12), put_le(int64_t(v));
+                throw serde::error("integer number " + std::to_string(v) + " cannot be represented by BSON");
+            }
+        }
+
+        void real(double v) {
+            switch (fmt) {
+            case format::msgpack:
+                return compact_float(v, 0xca, 0xcb);
+            case format::cbor:
+                // half precision NaN and infinities, as nlohmann does
+                if (std::isnan(v))
+                    return put(0xf9), put(0x7e), put(0x00);
+                if (std::isinf(v))
+                    return put(0xf9), put(v > 0 ? 0x7c : 0xfc), put(0x00);
+                return compact_float(v, 0xfa, 0xfb);
+            case format::bson:
+                return element(0x01), put_le(v);
+            }
+        }
+
+        void str(std::string_view v) {
+            switch (fmt) {
+            case format::msgpack:
+                if (v.size() <= 31)
+                    put(uint8_t(0xa0 | v.size()));
+                else if (v.size() <= UINT8_MAX)
+                    put(0xd9), put_be(uint8_t(v.size()));
+                else if (v.size() <= UINT16_MAX)
+                    put(0xda), put_be(uint16_t(v.size()));
+                else
+                    put(0xdb), put_be(uint32_t(v.size()));
+                break;
+            case format::cbor:
+                cbor_head(0x60, v.size());
+                break;
+            case format::bson:
+                element(0x02);
+                put_le(int32_t(v.size() + 1));
+                put(v);
+                return put(0x00);
+            }
+            put(v);
+        }
+
+        /// Starts an array of `n` elements
+        void arr_begin(size_t n) {
+            switch (fmt) {
+            case format::msgpack:
+                if (n <= 15)
+                    return put(uint8_t(0x90 | n));
+                if (n <= UINT16_MAX)
+                    return put(0xdc), put_be(uint16_t(n));
+                return put(0xdd), put_be(uint32_t(n));
+            case format::cbor:
+                return cbor_head(0x80, n);
+            case format::bson:
+                if (levels.empty())
+                    throw serde::error("BSON root must be an object, not an array");
+                element(0x04);
+                return bson_begin(false);
+            }
+        }
+
+        void arr_end() {
+            if (fmt == format::bson)
+                bson_end();
+        }
+
+        /// Starts an object of `n` members
+        void obj_begin(size_t n) {
+            switch (fmt) {
+            case format::msgpack:
+                if (n <= 15)
+                    return put(uint8_t(0x80 | n));
+                if (n <= UINT16_MAX)
+                    return put(0xde), put_be(uint16_t(n));
+                return put(0xdf), put_be(uint32_t(n));
+            case format::cbor:
+                return cbor_head(0xa0, n);
+            case format::bson:
+                if (!levels.empty())
+                    element(0x03);
+                return bson_begin(true);
+            }
+        }
+
+        void key(std::string_view k) {
+            if (fmt == format::bson)
+                pending_key = k;
+            else
+                str(k);
+        }
+
+        void obj_end() {
+            if (fmt == format::bson)
+                bson_end();
+        }
+
+        /// Writes a DOM value, used for `noserde` fields
+        void value(const nlohmann::json &j) {
+            switch (j.type()) {
+            case nlohmann::json::value_t::null:
+                return null();
+            case nlohmann::json::value_t::boolean:
+                return boolean(j.get<bool>());
+            case nlohmann::json::value_t::number_integer:
+                return sint(j.get<int64_t>());
+            case nlohmann::json::value_t::number_unsigned:
+                return uint(j.get<uint64_t>());
+            case nlohmann::json::value_t::number_float:
+                return real(j.get<double>());
+            case nlohmann::json::value_t::string:
+                return str(j.get_ref<const std::string &>());
+            case nlohmann::json::value_t::array:
+                arr_begin(j.size());
+                for (const auto &item : j)
+                    value(item);
+                return arr_end();
+            case nlohmann::json::value_t::object:
+                obj_begin(j.size());
+                for (auto it = j.begin(); it != j.end(); ++it) {
+                    key(it.key());
+                    value(it.value());
+                }
+                return obj_end();
+            default:
+                throw serde::error(std::string("cannot write a value of type ") + j.type_name());
+            }
+        }
+
+        /// Parses `v` as JSON and writes it, used for `noserde` fields
+        void raw(std::string_view v) {
+            try {
+                value(nlohmann::json::parse(v));
+            } catch (nlohmann::json::exception &e) {
+                throw serde::error(e.what());
+            }
+        }
+
+    protected:
+        struct bson_level {
+            size_t start;  // offset of the length of the document
+            size_t index;  // next index, for arrays
+            bool   is_obj;
+        };
+
+        std::vector<uint8_t>   *out;
+        format                  fmt;
+        std::vector<bson_level> levels;
+        std::string_view        pending_key;
+
+        void put(uint8_t c) {
+            out->push_back(c);
+        }
+
+        void put(std::string_view s) {
+            out->insert(out->end(), s.begin(), s.end());
+        }
+
+        template <typename N>
+        void put_be(N v) {
+            uint8_t buf[sizeof(N)];
+            std::memcpy(buf, &v, sizeof(N));
+            for (size_t i = sizeof(N); i > 0; --i)
+                put(buf[i - 1]);
+        }
+
+        template <typename N>
+        void put_le(N v) {
+            uint8_t buf[sizeof(N)];
+            std::memcpy(buf, &v, sizeof(N));
+            out->insert(out->end(), buf, buf + sizeof(N));
+        }
+
+        // major type and argument of a CBOR item
+        void cbor_head(uint8_t major, uint64_t n) {
+            if (n <= 0x17)
+                return put(uint8_t(major | n));
+            if (n <= UINT8_MAX)
+                return put(major | 0x18), put_be(uint8_t(n));
+            if (n <= UINT16_MAX)
+                return put(major | 0x19), put_be(uint16_t(n));
+            if (n <= UINT32_MAX)
+                return put(major | 0x1a), put_be(uint32_t(n));
+            return put(major | 0x1b), put_be(n);
+        }
+
+        // single precision when it loses nothing
+        void compact_float(double v, uint8_t single, uint8_t dbl) {
+            if (v >= double(std::numeric_limits<float>::lowest()) && v <= double(std::numeric_limits<float>::max()) &&
+                double(float(v)) == v)
+                return put(single), put_be(float(v));
+            put(dbl), put_be(v);
+        }
+
+        // type and name of a BSON element, the name being the pending key or the index in an array
+        void element(uint8_t type) {
+            if (levels.empty())
+                throw serde::error("BSON root must be an object");
+
+            put(type);
+            bson_level &l = levels.back();
+            if (l.is_obj) {
+                if (pending_key.find('\0') != std::string_view::npos)
+                    throw serde::error("BSON key cannot contain a null character");
+                put(pending_key);
+            } else
+                put(std::to_string(l.index++));
+            put(0x00);
+        }
+
+        void bson_begin(bool is_obj) {
+            levels.push_back({out->size(), 0, is_obj});
+            put_le(int32_t(0));
+        }
+
+        void bson_end() {
+            put(0x00);
+            const size_t  start = levels.back().start;
+            const int32_t len   = int32_t(out->size() - start);
+            std::memcpy(out->data() + start, &len, sizeof(len));
+            levels.pop_back();
+        }
+    };
+} // namespace cppxx::json::nlohmann_json
+
+
+namespace cppxx::serde {
+    // bool
+    template <>
+    struct Serialize<json::nlohmann_json::BinaryWriter, bool> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(bool v) const {
+            w.boolean(v);
+        }
+    };
+
+    // sint
+    template <typename T>
+    struct Serialize<
+        json::nlohmann_json::BinaryWriter,
+        T,
+        std::enable_if_t<std::is_signed_v<T> && !std::is_same_v<T, bool> && !std::is_floating_point_v<T>>> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(T v) const {
+            w.sint(v);
+        }
+    };
+
+    // uint
+    template <typename T>
+    struct Serialize<json::nlohmann_json::BinaryWriter, T, std::enable_if_t<std::is_unsigned_v<T> && !std::is_same_v<T, bool>>> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(T v) const {
+            w.uint(v);
+        }
+    };
+
+    // real
+    template <typename T>
+    struct Serialize<json::nlohmann_json::BinaryWriter, T, std::enable_if_t<std::is_floating_point_v<T>>> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(T v) const {
+            w.real(v);
+        }
+    };
+
+    // string
+    template <typename CT>
+    struct Serialize<json::nlohmann_json::BinaryWriter, std::basic_string_view<char, CT>> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(std::basic_string_view<char, CT> v) const {
+            w.str({v.data(), v.size()});
+        }
+    };
+
+    template <typename CT, typename A>
+    struct Serialize<json::nlohmann_json::BinaryWriter, std::basic_string<char, CT, A>> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(const std::basic_string<char, CT, A> &v) const {
+            w.str({v.data(), v.size()});
+        }
+
+        void from_raw(const std::basic_string<char, CT, A> &v) const {
+            w.raw({v.data(), v.size()});
+        }
+    };
+
+    // optional
+    template <typename T>
+    struct Serialize<json::nlohmann_json::BinaryWriter, std::optional<T>> {
+        json::nlohmann_json::BinaryWriter &w;
+        bool                               as_int = false; ///< from the `int` option of the field, for an optional enum
+
+        void from(const std::optional<T> &v) const {
+            if (!v.has_value())
+                return w.null();
+            if constexpr (detail::is_named_enum_v<T>)
+                Serialize<json::nlohmann_json::BinaryWriter, T>{w, as_int}.from(*v);
+            else
+                Serialize<json::nlohmann_json::BinaryWriter, T>{w}.from(*v);
+        }
+    };
+
+    // array
+    template <typename T, size_t N>
+    struct Serialize<json::nlohmann_json::BinaryWriter, std::array<T, N>> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(const std::array<T, N> &v) const {
+            w.arr_begin(N);
+            for (size_t i = 0; i < N; ++i)
+                try {
+                    Serialize<json::nlohmann_json::BinaryWriter, T>{w}.from(v[i]);
+                } catch (error &e) {
+                    e.add_context(i);
+                    throw;
+                }
+            w.arr_end();
+        }
+    };
+
+    // vector
+    template <typename T, typename A>
+    struct Serialize<json::nlohmann_json::BinaryWriter, std::vector<T, A>> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(const std::vector<T, A> &v) const {
+            w.arr_begin(v.size());
+            for (size_t i = 0; i < v.size(); ++i)
+                try {
+                    Serialize<json::nlohmann_json::BinaryWriter, T>{w}.from(v[i]);
+                } catch (error &e) {
+                    e.add_context(i);
+                    throw;
+                }
+            w.arr_end();
+        }
+    };
+
+    // tuple
+    template <typename... Ts>
+    struct Serialize<json::nlohmann_json::BinaryWriter, std::tuple<Ts...>> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(const std::tuple<Ts...> &tpl) const {
+            cppxx::json::with_tag_info_tuple(tpl, [&](const TagInfoTuple<sizeof...(Ts)> &ti) {
+                const std::array<TagInfo, sizeof...(Ts)> &ts     = ti.ts;
+                const bool                                is_obj = ti.is_obj;
+
+                auto written = [&](const auto &item, auto i) {
+                    const TagInfo     &t = ts[i];
+                    const auto        &v = detail::get_underlying_value(item);
+                    using T              = std::decay_t<decltype(v)>;
+                    constexpr TagFlags f = tag_flags_v<cppxx::json::TagKey, std::tuple<Ts...>, i>;
+
+                    if constexpr (!is_serializable_v<json::nlohmann_json::BinaryWriter, T>)
+                        return false;
+                    else {
+                        if constexpr (f.unkeyed)
+                            if (is_obj && t.key == "")
+                                return false;
+                        if constexpr (f.omitempty)
+                            if (t.omitempty && detail::is_empty_value(v))
+                                return false;
+                        return true;
+                    }
+                };
+
+                // the size comes first
+                size_t n = 0;
+                tuple_for_each(tpl, [&](const auto &item, auto i) { n += written(item, i); });
+
+                is_obj ? w.obj_begin(n) : w.arr_begin(n);
+                tuple_for_each(tpl, [&](const auto &item, auto i) {
+                    const TagInfo     &t = ts[i];
+                    const auto        &v = detail::get_underlying_value(item);
+                    using T              = std::decay_t<decltype(v)>;
+                    constexpr TagFlags f = tag_flags_v<cppxx::json::TagKey, std::tuple<Ts...>, i>;
+
+                    if constexpr (is_serializable_v<json::nlohmann_json::BinaryWriter, T>) {
+                        if (!written(item, i))
+                            return;
+
+                        auto encode = [&] {
+                            if constexpr (f.noserde)
+                                if (t.noserde) {
+                                    if constexpr (std::is_same_v<T, std::string>)
+                                        Serialize<json::nlohmann_json::BinaryWriter, std::string>{w}.from_raw(v);
+                                    else
+                                        throw error("field with tag `noserde` can only be serialized from std::string");
+                                    return;
+                                }
+                            detail::check_as_int<T, f.is_static, f.as_int>(t.as_int);
+                            if constexpr (detail::takes_as_int_v<T> && f.as_int)
+                                Serialize<json::nlohmann_json::BinaryWriter, T>{w, t.as_int}.from(v);
+                            else
+                                Serialize<json::nlohmann_json::BinaryWriter, T>{w}.from(v);
+                        };
+
+                        if (is_obj)
+                            w.key(t.key);
+                        try {
+                            encode();
+                        } catch (error &e) {
+                            if (is_obj)
+                                e.add_context(t.key);
+                            else
+                                e.add_context(i);
+                            throw;
+                        }
+                    }
+                });
+                is_obj ? w.obj_end() : w.arr_end();
+            });
+        }
+    };
+
+    // variant
+    template <typename... T>
+    struct Serialize<json::nlohmann_json::BinaryWriter, std::variant<T...>> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(const std::variant<T...> &v) const {
+            std::visit(
+                [&](const auto &var) {
+                    Serialize<json::nlohmann_json::BinaryWriter, std::decay_t<decltype(var)>>{w}.from(var);
+                },
+                v
+            );
+        }
+    };
+
+    // map
+    template <typename CT, typename CA, typename T, typename H, typename P, typename A>
+    struct Serialize<json::nlohmann_json::BinaryWriter, std::unordered_map<std::basic_string<char, CT, CA>, T, H, P, A>> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(const std::unordered_map<std::basic_string<char, CT, CA>, T, H, P, A> &v) const {
+            w.obj_begin(v.size());
+            for (auto &[k, item] : v) {
+                w.key({k.data(), k.size()});
+                try {
+                    Serialize<json::nlohmann_json::BinaryWriter, T>{w}.from(item);
+                } catch (error &e) {
+                    throw e.add_context(k);
+                }
+            }
+            w.obj_end();
+        }
+    };
+
+    // std::tm
+    template <>
+    struct Serialize<json::nlohmann_json::BinaryWriter, std::tm> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(const std::tm &tm) const {
+            w.str(tm_to_string(tm));
+        }
+    };
+
+#ifdef BOOST_PFR_HPP
+    // aggregate struct
+    template <typename S>
+    struct Serialize<
+        json::nlohmann_json::BinaryWriter,
+        S,
+        std::enable_if_t<std::is_aggregate_v<S> && !std::is_same_v<S, std::tm> && !json::nlohmann_json::detail::is_std_array<S>::value>> {
+        json::nlohmann_json::BinaryWriter &w;
+
+        void from(const S &v) const {
+            auto tpl = boost::pfr::structure_tie(v);
+            Serialize<json::nlohmann_json::BinaryWriter, decltype(tpl)>{w}.from(tpl);
+        }
+    };
+#endif
+
+#ifdef NEARGYE_MAGIC_ENUM_HPP
+    // enum
+    template <typename S>
+    struct Serialize<json::nlohmann_json::BinaryWriter, S, std::enable_if_t<std::is_enum_v<S>>> {
+        json::nlohmann_json::BinaryWriter &w;
+        bool                               as_int = false; ///< from the `int` option of the field
+
+        void from(const S &v) const {
+            if (as_int)
+                return Serialize<json::nlohmann_json::BinaryWriter, std::underlying_type_t<S>>{w}.from(
+                    std::underlying_type_t<S>(v)
+                );
+            w.str(magic_enum::enum_name(v));
+        }
+    };
+#endif
+} // namespace cppxx::serde
+
+
+namespace cppxx::json::nlohmann_json {
+    /// Encodes `val` in the binary format `fmt`, straight from the value
+    template <typename T>
+    [[nodiscard]]
+    std::vector<uint8_t> dump_binary(const T &val, format fmt) {
+        std::vector<uint8_t> res;
+        BinaryWriter         w(&res, fmt);
+        cppxx::serde::Serialize<BinaryWriter, T>{w}.from(val);
+        return res;
+    }
+
+    /// Decodes `src`, in the binary format `fmt`, straight into `val`
+    template <typename T>
+    void parse_binary(const std::vector<uint8_t> &src, T &val, format fmt) {
+        static constexpr nlohmann::json::input_format_t formats[] = {
+            nlohmann::json::input_format_t::msgpack,
+            nlohmann::json::input_format_t::cbor,
+            nlohmann::json::input_format_t::bson,
+        };
+
+        detail::sax_value<T> root(&val);
+        detail::sax_reader   reader(root);
+        if (!reader.read(src, false, formats[size_t(fmt)]))
+            throw reader.error();
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, T> parse_binary(const std::vector<uint8_t> &src, format fmt) {
+        T val = {};
+        parse_binary(src, val, fmt);
+        return val;
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    std::vector<uint8_t> dump_msgpack(const T &val) {
+        return dump_binary(val, format::msgpack);
+    }
+
+    template <typename T>
+    void parse_msgpack(const std::vector<uint8_t> &src, T &val) {
+        parse_binary(src, val, format::msgpack);
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, T> parse_msgpack(const std::vector<uint8_t> &src) {
+        return parse_binary<T>(src, format::msgpack);
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    std::vector<uint8_t> dump_cbor(const T &val) {
+        return dump_binary(val, format::cbor);
+    }
+
+    template <typename T>
+    void parse_cbor(const std::vector<uint8_t> &src, T &val) {
+        parse_binary(src, val, format::cbor);
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, T> parse_cbor(const std::vector<uint8_t> &src) {
+        return parse_binary<T>(src, format::cbor);
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    std::vector<uint8_t> dump_bson(const T &val) {
+        return dump_binary(val, format::bson);
+    }
+
+    template <typename T>
+    void parse_bson(const std::vector<uint8_t> &src, T &val) {
+        parse_binary(src, val, format::bson);
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, T> parse_bson(const std::vector<uint8_t> &src) {
+        return parse_binary<T>(src, format::bson);
+    }
+} // namespace cppxx::json::nlohmann_json
+
+#endif
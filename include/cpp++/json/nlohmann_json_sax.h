@@ -0,0 +1,1080 @@
+#ifndef CPPXX_JSON_NLOHMANN_JSON_SAX_H
+#define CPPXX_JSON_NLOHMANN_JSON_SAX_H
+
+#include <cpp++/json/json.h>
+#include <cpp++/serde/deserialize.h>
+#include <cpp++/serde/enum.h>
+#include <cpp++/serde/error.h>
+#include <cpp++/serde/variant.h>
+#include <cpp++/time.h>
+#include <cpp++/tuple.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef INCLUDE_NLOHMANN_JSON_HPP_
+#    include <nlohmann/json.hpp>
+#endif
+
+#ifndef BOOST_PFR_HPP
+#    if __has_include(<boost/pfr.hpp>)
+#        include <boost/pfr.hpp>
+#    endif
+#endif
+
+namespace cppxx::json::nlohmann_json::detail {
+    class sax_frame;
+
+    /// Receives one JSON value into its target.
+    ///
+    /// Each event returns false with the error in `err` when the target cannot take it, a type mismatch with the type
+    /// names of `nlohmann::json` by default, so that an invalid document is reported without throwing. A target that has
+    /// no direct support sets no frame for objects and arrays: the value is then built as a DOM, and given to `dom`.
+    class sax_sink {
+    public:
+        virtual ~sax_sink() = default;
+
+        virtual bool null(serde::error &err) {
+            return mismatch("null", err);
+        }
+
+        virtual bool boolean(bool, serde::error &err) {
+            return mismatch("boolean", err);
+        }
+
+        virtual bool sint(int64_t, serde::error &err) {
+            return mismatch("number", err);
+        }
+
+        virtual bool uint(uint64_t, serde::error &err) {
+            return mismatch("number", err);
+        }
+
+        virtual bool real(double, serde::error &err) {
+            return mismatch("number", err);
+        }
+
+        virtual bool string(std::string &, serde::error &err) {
+            return mismatch("string", err);
+        }
+
+        /// Sets `frame` to the frame receiving the members of an object, or to null to receive the object in `dom`. The
+        /// frame belongs to the sink, which sets it up again for each object it receives.
+        virtual bool object(sax_frame *&, serde::error &err) {
+            return mismatch("object", err);
+        }
+
+        /// Sets `frame` to the frame receiving the elements of an array, or to null to receive the array in `dom`
+        virtual bool array(sax_frame *&, serde::error &err) {
+            return mismatch("array", err);
+        }
+
+        virtual bool dom(const nlohmann::json &j, serde::error &err) {
+            return mismatch(j.type_name(), err);
+        }
+
+    protected:
+        virtual std::string expected() const = 0;
+
+        bool mismatch(const char *got, serde::error &err) const {
+            err = serde::type_mismatch_error(expected(), got);
+            return false;
+        }
+    };
+
+    /// Receives the members of an object or the elements of an array
+    class sax_frame {
+    public:
+        virtual ~sax_frame() = default;
+
+        /// Sets `sink` to the sink of the value of `key`, or to null to skip it
+        virtual bool key(std::string &, sax_sink *&sink, serde::error &) {
+            sink = nullptr;
+            return true;
+        }
+
+        /// Sets `sink` to the sink of the next element, or to null to skip it
+        virtual bool element(sax_sink *&sink, serde::error &) {
+            sink = nullptr;
+            return true;
+        }
+
+        virtual bool end(serde::error &) {
+            return true;
+        }
+
+        /// Adds the member or the element being decoded to the context of `e`
+        virtual void add_context(serde::error &) const {}
+    };
+
+    /// Gives `j` to `sink` as the events it would have been parsed from, for the values received as a DOM, e.g. the
+    /// alternatives of a variant. The strings are copied since a sink may take them over.
+    inline bool sax_replay(const nlohmann::json &j, sax_sink &sink, serde::error &err) {
+        switch (j.type()) {
+            case nlohmann::json::value_t::null:
+                return sink.null(err);
+            case nlohmann::json::value_t::boolean:
+                return sink.boolean(j.get<bool>(), err);
+            case nlohmann::json::value_t::number_integer:
+                return sink.sint(j.get<int64_t>(), err);
+            case nlohmann::json::value_t::number_unsigned:
+                return sink.uint(j.get<uint64_t>(), err);
+            case nlohmann::json::value_t::number_float:
+                return sink.real(j.get<double>(), err);
+            case nlohmann::json::value_t::string: {
+                std::string s = j.get_ref<const std::string &>();
+                return sink.string(s, err);
+            }
+            case nlohmann::json::value_t::object:
+            case nlohmann::json::value_t::array:
+                break;
+            default:
+                return sink.dom(j, err);
+        }
+
+        sax_frame *frame = nullptr;
+        if (!(j.is_object() ? sink.object(frame, err) : sink.array(frame, err)))
+            return false;
+        if (!frame)
+            return sink.dom(j, err);
+
+        for (auto it = j.begin(); it != j.end(); ++it) {
+            sax_sink *item = nullptr;
+            if (j.is_object()) {
+                std::string key = it.key();
+                if (!frame->key(key, item, err))
+                    return false;
+            } else if (!frame->element(item, err))
+                return false;
+            if (item && !sax_replay(*it, *item, err)) {
+                frame->add_context(err);
+                return false;
+            }
+        }
+        if (!frame->end(err)) {
+            frame->add_context(err);
+            return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    class sax_target : public sax_sink {
+    public:
+        T                    *v = nullptr;
+        const serde::TagInfo *t = nullptr; ///< options of the field, null when not a field
+
+        sax_target() = default;
+
+        explicit sax_target(T *v, const serde::TagInfo *t = nullptr)
+            : v(v)
+            , t(t) {}
+    };
+
+    /// Target built as a DOM and converted by its `adl_serializer`
+    template <typename T>
+    class sax_dom_target : public sax_target<T> {
+    public:
+        using sax_target<T>::sax_target;
+
+        bool null(serde::error &err) override {
+            return put(nullptr, err);
+        }
+
+        bool boolean(bool b, serde::error &err) override {
+            return put(b, err);
+        }
+
+        bool sint(int64_t n, serde::error &err) override {
+            return put(n, err);
+        }
+
+        bool uint(uint64_t n, serde::error &err) override {
+            return put(n, err);
+        }
+
+        bool real(double n, serde::error &err) override {
+            return put(n, err);
+        }
+
+        bool string(std::string &s, serde::error &err) override {
+            return put(std::move(s), err);
+        }
+
+        bool object(sax_frame *&frame, serde::error &) override {
+            frame = nullptr;
+            return true;
+        }
+
+        bool array(sax_frame *&frame, serde::error &) override {
+            frame = nullptr;
+            return true;
+        }
+
+    protected:
+        template <typename V>
+        bool put(V &&value, serde::error &err) {
+            nlohmann::json j = std::forward<V>(value);
+            return this->dom(j, err);
+        }
+
+        std::string expected() const override {
+            return "value";
+        }
+    };
+
+    /// Types without direct support, e.g. user `adl_serializer`s, converted by `nlohmann::json`, which reports its errors
+    /// by throwing
+    template <typename T, typename = void>
+    class sax_value : public sax_dom_target<T> {
+    public:
+        using sax_dom_target<T>::sax_dom_target;
+
+        bool dom(const nlohmann::json &j, serde::error &err) override {
+            if constexpr (serde::is_deserializable_v<nlohmann::json, T>)
+                return serde::Deserialize<nlohmann::json, T>{j}.into(*this->v, &err);
+            else {
+                err = serde::error("type is not deserializable");
+                return false;
+            }
+        }
+    };
+
+    /// `noserde` field, the value is kept as JSON text
+    class sax_raw : public sax_dom_target<std::string> {
+    public:
+        using sax_dom_target<std::string>::sax_dom_target;
+
+        bool dom(const nlohmann::json &j, serde::error &) override {
+            *v = j.dump();
+            return true;
+        }
+    };
+
+    template <>
+    class sax_value<bool> : public sax_target<bool> {
+    public:
+        using sax_target<bool>::sax_target;
+
+        bool boolean(bool b, serde::error &) override {
+            *v = b;
+            return true;
+        }
+
+    protected:
+        std::string expected() const override {
+            return "boolean";
+        }
+    };
+
+    // numbers are converted as by `nlohmann::json::get`
+    template <typename T>
+    class sax_value<T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>> : public sax_target<T> {
+    public:
+        using sax_target<T>::sax_target;
+
+        bool boolean(bool b, serde::error &) override {
+            *this->v = static_cast<T>(b);
+            return true;
+        }
+
+        bool sint(int64_t n, serde::error &) override {
+            *this->v = static_cast<T>(n);
+            return true;
+        }
+
+        bool uint(uint64_t n, serde::error &) override {
+            *this->v = static_cast<T>(n);
+            return true;
+        }
+
+        bool real(double n, serde::error &) override {
+            *this->v = static_cast<T>(n);
+            return true;
+        }
+
+    protected:
+        std::string expected() const override {
+            return "number";
+        }
+    };
+
+    template <typename CT, typename A>
+    class sax_value<std::basic_string<char, CT, A>> : public sax_target<std::basic_string<char, CT, A>> {
+    public:
+        using sax_target<std::basic_string<char, CT, A>>::sax_target;
+
+        bool string(std::string &s, serde::error &) override {
+            this->v->assign(s.data(), s.size());
+            return true;
+        }
+
+    protected:
+        std::string expected() const override {
+            return "string";
+        }
+    };
+
+    template <>
+    class sax_value<std::tm> : public sax_target<std::tm> {
+    public:
+        using sax_target<std::tm>::sax_target;
+
+        bool string(std::string &s, serde::error &err) override {
+            if (tm_from_string(std::string_view(s), *v))
+                return true;
+            err = serde::error("Invalid datetime format: " + s);
+            return false;
+        }
+
+    protected:
+        std::string expected() const override {
+            return "string";
+        }
+    };
+
+#ifdef NEARGYE_MAGIC_ENUM_HPP
+    template <typename T>
+    class sax_value<T, std::enable_if_t<serde::detail::is_named_enum_v<T>>> : public sax_target<T> {
+    public:
+        using sax_target<T>::sax_target;
+
+        bool sint(int64_t n, serde::error &err) override {
+            if (!as_int())
+                return sax_target<T>::sint(n, err);
+            return serde::detail::enum_from_int<T>(static_cast<std::underlying_type_t<T>>(n), *this->v, &err);
+        }
+
+        bool uint(uint64_t n, serde::error &err) override {
+            if (!as_int())
+                return sax_target<T>::uint(n, err);
+            return serde::detail::enum_from_int<T>(static_cast<std::underlying_type_t<T>>(n), *this->v, &err);
+        }
+
+        bool string(std::string &s, serde::error &err) override {
+            if (as_int())
+                return sax_target<T>::string(s, err);
+            return serde::detail::enum_from_name<T>(s, *this->v, &err);
+        }
+
+    protected:
+        bool as_int() const {
+            return this->t && this->t->as_int;
+        }
+
+        std::string expected() const override {
+            return as_int() ? "number" : "string";
+        }
+    };
+#endif
+
+    template <typename T>
+    class sax_value<std::optional<T>> : public sax_target<std::optional<T>> {
+    public:
+        using sax_target<std::optional<T>>::sax_target;
+
+        bool null(serde::error &) override {
+            this->v->reset();
+            return true;
+        }
+
+        bool boolean(bool b, serde::error &err) override {
+            return inner().boolean(b, err);
+        }
+
+        bool sint(int64_t n, serde::error &err) override {
+            return inner().sint(n, err);
+        }
+
+        bool uint(uint64_t n, serde::error &err) override {
+            return inner().uint(n, err);
+        }
+
+        bool real(double n, serde::error &err) override {
+            return inner().real(n, err);
+        }
+
+        bool string(std::string &s, serde::error &err) override {
+            return inner().string(s, err);
+        }
+
+        bool object(sax_frame *&frame, serde::error &err) override {
+            return inner().object(frame, err);
+        }
+
+        bool array(sax_frame *&frame, serde::error &err) override {
+            return inner().array(frame, err);
+        }
+
+        bool dom(const nlohmann::json &j, serde::error &err) override {
+            if (j.is_null()) {
+                this->v->reset();
+                return true;
+            }
+            return inner().dom(j, err);
+        }
+
+    protected:
+        sax_value<T> item;
+
+        // decoded over the value already there, if any, with the options of the field
+        sax_value<T> &inner() {
+            if (!this->v->has_value())
+                this->v->emplace();
+            item.v = &**this->v;
+            item.t = this->t;
+            return item;
+        }
+
+        std::string expected() const override {
+            return "optional";
+        }
+    };
+
+    /// Elements decoded over the ones already in the vector, which is then truncated
+    template <typename T, typename A>
+    class sax_vector_frame : public sax_frame {
+    public:
+        void reset(std::vector<T, A> &v) {
+            this->v = &v;
+            n       = 0;
+        }
+
+        bool element(sax_sink *&sink, serde::error &) override {
+            if (n == v->size())
+                v->emplace_back();
+            item.v = &(*v)[n++];
+            sink   = &item;
+            return true;
+        }
+
+        bool end(serde::error &) override {
+            v->erase(v->begin() + n, v->end());
+            return true;
+        }
+
+        void add_context(serde::error &e) const override {
+            if (n > 0)
+                e.add_context(n - 1);
+        }
+
+    protected:
+        std::vector<T, A> *v = nullptr;
+        sax_value<T>       item;
+        size_t             n = 0;
+    };
+
+    template <typename T, typename A>
+    class sax_value<std::vector<T, A>, std::enable_if_t<!std::is_same_v<T, bool> && std::is_default_constructible_v<T>>>
+        : public sax_target<std::vector<T, A>> {
+    public:
+        using sax_target<std::vector<T, A>>::sax_target;
+
+        bool array(sax_frame *&res, serde::error &) override {
+            if (!frame)
+                frame = std::make_unique<sax_vector_frame<T, A>>();
+            frame->reset(*this->v);
+            res = frame.get();
+            return true;
+        }
+
+    protected:
+        // allocated for the first array, reused for the next ones
+        std::unique_ptr<sax_vector_frame<T, A>> frame;
+
+        std::string expected() const override {
+            return "array";
+        }
+    };
+
+    /// Elements decoded over the ones of the array, those past its size being skipped as by its `adl_serializer`
+    template <typename T, size_t N>
+    class sax_array_frame : public sax_frame {
+    public:
+        void reset(std::array<T, N> &v) {
+            this->v = &v;
+            n       = 0;
+        }
+
+        bool element(sax_sink *&sink, serde::error &) override {
+            sink = nullptr;
+            if (n < N) {
+                item.v = &(*v)[n];
+                sink   = &item;
+            }
+            ++n;
+            return true;
+        }
+
+        bool end(serde::error &err) override {
+            if (n >= N)
+                return true;
+            // the context being the first missing element
+            err = serde::error("array index " + std::to_string(n++) + " is out of range");
+            return false;
+        }
+
+        void add_context(serde::error &e) const override {
+            if (n > 0 && n <= N)
+                e.add_context(n - 1);
+        }
+
+    protected:
+        std::array<T, N> *v = nullptr;
+        sax_value<T>      item;
+        size_t            n = 0;
+    };
+
+    template <typename T, size_t N>
+    class sax_value<std::array<T, N>> : public sax_target<std::array<T, N>> {
+    public:
+        using sax_target<std::array<T, N>>::sax_target;
+
+        bool array(sax_frame *&res, serde::error &) override {
+            if (!frame)
+                frame = std::make_unique<sax_array_frame<T, N>>();
+            frame->reset(*this->v);
+            res = frame.get();
+            return true;
+        }
+
+    protected:
+        // allocated for the first array, reused for the next ones
+        std::unique_ptr<sax_array_frame<T, N>> frame;
+
+        std::string expected() const override {
+            return "array";
+        }
+    };
+
+    /// Entries decoded over the ones already in the map, in place; the entries whose key was not found are erased at
+    /// the end of the object
+    template <typename T, typename H, typename P, typename A>
+    class sax_map_frame : public sax_frame {
+    public:
+        using map_type = std::unordered_map<std::string, T, H, P, A>;
+
+        void reset(map_type &v) {
+            this->v = &v;
+            current = nullptr;
+            found.clear();
+            found.reserve(v.size());
+        }
+
+        bool key(std::string &k, sax_sink *&sink, serde::error &) override {
+            auto it = v->try_emplace(k).first;
+            current = &it->first;
+            item.v  = &it->second;
+            found.push_back(current);
+            sink = &item;
+            return true;
+        }
+
+        bool end(serde::error &) override {
+            // keys are found again when duplicated, and live in their nodes, so they are told apart by address
+            std::sort(found.begin(), found.end(), std::less<const std::string *>());
+            found.erase(std::unique(found.begin(), found.end()), found.end());
+            if (found.size() == v->size())
+                return true;
+
+            for (auto it = v->begin(); it != v->end();)
+                it = std::binary_search(found.begin(), found.end(), &it->first, std::less<const std::string *>())
+                         ? std::next(it)
+                         : v->erase(it);
+            return true;
+        }
+
+        void add_context(serde::error &e) const override {
+            if (current)
+                e.add_context(*current);
+        }
+
+    protected:
+        map_type                        *v = nullptr;
+        sax_value<T>                     item;
+        const std::string               *current = nullptr;
+        std::vector<const std::string *> found;
+    };
+
+    template <typename T, typename H, typename P, typename A>
+    class sax_value<std::unordered_map<std::string, T, H, P, A>, std::enable_if_t<std::is_default_constructible_v<T>>>
+        : public sax_target<std::unordered_map<std::string, T, H, P, A>> {
+    public:
+        using sax_target<std::unordered_map<std::string, T, H, P, A>>::sax_target;
+
+        bool object(sax_frame *&res, serde::error &) override {
+            if (!frame)
+                frame = std::make_unique<sax_map_frame<T, H, P, A>>();
+            frame->reset(*this->v);
+            res = frame.get();
+            return true;
+        }
+
+    protected:
+        // allocated for the first object, reused for the next ones
+        std::unique_ptr<sax_map_frame<T, H, P, A>> frame;
+
+        std::string expected() const override {
+            return "object";
+        }
+    };
+
+    template <typename T>
+    using sax_field_t = std::decay_t<decltype(serde::detail::get_underlying_value(std::declval<T &>()))>;
+
+    /// Fields of a tagged tuple, dispatched by key through its key map, or by position for arrays. `Tuple` is the type of
+    /// the tuple, the frame is set up with `reset` before each object or array.
+    template <typename Tuple>
+    class sax_tuple_frame : public sax_frame {
+    public:
+        static constexpr size_t N    = std::tuple_size_v<Tuple>;
+        static constexpr size_t npos = N;
+
+        /// Decodes into the fields of `tpl` next. Without static tags, the tag infos and the key map are only built
+        /// again when a field has another tag than the previous time.
+        template <typename Tpl>
+        void reset(Tpl &&tpl, const bool *selected) {
+            if constexpr (serde::has_static_tags_v<Tuple>) {
+                ti = &serde::static_tag_info_tuple_v<TagKey, Tuple>;
+                km = &serde::static_key_map_v<TagKey, Tuple>;
+            } else {
+                bool same = ti != nullptr;
+                tuple_for_each(tpl, [&](const auto &item, auto i) {
+                    const char *tag = tag_of(item);
+                    same &= std::exchange(tags[i], tag) == tag;
+                });
+                if (!same) {
+                    own_ti = json::get_tag_info_from_tuple(tpl);
+                    own_km = serde::KeyMap<N>(own_ti);
+                    ti     = &own_ti;
+                    km     = &own_km;
+                }
+            }
+
+            tuple_for_each(tpl, [&](auto &item, auto i) {
+                std::get<i>(sinks).v = &serde::detail::get_underlying_value(item);
+                std::get<i>(sinks).t = &ti->ts[i];
+            });
+            this->selected = selected;
+            seen           = {};
+            current        = npos;
+            n              = 0;
+        }
+
+        bool is_obj() const {
+            return ti->is_obj;
+        }
+
+        bool key(std::string &k, sax_sink *&sink, serde::error &err) override {
+            current = km->find(k);
+            sink    = nullptr;
+            return current == npos || field(current, sink, err);
+        }
+
+        bool element(sax_sink *&sink, serde::error &err) override {
+            current = n < N ? n++ : npos;
+            sink    = nullptr;
+            return current == npos || field(current, sink, err);
+        }
+
+        bool end(serde::error &err) override {
+            // missing fields, the context being the missing one
+            for (current = 0; current < N; ++current) {
+                const serde::TagInfo &t = ti->ts[current];
+                if (seen[current] || !wanted(current) || t.skipmissing)
+                    continue;
+                err = serde::error(ti->is_obj ? "key '" + std::string(t.key) + "' not found"
+                                              : "array index " + std::to_string(current) + " is out of range");
+                return false;
+            }
+            current = npos;
+            return true;
+        }
+
+        void add_context(serde::error &e) const override {
+            if (current == npos)
+                return;
+            if (ti->is_obj)
+                e.add_context(ti->ts[current].key);
+            else
+                e.add_context(current);
+        }
+
+    protected:
+        template <size_t... I>
+        static auto make_sinks(std::index_sequence<I...>)
+            -> std::tuple<sax_value<sax_field_t<std::tuple_element_t<I, Tuple>>>...>;
+
+        using sinks_type = decltype(make_sinks(std::make_index_sequence<N>{}));
+
+        const serde::TagInfoTuple<N> *ti = nullptr;
+        const serde::KeyMap<N>       *km = nullptr;
+        serde::TagInfoTuple<N>        own_ti;
+        serde::KeyMap<N>              own_km;
+        std::array<const char *, N>   tags     = {}; // runtime tags `own_ti` was parsed from
+        const bool                   *selected = nullptr;
+        sinks_type                    sinks;
+        sax_raw                       raw;
+        std::array<bool, N>           seen    = {};
+        size_t                        current = npos;
+        size_t                        n       = 0;
+
+        template <typename F>
+        static const char *tag_of(const F &field) {
+            if constexpr (is_tagged_v<F> && !is_static_tagged_v<F>)
+                return field.get_tags().data();
+            else
+                return nullptr;
+        }
+
+        // deserializable and selected, and keyed for objects
+        bool wanted(size_t i) const {
+            bool res = false;
+            tuple_visit(sinks, i, [&](auto &, auto i) {
+                using T = sax_field_t<std::tuple_element_t<i, Tuple>>;
+                res     = serde::is_deserializable_v<nlohmann::json, T> && (!ti->is_obj || ti->ts[i].key != "") &&
+                      (!selected || selected[i]);
+            });
+            return res;
+        }
+
+        bool field(size_t i, sax_sink *&res, serde::error &err) {
+            if (!wanted(i))
+                return true;
+
+            bool ok = true;
+            seen[i] = true;
+            tuple_visit(sinks, i, [&](auto &sink, auto i) {
+                using T = sax_field_t<std::tuple_element_t<i, Tuple>>;
+                if (!ti->ts[i].noserde) {
+                    if ((ok = serde::detail::check_as_int<T>(ti->ts[i].as_int, &err)))
+                        res = &sink;
+                } else if constexpr (std::is_same_v<T, std::string>)
+                    res = &(raw = sax_raw(sink.v));
+                else {
+                    err = serde::error("field with tag `noserde` can only be deserialized into std::string");
+                    ok  = false;
+                }
+            });
+            return ok;
+        }
+    };
+
+    /// Sink of a tagged tuple, whose frame is allocated for the first object or array and reused for the next ones
+    template <typename Tuple>
+    class sax_tuple_sink {
+    public:
+        const bool *selected = nullptr; ///< fields to decode by index, all when null
+
+    protected:
+        std::unique_ptr<sax_tuple_frame<Tuple>> frame;
+
+        // false when the tuple is not decoded from an object, or an array, as `is_obj` tells
+        template <typename Tpl>
+        bool start(Tpl &&tpl, bool is_obj, sax_frame *&res) {
+            if (!frame)
+                frame = std::make_unique<sax_tuple_frame<Tuple>>();
+            frame->reset(std::forward<Tpl>(tpl), selected);
+            res = frame.get();
+            return frame->is_obj() == is_obj;
+        }
+    };
+
+    template <typename... Ts>
+    class sax_value<std::tuple<Ts...>> : public sax_target<std::tuple<Ts...>>, public sax_tuple_sink<std::tuple<Ts...>> {
+    public:
+        using sax_target<std::tuple<Ts...>>::sax_target;
+
+        bool object(sax_frame *&frame, serde::error &err) override {
+            return this->start(*this->v, true, frame) || sax_sink::mismatch("object", err);
+        }
+
+        bool array(sax_frame *&frame, serde::error &err) override {
+            return this->start(*this->v, false, frame) || sax_sink::mismatch("array", err);
+        }
+
+    protected:
+        std::string expected() const override {
+            return json::get_tag_info_from_tuple(*this->v).is_obj ? "object" : "array";
+        }
+    };
+
+#ifdef BOOST_PFR_HPP
+    template <typename T>
+    struct is_std_array : std::false_type {};
+
+    template <typename T, size_t N>
+    struct is_std_array<std::array<T, N>> : std::true_type {};
+
+    template <typename S>
+    using sax_tie_t = decltype(boost::pfr::structure_tie(std::declval<S &>()));
+
+    // `std::array` has its own sink above
+    template <typename S>
+    class sax_value<S, std::enable_if_t<std::is_aggregate_v<S> && !std::is_same_v<S, std::tm> && !is_std_array<S>::value>>
+        : public sax_target<S>, public sax_tuple_sink<sax_tie_t<S>> {
+    public:
+        using sax_target<S>::sax_target;
+
+        bool object(sax_frame *&frame, serde::error &err) override {
+            return this->start(boost::pfr::structure_tie(*this->v), true, frame) || sax_sink::mismatch("object", err);
+        }
+
+        bool array(sax_frame *&frame, serde::error &err) override {
+            return this->start(boost::pfr::structure_tie(*this->v), false, frame) || sax_sink::mismatch("array", err);
+        }
+
+    protected:
+        std::string expected() const override {
+            return json::get_tag_info_from_tuple(boost::pfr::structure_tie(*this->v)).is_obj ? "object" : "array";
+        }
+    };
+#endif
+
+    /// Node of a variant received as a DOM, whose alternatives are decoded through their sinks
+    struct sax_variant_node : variant_node {
+        template <typename A>
+        bool into(A &a, serde::error *err) const {
+            sax_value<A> sink(&a);
+            if (err)
+                return sax_replay(j, sink, *err);
+            serde::error e("");
+            return sax_replay(j, sink, e) || serde::detail::fail(err, std::move(e));
+        }
+    };
+
+    template <typename... T>
+    class sax_value<std::variant<T...>, std::enable_if_t<(std::is_default_constructible_v<T> && ...)>>
+        : public sax_dom_target<std::variant<T...>> {
+    public:
+        using sax_dom_target<std::variant<T...>>::sax_dom_target;
+
+        bool dom(const nlohmann::json &j, serde::error &err) override {
+            const std::string_view tag = this->t ? this->t->tag : std::string_view();
+            return serde::detail::deserialize_variant<nlohmann::json, TagKey>(*this->v, sax_variant_node{{j}}, tag, &err);
+        }
+    };
+
+    /// SAX handler of `nlohmann::json::sax_parse` decoding straight into a value, without building a DOM. Only the values
+    /// whose type has no direct support here, e.g. variants and user `adl_serializer`s, are built as a DOM to be converted.
+    class sax_reader {
+    public:
+        explicit sax_reader(sax_sink &root)
+            : root(&root) {}
+
+        /// Parses `in` into the root sink. Returns false on a syntax error or an error of decoding, see `error`, which
+        /// stops the parsing without throwing.
+        template <typename Input>
+        bool read(
+            Input                         &&in,
+            bool                            ignore_comments,
+            nlohmann::json::input_format_t  format = nlohmann::json::input_format_t::json
+        ) {
+            return nlohmann::json::sax_parse(std::forward<Input>(in), this, format, true, ignore_comments);
+        }
+
+        /// Error that stopped `read`, with the position where it happened as context
+        const serde::error &error() const {
+            return err;
+        }
+
+        bool null() {
+            std::nullptr_t value = nullptr;
+            return scalar(value, [&](sax_sink &s) { return s.null(err); });
+        }
+
+        bool boolean(bool b) {
+            return scalar(b, [&](sax_sink &s) { return s.boolean(b, err); });
+        }
+
+        bool number_integer(nlohmann::json::number_integer_t n) {
+            return scalar(n, [&](sax_sink &s) { return s.sint(n, err); });
+        }
+
+        bool number_unsigned(nlohmann::json::number_unsigned_t n) {
+            return scalar(n, [&](sax_sink &s) { return s.uint(n, err); });
+        }
+
+        bool number_float(nlohmann::json::number_float_t n, const std::string &) {
+            return scalar(n, [&](sax_sink &s) { return s.real(n, err); });
+        }
+
+        bool string(std::string &str) {
+            return scalar(str, [&](sax_sink &s) { return s.string(str, err); });
+        }
+
+        bool binary(nlohmann::json::binary_t &b) {
+            return scalar(b, [&](sax_sink &s) {
+                nlohmann::json j = nlohmann::json::binary(std::move(b));
+                return s.dom(j, err);
+            });
+        }
+
+        bool start_object(size_t) {
+            return start(true);
+        }
+
+        bool key(std::string &k) {
+            if (skip)
+                return true;
+            if (capturing())
+                dom_key = k;
+            else if (!levels.back().frame->key(k, pending, err))
+                return fail();
+            return true;
+        }
+
+        bool end_object() {
+            return end();
+        }
+
+        bool start_array(size_t) {
+            return start(false);
+        }
+
+        bool end_array() {
+            return end();
+        }
+
+        template <typename Exception>
+        bool parse_error(size_t, const std::string &, const Exception &e) {
+            err = serde::error(e.what());
+            return false;
+        }
+
+    protected:
+        struct level {
+            sax_frame *frame;
+            bool       is_obj;
+        };
+
+        sax_sink          *root;
+        sax_sink          *pending = nullptr;
+        std::vector<level> levels;
+        size_t             skip = 0; // depth in a skipped value
+        serde::error       err{""};
+
+        // value without direct support, built as a DOM
+        nlohmann::json                dom;
+        std::vector<nlohmann::json *> dom_stack;
+        std::string                   dom_key;
+        sax_sink                     *dom_target = nullptr;
+
+        bool capturing() const {
+            return !dom_stack.empty();
+        }
+
+        // adds the position of the value that failed to the context of the error, and stops the parsing
+        bool fail() {
+            for (auto it = levels.rbegin(); it != levels.rend(); ++it)
+                it->frame->add_context(err);
+            return false;
+        }
+
+        // sink of the value that comes next, null to skip it
+        bool next(sax_sink *&s) {
+            s = nullptr;
+            if (levels.empty())
+                s = std::exchange(root, nullptr);
+            else if (levels.back().is_obj)
+                s = std::exchange(pending, nullptr);
+            else
+                return levels.back().frame->element(s, err);
+            return true;
+        }
+
+        template <typename V, typename F>
+        bool scalar(V &value, F &&fn) {
+            if (skip)
+                return true;
+            if (capturing()) {
+                put(make(value));
+                return true;
+            }
+
+            sax_sink *s;
+            if (!next(s) || (s && !fn(*s)))
+                return fail();
+            return true;
+        }
+
+        template <typename V>
+        static nlohmann::json make(V &value) {
+            if constexpr (std::is_same_v<V, nlohmann::json::binary_t>)
+                return nlohmann::json::binary(std::move(value));
+            else
+                return value;
+        }
+
+        nlohmann::json *put(nlohmann::json value) {
+            nlohmann::json &top = *dom_stack.back();
+            if (top.is_array()) {
+                top.push_back(std::move(value));
+                return &top.back();
+            }
+            return &(top[dom_key] = std::move(value));
+        }
+
+        bool start(bool is_obj) {
+            auto empty = [&]() { return is_obj ? nlohmann::json::object() : nlohmann::json::array(); };
+            if (skip) {
+                ++skip;
+                return true;
+            }
+            if (capturing()) {
+                dom_stack.push_back(put(empty()));
+                return true;
+            }
+
+            sax_sink *s;
+            if (!next(s))
+                return fail();
+            if (!s) {
+                skip = 1;
+                return true;
+            }
+
+            sax_frame *frame = nullptr;
+            if (!(is_obj ? s->object(frame, err) : s->array(frame, err)))
+                return fail();
+            if (frame)
+                levels.push_back({frame, is_obj});
+            else {
+                dom        = empty();
+                dom_target = s;
+                dom_stack.push_back(&dom);
+            }
+            return true;
+        }
+
+        bool end() {
+            if (skip) {
+                --skip;
+                return true;
+            }
+            if (capturing()) {
+                dom_stack.pop_back();
+                if (!capturing() && !dom_target->dom(dom, err))
+                    return fail();
+                return true;
+            }
+
+            if (!levels.back().frame->end(err))
+                return fail();
+            levels.pop_back();
+            return true;
+        }
+    };
+} // namespace cppxx::json::nlohmann_json::detail
+
+#endif
@@ -2,15 +2,37 @@
 #define CPPXX_JSON_YYJSON_H
 
 #include <cpp++/json/json.h>
+#include <cpp++/json/yy_json_writer.h>
 #include <cpp++/serde/serialize.h>
 #include <cpp++/serde/deserialize.h>
+#include <cpp++/serde/enum.h>
 #include <cpp++/serde/error.h>
-#include <cpp++/defer.h>
+#include <cpp++/serde/parallel.h>
+#include <cpp++/serde/projection.h>
+#include <cpp++/serde/result.h>
+#include <cpp++/serde/variant.h>
+#include <cpp++/mmap.h>
 #include <cpp++/time.h>
+#include <algorithm>
 #include <array>
+#include <cerrno>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <system_error>
 #include <variant>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
+
+#if __has_include(<span>)
+#    include <span>
+#endif
+
+#if __has_include(<unistd.h>)
+#    include <unistd.h>
+#endif
 
 #ifndef YYJSON_H
 #    include <yyjson.h>
@@ -54,28 +76,338 @@ namespace cppxx::json::yy_json {
     std::enable_if_t<std::is_default_constructible_v<T>, T>
     parse_from_file(const std::string &path, yyjson_read_flag = YYJSON_READ_NOFLAG);
 
+#ifdef BOOST_PFR_HPP
+    template <typename T>
+    void parse(const std::string &str, T &val, const serde::projection<T> &fields, yyjson_read_flag = YYJSON_READ_NOFLAG);
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, T>
+    parse(const std::string &str, const serde::projection<T> &fields, yyjson_read_flag = YYJSON_READ_NOFLAG);
+#endif
+
+    template <typename T>
+    void get(const std::string &str, std::string_view pointer, T &val, yyjson_read_flag = YYJSON_READ_NOFLAG);
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, T>
+    get(const std::string &str, std::string_view pointer, yyjson_read_flag = YYJSON_READ_NOFLAG);
+
     template <typename T>
     [[nodiscard]]
     std::string dump(const T &val, yyjson_write_flag = YYJSON_WRITE_NOFLAG);
+
+#if __has_include(<unistd.h>)
+    template <typename T>
+    void dump_to(int fd, const T &val, yyjson_write_flag = YYJSON_WRITE_NOFLAG, size_t threads = 1);
+#endif
+
+    template <typename T>
+    [[nodiscard]]
+    serde::result<void> try_parse(const std::string &str, T &val, yyjson_read_flag = YYJSON_READ_NOFLAG);
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, serde::result<T>>
+    try_parse(const std::string &str, yyjson_read_flag = YYJSON_READ_NOFLAG);
+
+    template <typename T>
+    [[nodiscard]]
+    serde::result<std::string> try_dump(const T &val, yyjson_write_flag = YYJSON_WRITE_NOFLAG);
+
+    template <typename T>
+    class Document;
+
+    template <typename T>
+    [[nodiscard]]
+    Document<T> parse_insitu(std::string buffer, yyjson_read_flag = YYJSON_READ_NOFLAG);
 } // namespace cppxx::json::yy_json
 
+namespace cppxx::json {
+    template <typename T>
+    class lazy;
+} // namespace cppxx::json
+
+namespace cppxx::json::yy_json::detail {
+    /// Vectors whose elements can be decoded and encoded by several threads
+    template <typename T>
+    struct is_vector : std::false_type {};
+
+    template <typename T, typename A>
+    struct is_vector<std::vector<T, A>> : std::is_default_constructible<T> {};
+
+    template <typename T, typename = void>
+    struct has_mapped_type : std::false_type {};
+
+    template <typename T>
+    struct has_mapped_type<T, std::void_t<typename T::mapped_type>> : std::true_type {};
+
+    template <typename T, typename = void>
+    struct has_value_type : std::false_type {};
+
+    template <typename T>
+    struct has_value_type<T, std::void_t<typename T::value_type>> : std::true_type {};
+
+    template <typename T>
+    struct is_string_view : std::false_type {};
+
+    template <typename CT>
+    struct is_string_view<std::basic_string_view<char, CT>> : std::true_type {};
+
+    template <typename T>
+    struct is_lazy : std::false_type {};
+
+    template <typename T>
+    struct is_lazy<json::lazy<T>> : std::true_type {
+        using type = T;
+    };
+
+    template <typename T, typename... Seen>
+    constexpr bool borrows();
+
+    template <typename Tuple, typename... Seen>
+    struct tuple_borrows;
+
+    template <template <typename...> typename L, typename... Ts, typename... Seen>
+    struct tuple_borrows<L<Ts...>, Seen...> : std::bool_constant<(borrows<Ts, Seen...>() || ...)> {};
+
+    /// True when decoding `T` borrows strings from the document, i.e. it holds a `std::string_view` or a
+    /// `std::span<const char>` somewhere. `Seen` are the enclosing types, so that recursive types terminate.
+    template <typename T, typename... Seen>
+    constexpr bool borrows() {
+        using U = std::remove_cv_t<std::remove_reference_t<T>>;
+        if constexpr ((std::is_same_v<U, Seen> || ...))
+            return false;
+        else if constexpr (is_string_view<U>::value)
+            return true;
+#if __cpp_lib_span >= 202002L
+        else if constexpr (std::is_same_v<U, std::span<const char>>)
+            return true;
+#endif
+        else if constexpr (std::is_same_v<U, std::string>)
+            return false;
+        else if constexpr (is_tagged_v<U>)
+            return borrows<typename U::type, Seen...>();
+        else if constexpr (is_lazy<U>::value)
+            return borrows<typename is_lazy<U>::type, U, Seen...>();
+        else if constexpr (is_tuple_v<U> || serde::detail::is_variant<U>::value)
+            return tuple_borrows<U, U, Seen...>::value;
+        else if constexpr (has_mapped_type<U>::value)
+            return borrows<typename U::mapped_type, U, Seen...>();
+        else if constexpr (has_value_type<U>::value)
+            return borrows<typename U::value_type, U, Seen...>();
+#ifdef BOOST_PFR_HPP
+        else if constexpr (std::is_aggregate_v<U> && std::is_class_v<U>)
+            return tuple_borrows<decltype(boost::pfr::structure_tie(std::declval<U &>())), U, Seen...>::value;
+#endif
+        else
+            return false;
+    }
+
+    /// Values decoded from a document that is freed once they are decoded must own their strings. Borrowing fields are
+    /// decoded with `yy_json::Document`, which keeps the document alive with the value.
+    template <typename T>
+    constexpr void assert_owned() {
+        static_assert(
+            !borrows<T>(),
+            "std::string_view and std::span<const char> fields borrow from the document, which is freed once decoded; "
+            "decode them with yy_json::Document (see yy_json::parse_insitu)"
+        );
+    }
+
+    /// A parsed document, freed with the file it may have been parsed from in situ
+    struct document {
+        yyjson_doc *doc = nullptr;
+#ifdef CPPXX_HAS_MMAP
+        // the strings of the document point into the mapping, so it is unmapped after the document is freed
+        MappedFile file;
+#endif
+        document() = default;
+
+        document(document &&other) noexcept
+            : doc(std::exchange(other.doc, nullptr))
+#ifdef CPPXX_HAS_MMAP
+            , file(std::move(other.file))
+#endif
+        {
+        }
+
+        document &operator=(document &&) = delete;
+
+        ~document() {
+            if (doc)
+                yyjson_doc_free(doc);
+        }
+    };
+
+    /// The document being decoded by `Parse`, which the `json::lazy` fields decoded from it share.
+    ///
+    /// Nothing is allocated until the first lazy field asks for the document, which then moves to the heap and is freed
+    /// with the last of them. A document allocated by a custom allocator is never shared, since the allocator may not
+    /// outlive it, and lazy fields then decode right away.
+    class document_scope {
+    public:
+        document_scope(document &d, bool shareable)
+            : d(d)
+            , shareable(shareable)
+            , prev(std::exchange(current_scope(), this)) {}
+
+        document_scope(const document_scope &)            = delete;
+        document_scope &operator=(const document_scope &) = delete;
+
+        ~document_scope() {
+            current_scope() = prev;
+        }
+
+        /// Scope of the document being decoded on this thread, if any
+        static document_scope *current() {
+            return current_scope();
+        }
+
+        /// Shared ownership of the document, null when it cannot be shared
+        std::shared_ptr<const document> share() {
+            if (!shareable)
+                return nullptr;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!shared)
+                shared = std::make_shared<document>(std::move(d));
+            return shared;
+        }
+
+        /// Makes `scope` the current one on this thread, e.g. on the threads decoding a vector
+        class enter {
+        public:
+            explicit enter(document_scope *scope)
+                : prev(std::exchange(current_scope(), scope)) {}
+
+            enter(const enter &)            = delete;
+            enter &operator=(const enter &) = delete;
+
+            ~enter() {
+                current_scope() = prev;
+            }
+
+        protected:
+            document_scope *prev;
+        };
+
+    protected:
+        document                        &d;
+        const bool                       shareable;
+        document_scope                  *prev;
+        std::mutex                       mutex;
+        std::shared_ptr<const document> shared;
+
+        static document_scope *&current_scope() {
+            thread_local document_scope *scope = nullptr;
+            return scope;
+        }
+    };
+} // namespace cppxx::json::yy_json::detail
+
 
 namespace cppxx::serde {
     template <typename C, typename CT, typename A>
     struct Parse<yyjson_doc, std::basic_string<C, CT, A>> {
         const std::basic_string<C, CT, A> &src;
         yyjson_read_flag                   flag = YYJSON_READ_NOFLAG;
+        const yyjson_alc                  *alc  = nullptr;
+
+        /// Threads decoding the elements when the value is a `std::vector`, 0 for one per core
+        size_t threads = 1;
+
+        /// JSON pointer (RFC 6901) of the value to decode, e.g. "/items/0/id", the root when empty
+        std::string_view pointer = {};
 
+        /// When `src_is_path` and the file can be mapped, it is parsed in situ from a private mapping instead of being
+        /// read into a buffer.
+        ///
+        /// `val` is decoded over in place: the strings, vector elements, optionals and map entries already in it keep
+        /// their memory, so parsing a same-shaped document again into a long-lived value barely allocates. Fields with
+        /// `skipmissing` that are missing from the document keep their value.
         template <typename T>
         void into(T &val, bool src_is_path = false) const {
+            document d;
+            read(d, src_is_path);
+            decode(d, val, nullptr);
+        }
+
+#ifdef BOOST_PFR_HPP
+        /// Same as `into`, decoding only the fields selected by `p`. The others are skipped without being looked at,
+        /// and the walk of the object stops once every selected field is found.
+        template <typename T>
+        void into(T &val, const projection<T> &p, bool src_is_path = false) const {
+            document d;
+            read(d, src_is_path);
+            decode(d, val, nullptr, p.data());
+        }
+#endif
+
+        /// Same as `into`, with the errors returned instead of thrown. The document is decoded with an error out-parameter,
+        /// see `detail::fail`, so that an invalid document throws nothing.
+        template <typename T>
+        result<void> try_into(T &val, bool src_is_path = false) const {
+            document        d;
+            yyjson_read_err read_err;
+            try {
+                read(d, read_err, src_is_path);
+            } catch (const std::system_error &e) {
+                // the file could not be mapped
+                return error(e.what());
+            }
+            if (!d.doc)
+                return error(read_err.msg);
+
+            error err("");
+            if (!decode(d, val, &err))
+                return err;
+            return {};
+        }
+
+    protected:
+        using document = json::yy_json::detail::document;
+
+        void read(document &d, bool src_is_path) const {
             yyjson_read_err err;
-            yyjson_doc     *doc = src_is_path ? yyjson_read_file(const_cast<char *>(src.c_str()), flag, nullptr, &err)
-                                              : yyjson_read_opts(const_cast<char *>(src.c_str()), src.size(), flag, nullptr, &err);
-            if (!doc)
+            try {
+                read(d, err, src_is_path);
+            } catch (const std::system_error &e) {
+                throw error(e.what());
+            }
+            if (!d.doc)
                 throw error(err.msg);
+        }
 
-            auto _ = defer([&] { yyjson_doc_free(doc); });
-            Deserialize<yyjson_val, T>{yyjson_doc_get_root(doc)}.into(val);
+        void read(document &d, yyjson_read_err &err, bool src_is_path) const {
+#ifdef CPPXX_HAS_MMAP
+            if (src_is_path && MappedFile::is_mappable({src.data(), src.size()})) {
+                d.file = MappedFile({src.data(), src.size()}, YYJSON_PADDING_SIZE);
+                d.doc  = yyjson_read_opts(d.file.data(), d.file.size(), flag | YYJSON_READ_INSITU, alc, &err);
+                return;
+            }
+#endif
+            d.doc = src_is_path ? yyjson_read_file(const_cast<char *>(src.c_str()), flag, alc, &err)
+                                : yyjson_read_opts(const_cast<char *>(src.c_str()), src.size(), flag, alc, &err);
+        }
+
+        /// Decodes the root of `d` into `val`, the errors being thrown when `err` is null, see `detail::fail`
+        template <typename T, typename... Args>
+        bool decode(document &d, T &val, error *err, Args... args) const {
+            json::yy_json::detail::assert_owned<T>();
+
+            yyjson_val *root = yyjson_doc_get_root(d.doc);
+            if (!pointer.empty()) {
+                root = yyjson_doc_ptr_getn(d.doc, pointer.data(), pointer.size());
+                if (!root)
+                    return detail::fail(err, error("no value at `" + std::string(pointer) + "`"));
+            }
+
+            json::yy_json::detail::document_scope scope(d, alc == nullptr);
+            if constexpr (json::yy_json::detail::is_vector<T>::value && sizeof...(Args) == 0)
+                return Deserialize<yyjson_val, T>{root, threads}.into(val, err);
+            else
+                return Deserialize<yyjson_val, T>{root, args...}.into(val, err);
         }
     };
 
@@ -83,24 +415,49 @@ namespace cppxx::serde {
     struct Dump<yyjson_mut_doc, std::basic_string<C, CT, A>> {
         yyjson_write_flag flag = YYJSON_WRITE_NOFLAG;
 
+        /// Measure the output in a first pass so that it is allocated once
+        bool exact_size = false;
+
+        /// Threads writing the elements when the value is a `std::vector`, 0 for one per core
+        size_t threads = 1;
+
+        /// Parse the `noserde` fields before splicing them into the output, see `Writer::validate_raw`
+        bool validate_raw = true;
+
         template <typename T>
         std::basic_string<C, CT, A> from(const T &val) const {
-            yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
-            if (!doc)
-                throw error("Fatal error: cannot create yyjson doc");
+            std::string res;
+            if (exact_size) {
+                json::yy_json::Writer counter(nullptr, flag);
+                counter.validate_raw(false);
+                write(counter, val);
+                counter.end();
+                res.reserve(counter.size());
+            }
 
-            auto _ = defer([&]() { yyjson_mut_doc_free(doc); });
-            yyjson_mut_doc_set_root(doc, Serialize<yyjson_mut_val, T>{doc}.from(val));
+            json::yy_json::Writer w(&res, flag);
+            w.validate_raw(validate_raw);
+            write(w, val);
+            w.end();
 
-            size_t           len;
-            yyjson_write_err err;
-            const char      *str = yyjson_mut_write_opts(doc, flag, nullptr, &len, &err);
-            if (!str)
-                throw error(err.msg);
+            if constexpr (std::is_same_v<std::basic_string<C, CT, A>, std::string>)
+                return res;
+            else
+                return {res.data(), res.size()};
+        }
 
-            std::basic_string<C, CT, A> res = {str, len};
-            ::free((void *)str);
-            return res;
+        /// Same as `from`, with the errors caught and returned instead of thrown
+        template <typename T>
+        result<std::basic_string<C, CT, A>> try_from(const T &val) const {
+            return capture([&]() { return from(val); });
+        }
+
+        template <typename T>
+        void write(json::yy_json::Writer &w, const T &val) const {
+            if constexpr (json::yy_json::detail::is_vector<T>::value)
+                Serialize<json::yy_json::Writer, T>{w, threads}.from(val);
+            else
+                Serialize<json::yy_json::Writer, T>{w}.from(val);
         }
     };
 
@@ -118,10 +475,11 @@ namespace cppxx::serde {
     struct Deserialize<yyjson_val, bool> {
         yyjson_val *val;
 
-        void into(bool &v) const {
+        bool into(bool &v, error *err = nullptr) const {
             if (!yyjson_is_bool(val))
-                throw type_mismatch_error("bool", yyjson_get_type_desc(val));
+                return detail::fail(err, type_mismatch_error("bool", yyjson_get_type_desc(val)));
             v = yyjson_get_bool(val);
+            return true;
         }
     };
 
@@ -145,10 +503,11 @@ namespace cppxx::serde {
         std::enable_if_t<std::is_signed_v<T> && !std::is_same_v<T, bool> && !std::is_floating_point_v<T>>> {
         yyjson_val *val;
 
-        void into(T &v) const {
+        bool into(T &v, error *err = nullptr) const {
             if (!yyjson_is_sint(val) && !yyjson_is_uint(val))
-                throw type_mismatch_error("sint", yyjson_get_type_desc(val));
+                return detail::fail(err, type_mismatch_error("sint", yyjson_get_type_desc(val)));
             v = (T)yyjson_get_sint(val);
+            return true;
         }
     };
 
@@ -166,10 +525,11 @@ namespace cppxx::serde {
     struct Deserialize<yyjson_val, T, std::enable_if_t<std::is_unsigned_v<T> && !std::is_same_v<T, bool>>> {
         yyjson_val *val;
 
-        void into(T &v) const {
+        bool into(T &v, error *err = nullptr) const {
             if (!yyjson_is_uint(val))
-                throw type_mismatch_error("uint", yyjson_get_type_desc(val));
+                return detail::fail(err, type_mismatch_error("uint", yyjson_get_type_desc(val)));
             v = (T)yyjson_get_uint(val);
+            return true;
         }
     };
 
@@ -187,10 +547,11 @@ namespace cppxx::serde {
     struct Deserialize<yyjson_val, T, std::enable_if_t<std::is_floating_point_v<T>>> {
         yyjson_val *val;
 
-        void into(T &v) const {
+        bool into(T &v, error *err = nullptr) const {
             if (!yyjson_is_real(val))
-                throw type_mismatch_error("real", yyjson_get_type_desc(val));
+                return detail::fail(err, type_mismatch_error("real", yyjson_get_type_desc(val)));
             v = (T)yyjson_get_real(val);
+            return true;
         }
     };
 
@@ -203,16 +564,15 @@ namespace cppxx::serde {
             return owned ? yyjson_mut_strncpy(doc, v.data(), v.size()) : yyjson_mut_strn(doc, v.data(), v.size());
         }
 
-        yyjson_mut_val *from_raw(std::basic_string_view<C, CT> v) {
+        /// Validates `v` as JSON and keeps its text as a raw value, written verbatim instead of being copied node by node
+        yyjson_mut_val *from_raw(std::basic_string_view<C, CT> v) const {
             yyjson_read_err err;
             yyjson_doc     *doc = yyjson_read_opts(const_cast<char *>(v.data()), v.size(), 0, nullptr, &err);
-
             if (!doc)
                 throw error(err.msg);
-            auto _ = defer([&]() { yyjson_doc_free(doc); });
+            yyjson_doc_free(doc);
 
-            yyjson_val *root = yyjson_doc_get_root(doc);
-            return yyjson_val_mut_copy(this->doc, root);
+            return yyjson_mut_rawncpy(this->doc, v.data(), v.size());
         }
     };
 
@@ -236,49 +596,96 @@ namespace cppxx::serde {
     struct Deserialize<yyjson_val, std::basic_string<C, CT, A>> {
         yyjson_val *val;
 
-        void into(std::basic_string<C, CT, A> &v) const {
+        bool into(std::basic_string<C, CT, A> &v, error *err = nullptr) const {
             if (!yyjson_is_str(val))
-                throw type_mismatch_error("string", yyjson_get_type_desc(val));
-            v = yyjson_get_str(val);
+                return detail::fail(err, type_mismatch_error("string", yyjson_get_type_desc(val)));
+            v.assign(yyjson_get_str(val), yyjson_get_len(val));
+            return true;
         }
 
+        /// Writes the value back as compact JSON, straight from the document
         void into_raw(std::basic_string<C, CT, A> &v) const {
-            yyjson_mut_doc *doc    = yyjson_mut_doc_new(nullptr);
-            yyjson_mut_val *copied = yyjson_val_mut_copy(doc, val);
-            yyjson_mut_doc_set_root(doc, copied);
-
-            size_t           len;
-            yyjson_write_err err;
-            const char      *str = yyjson_mut_write_opts(doc, 0, nullptr, &len, &err);
-            if (!str)
-                throw error(err.msg);
+            if constexpr (std::is_same_v<std::basic_string<C, CT, A>, std::string>) {
+                v.clear();
+                json::yy_json::Writer(&v).value(val);
+            } else {
+                std::string str;
+                json::yy_json::Writer(&str).value(val);
+                v.assign(str.begin(), str.end());
+            }
+        }
+    };
 
-            v = std::basic_string<C, CT, A>(str, len);
-            ::free((void *)str);
+    /// Borrows the string from the document, the view is valid as long as the document lives. Only `yy_json::Document`
+    /// keeps the document alive with the value, the other entry points reject borrowing values at compile time.
+    template <typename CT>
+    struct Deserialize<yyjson_val, std::basic_string_view<char, CT>> {
+        yyjson_val *val;
+
+        bool into(std::basic_string_view<char, CT> &v, error *err = nullptr) const {
+            if (!yyjson_is_str(val))
+                return detail::fail(err, type_mismatch_error("string", yyjson_get_type_desc(val)));
+            v = {yyjson_get_str(val), yyjson_get_len(val)};
+            return true;
+        }
+    };
+
+#if __cpp_lib_span >= 202002L
+    template <>
+    struct Serialize<yyjson_mut_val, std::span<const char>> {
+        yyjson_mut_doc *doc;
+
+        yyjson_mut_val *from(std::span<const char> v) const {
+            return yyjson_mut_strn(doc, v.data(), v.size());
+        }
+    };
+
+    /// Borrows the string from the document, the span is valid as long as the document lives, see the view above
+    template <>
+    struct Deserialize<yyjson_val, std::span<const char>> {
+        yyjson_val *val;
+
+        bool into(std::span<const char> &v, error *err = nullptr) const {
+            if (!yyjson_is_str(val))
+                return detail::fail(err, type_mismatch_error("string", yyjson_get_type_desc(val)));
+            v = {yyjson_get_str(val), yyjson_get_len(val)};
+            return true;
         }
     };
+#endif
 
     // optional
     template <typename T>
     struct Serialize<yyjson_mut_val, std::optional<T>> {
         yyjson_mut_doc *doc;
+        bool            as_int = false; ///< from the `int` option of the field, for an optional enum
 
         yyjson_mut_val *from(const std::optional<T> &v) const {
             if (!v.has_value())
                 return yyjson_mut_null(doc);
-            return Serialize<yyjson_mut_val, T>{doc}.from(*v);
+            if constexpr (detail::is_named_enum_v<T>)
+                return Serialize<yyjson_mut_val, T>{doc, as_int}.from(*v);
+            else
+                return Serialize<yyjson_mut_val, T>{doc}.from(*v);
         }
     };
 
     template <typename T>
     struct Deserialize<yyjson_val, std::optional<T>, std::enable_if_t<std::is_default_constructible_v<T>>> {
         yyjson_val *val;
+        bool        as_int = false; ///< from the `int` option of the field, for an optional enum
 
-        void into(std::optional<T> &v) const {
-            if (!val || yyjson_is_null(val))
-                return void(v = std::nullopt);
-            v = T{};
-            Deserialize<yyjson_val, T>{val}.into(*v);
+        bool into(std::optional<T> &v, error *err = nullptr) const {
+            if (!val || yyjson_is_null(val)) {
+                v = std::nullopt;
+                return true;
+            }
+            if (!v)
+                v.emplace();
+            if constexpr (detail::is_named_enum_v<T>)
+                return Deserialize<yyjson_val, T>{val, as_int}.into(*v, err);
+            else
+                return Deserialize<yyjson_val, T>{val}.into(*v, err);
         }
     };
 
@@ -304,23 +711,20 @@ namespace cppxx::serde {
     struct Deserialize<yyjson_val, std::array<T, N>> {
         yyjson_val *val;
 
-        void into(std::array<T, N> &v) const {
+        bool into(std::array<T, N> &v, error *err = nullptr) const {
             auto arr = this->val;
             if (!yyjson_is_arr(arr))
-                throw type_mismatch_error("array", yyjson_get_type_desc(arr));
+                return detail::fail(err, type_mismatch_error("array", yyjson_get_type_desc(arr)));
             if (auto n = yyjson_arr_size(arr); N != n)
-                throw size_mismatch_error(N, n);
+                return detail::fail(err, size_mismatch_error(N, n));
 
             size_t      idx, max;
             yyjson_val *val;
             yyjson_arr_foreach(arr, idx, max, val) {
-                try {
-                    Deserialize<yyjson_val, T>{val}.into(v[idx]);
-                } catch (error &e) {
-                    e.add_context(idx);
-                    throw;
-                }
+                if (!detail::with_context(err, idx, [&] { return Deserialize<yyjson_val, T>{val}.into(v[idx], err); }))
+                    return false;
             }
+            return true;
         }
     };
 
@@ -346,22 +750,63 @@ namespace cppxx::serde {
     struct Deserialize<yyjson_val, std::vector<T, A>, std::enable_if_t<std::is_default_constructible_v<T>>> {
         yyjson_val *val;
 
-        void into(std::vector<T, A> &v) const {
+        /// Number of threads decoding the elements, 0 for one per core. Each thread decodes at least `min_chunk` elements.
+        size_t threads = 1;
+
+        static constexpr size_t min_chunk = 256;
+
+        bool into(std::vector<T, A> &v, error *err = nullptr) const {
             auto arr = this->val;
             if (!yyjson_is_arr(arr))
-                throw type_mismatch_error("array", yyjson_get_type_desc(arr));
+                return detail::fail(err, type_mismatch_error("array", yyjson_get_type_desc(arr)));
+
+            const size_t n      = yyjson_arr_size(arr);
+            const size_t chunks = threads == 1 ? 1 : parallel_chunk_count(n, threads, min_chunk);
+            // the elements already there are decoded over in place, keeping their memory
+            v.resize(n);
+
+            if (chunks == 1) {
+                size_t      idx, max;
+                yyjson_val *val;
+                yyjson_arr_foreach(arr, idx, max, val) {
+                    if (!detail::with_context(err, idx, [&] { return Deserialize<yyjson_val, T>{val}.into(v[idx], err); }))
+                        return false;
+                }
+                return true;
+            }
 
-            v.resize(yyjson_arr_size(arr));
-            size_t      idx, max;
-            yyjson_val *val;
+            // an array can only be walked from its first element, so the first element of each chunk is found beforehand
+            std::vector<yyjson_val *> firsts(chunks);
+            size_t                    idx, max, chunk = 0;
+            yyjson_val               *val;
             yyjson_arr_foreach(arr, idx, max, val) {
-                try {
-                    Deserialize<yyjson_val, T>{val}.into(v[idx]);
-                } catch (error &e) {
-                    e.add_context(idx);
-                    throw;
-                }
+                if (chunk < chunks && idx == n * chunk / chunks)
+                    firsts[chunk++] = val;
             }
+
+            // each chunk stops at its first error, so the error of the lowest chunk is the one of the lowest index. With
+            // `err`, each chunk has its own error, the lowest failed one being reported.
+            auto               scope = json::yy_json::detail::document_scope::current();
+            std::vector<error> errors(err ? chunks : 0, error(""));
+            std::vector<char>  failed(chunks);
+            parallel_chunks(n, chunks, [&](size_t chunk, size_t begin, size_t end) {
+                json::yy_json::detail::document_scope::enter _(scope);
+                yyjson_val                                 *val       = firsts[chunk];
+                error                                      *chunk_err = err ? &errors[chunk] : nullptr;
+                for (size_t idx = begin; idx < end; ++idx, val = unsafe_yyjson_get_next(val)) {
+                    if (!detail::with_context(chunk_err, idx, [&] {
+                            return Deserialize<yyjson_val, T>{val}.into(v[idx], chunk_err);
+                        }))
+                        return void(failed[chunk] = true);
+                }
+            });
+
+            for (size_t chunk = 0; chunk < chunks; ++chunk)
+                if (failed[chunk]) {
+                    *err = std::move(errors[chunk]);
+                    return false;
+                }
+            return true;
         }
     };
 
@@ -371,94 +816,158 @@ namespace cppxx::serde {
         yyjson_mut_doc *doc;
 
         yyjson_mut_val *from(const std::tuple<Ts...> &tpl) const {
-            const TagInfoTuple<sizeof...(Ts)>         ti     = cppxx::json::get_tag_info_from_tuple(tpl);
-            const std::array<TagInfo, sizeof...(Ts)> &ts     = ti.ts;
-            const bool                                is_obj = ti.is_obj;
-
-            yyjson_mut_val *obj_or_arr = is_obj ? yyjson_mut_obj(doc) : yyjson_mut_arr(doc);
-            tuple_for_each(tpl, [&](const auto &item, const size_t i) {
-                const TagInfo &t            = ts[i];
-                const auto    &v            = detail::get_underlying_value(item);
-                using T                     = std::decay_t<decltype(v)>;
-                constexpr bool serializable = is_serializable_v<yyjson_mut_val, T>;
-
-                if (!serializable || (is_obj && t.key == "") || (t.omitempty && detail::is_empty_value(v)))
-                    return;
-
-                yyjson_mut_val *val = nullptr;
-                try {
-                    if (t.noserde)
-                        if constexpr (std::is_same_v<T, std::string>)
-                            val = Serialize<yyjson_mut_val, std::string>{doc}.from_raw(v);
+            return cppxx::json::with_tag_info_tuple(tpl, [&](const TagInfoTuple<sizeof...(Ts)> &ti) {
+                const std::array<TagInfo, sizeof...(Ts)> &ts     = ti.ts;
+                const bool                                is_obj = ti.is_obj;
+
+                yyjson_mut_val *obj_or_arr = is_obj ? yyjson_mut_obj(doc) : yyjson_mut_arr(doc);
+                tuple_for_each(tpl, [&](const auto &item, auto i) {
+                    const TagInfo &t            = ts[i];
+                    const auto    &v            = detail::get_underlying_value(item);
+                    using T                     = std::decay_t<decltype(v)>;
+                    constexpr bool     serializable = is_serializable_v<yyjson_mut_val, T>;
+                    constexpr TagFlags f            = tag_flags_v<cppxx::json::TagKey, std::tuple<Ts...>, i>;
+
+                    if constexpr (serializable) {
+                        if constexpr (f.unkeyed)
+                            if (is_obj && t.key == "")
+                                return;
+                        if constexpr (f.omitempty)
+                            if (t.omitempty && detail::is_empty_value(v))
+                                return;
+
+                        auto encode = [&]() -> yyjson_mut_val * {
+                            if constexpr (f.noserde)
+                                if (t.noserde) {
+                                    if constexpr (std::is_same_v<T, std::string>)
+                                        return Serialize<yyjson_mut_val, std::string>{doc}.from_raw(v);
+                                    else
+                                        throw error("field with tag `noserde` can only be serialized from std::string");
+                                }
+                            detail::check_as_int<T, f.is_static, f.as_int>(t.as_int);
+                            if constexpr (detail::takes_as_int_v<T> && f.as_int)
+                                return Serialize<yyjson_mut_val, T>{doc, t.as_int}.from(v);
+                            else
+                                return Serialize<yyjson_mut_val, T>{doc}.from(v);
+                        };
+
+                        yyjson_mut_val *val = nullptr;
+                        try {
+                            val = encode();
+                        } catch (error &e) {
+                            if (is_obj)
+                                e.add_context(t.key);
+                            else
+                                e.add_context(i);
+                            throw;
+                        }
+                        if (is_obj)
+                            yyjson_mut_obj_add(obj_or_arr, yyjson_mut_strn(doc, t.key.data(), t.key.size()), val);
                         else
-                            throw error("field with tag `noserde` can only be serialized from std::string");
-                    else {
-                        if constexpr (serializable)
-                            val = Serialize<yyjson_mut_val, T>{doc}.from(v);
+                            yyjson_mut_arr_append(obj_or_arr, val);
                     }
-                } catch (error &e) {
-                    if (is_obj)
-                        e.add_context(t.key);
-                    else
-                        e.add_context(i);
-                    throw;
-                }
-                if (is_obj)
-                    yyjson_mut_obj_add(obj_or_arr, yyjson_mut_strn(doc, t.key.data(), t.key.size()), val);
-                else
-                    yyjson_mut_arr_append(obj_or_arr, val);
+                });
+                return obj_or_arr;
             });
-            return obj_or_arr;
         }
     };
 
     template <typename... Ts>
     struct Deserialize<yyjson_val, std::tuple<Ts...>> {
         yyjson_val *val;
-
-        void into(std::tuple<Ts...> &tpl) const {
-            const TagInfoTuple<sizeof...(Ts)>         ti     = cppxx::json::get_tag_info_from_tuple(tpl);
-            const std::array<TagInfo, sizeof...(Ts)> &ts     = ti.ts;
-            const bool                                is_obj = ti.is_obj;
-
-            yyjson_val *obj = this->val;
-            yyjson_val *arr = this->val;
-
-            if (is_obj && !yyjson_is_obj(obj))
-                throw type_mismatch_error("object", yyjson_get_type_desc(obj));
-            if (!is_obj && !yyjson_is_arr(arr))
-                throw type_mismatch_error("array", yyjson_get_type_desc(arr));
-
-            tuple_for_each(tpl, [&](auto &item, const size_t i) {
-                const TagInfo &t              = ts[i];
-                auto          &v              = detail::get_underlying_value(item);
-                using T                       = std::decay_t<decltype(v)>;
-                constexpr bool deserializable = is_deserializable_v<yyjson_val, T>;
-
-                if (!deserializable || (is_obj && t.key == ""))
-                    return;
-
-                yyjson_val *val = is_obj ? yyjson_obj_getn(obj, t.key.data(), t.key.size()) : yyjson_arr_get(arr, i);
-                if (!val && t.skipmissing)
-                    return;
-
-                try {
-                    if (t.noserde)
-                        if constexpr (std::is_same_v<T, std::string>)
-                            Deserialize<yyjson_val, std::string>{val}.into_raw(v);
-                        else
-                            throw error("field with tag `noserde` can only be deserialized into std::string");
-                    else {
-                        if constexpr (deserializable)
-                            Deserialize<yyjson_val, T>{val}.into(v);
+        const bool *selected = nullptr; ///< fields to decode by index, all when null, see `serde::fields`
+
+        bool into(std::tuple<Ts...> &tpl, error *err = nullptr) const {
+            return cppxx::json::with_tag_info_tuple(tpl, [&](const TagInfoTuple<sizeof...(Ts)> &ti) {
+                const std::array<TagInfo, sizeof...(Ts)> &ts     = ti.ts;
+                const bool                                is_obj = ti.is_obj;
+
+                yyjson_val *obj = this->val;
+                yyjson_val *arr = this->val;
+
+                if (is_obj && !yyjson_is_obj(obj))
+                    return detail::fail(err, type_mismatch_error("object", yyjson_get_type_desc(obj)));
+                if (!is_obj && !yyjson_is_arr(arr))
+                    return detail::fail(err, type_mismatch_error("array", yyjson_get_type_desc(arr)));
+
+                // the fields after a failed one are left as they are
+                bool ok    = true;
+                auto field = [&](auto &item, auto i, yyjson_val *val) {
+                    const TagInfo &t              = ts[i];
+                    auto          &v              = detail::get_underlying_value(item);
+                    using T                       = std::decay_t<decltype(v)>;
+                    constexpr bool     deserializable = is_deserializable_v<yyjson_val, T>;
+                    constexpr TagFlags f              = tag_flags_v<cppxx::json::TagKey, std::tuple<Ts...>, i>;
+
+                    if constexpr (deserializable) {
+                        if constexpr (f.unkeyed)
+                            if (is_obj && t.key == "")
+                                return;
+                        if constexpr (f.skipmissing)
+                            if (!val && t.skipmissing)
+                                return;
+
+                        auto decode = [&] {
+                            if constexpr (f.noserde)
+                                if (t.noserde) {
+                                    if constexpr (std::is_same_v<T, std::string>) {
+                                        Deserialize<yyjson_val, std::string>{val}.into_raw(v);
+                                        return true;
+                                    } else
+                                        return detail::fail(
+                                            err, error("field with tag `noserde` can only be deserialized into std::string")
+                                        );
+                                }
+                            if (!detail::check_as_int<T, f.is_static, f.as_int>(t.as_int, err))
+                                return false;
+                            if constexpr (detail::is_variant<T>::value)
+                                return Deserialize<yyjson_val, T>{val, t.tag}.into(v, err);
+                            else if constexpr (detail::takes_as_int_v<T> && f.as_int)
+                                return Deserialize<yyjson_val, T>{val, t.as_int}.into(v, err);
+                            else
+                                return Deserialize<yyjson_val, T>{val}.into(v, err);
+                        };
+
+                        ok = is_obj ? detail::with_context(err, t.key, decode) : detail::with_context(err, i, decode);
                     }
-                } catch (error &e) {
-                    if (is_obj)
-                        e.add_context(t.key);
-                    else
-                        e.add_context(i);
-                    throw;
+                };
+
+                if (!is_obj) {
+                    tuple_for_each(tpl, [&](auto &item, auto i) {
+                        if (ok && (!selected || selected[i]))
+                            field(item, i, yyjson_arr_get(arr, i));
+                    });
+                    return ok;
                 }
+
+                // walk the object once, dispatching each key to its field
+                cppxx::json::with_key_map(tpl, ti, [&](const KeyMap<sizeof...(Ts)> &km) {
+                    std::array<bool, sizeof...(Ts)> seen   = {};
+                    size_t                          wanted = 0;
+                    for (size_t i = 0; i < sizeof...(Ts); ++i)
+                        wanted += ts[i].key != "" && (!selected || selected[i]);
+
+                    size_t      idx, max, found = 0;
+                    yyjson_val *key, *val;
+                    yyjson_obj_foreach(obj, idx, max, key, val) {
+                        const size_t i = km.find({yyjson_get_str(key), yyjson_get_len(key)});
+                        // the first of duplicated keys wins, as with `yyjson_obj_getn`
+                        if (i == km.npos || (selected && !selected[i]) || std::exchange(seen[i], true))
+                            continue;
+                        tuple_visit(tpl, i, [&](auto &item, auto i) { field(item, i, val); });
+
+                        // the remaining keys are unknown or duplicated
+                        if (!ok || ++found == wanted)
+                            break;
+                    }
+
+                    // missing fields
+                    tuple_for_each(tpl, [&](auto &item, auto i) {
+                        if (ok && !seen[i] && (!selected || selected[i]))
+                            field(item, i, nullptr);
+                    });
+                });
+                return ok;
             });
         }
     };
@@ -477,38 +986,57 @@ namespace cppxx::serde {
 
     template <typename... T>
     struct Deserialize<yyjson_val, std::variant<T...>, std::enable_if_t<(std::is_default_constructible_v<T> && ...)>> {
-        yyjson_val *val;
+        yyjson_val      *val;
+        std::string_view tag = {}; ///< key naming the alternative, from the `tag=` option of the field
 
-        void into(std::variant<T...> &v) const {
-            try_for_each(v, std::index_sequence_for<T...>{});
+        bool into(std::variant<T...> &v, error *err = nullptr) const {
+            return detail::deserialize_variant<yyjson_val, cppxx::json::TagKey>(v, node{val}, tag, err);
         }
 
     protected:
-        template <size_t... I>
-        void try_for_each(std::variant<T...> &v, std::index_sequence<I...>) const {
-            bool        done = false;
-            std::string type_names;
-            (
-                [&]() {
-                    using Elem = std::tuple_element_t<I, std::tuple<T...>>;
-                    try {
-                        if (!done) {
-                            auto element = Elem{};
-                            Deserialize<yyjson_val, Elem>{val}.into(element);
-                            v    = std::move(element);
-                            done = true;
-                        }
-                    } catch (type_mismatch_error &e) {
-                        type_names += e.expected_type + '|';
-                    }
-                }(),
-                ...
-            );
-            if (!done) {
-                type_names.pop_back();
-                throw type_mismatch_error(type_names, yyjson_get_type_desc(val));
+        struct node {
+            yyjson_val *val;
+
+            unsigned kinds() const {
+                if (!val || yyjson_is_null(val))
+                    return node_kind::null;
+                if (yyjson_is_bool(val))
+                    return node_kind::boolean;
+                if (yyjson_is_uint(val))
+                    return node_kind::uint;
+                if (yyjson_is_sint(val))
+                    return node_kind::sint;
+                if (yyjson_is_real(val))
+                    return node_kind::real;
+                if (yyjson_is_str(val))
+                    return node_kind::string;
+                if (yyjson_is_arr(val))
+                    return node_kind::array;
+                if (yyjson_is_obj(val))
+                    return node_kind::object;
+                return 0;
             }
-        }
+
+            std::string type_name() const {
+                return yyjson_get_type_desc(val);
+            }
+
+            bool has_key(std::string_view key) const {
+                return yyjson_obj_getn(val, key.data(), key.size()) != nullptr;
+            }
+
+            std::optional<std::string_view> string_at(std::string_view key) const {
+                yyjson_val *str = yyjson_obj_getn(val, key.data(), key.size());
+                if (!yyjson_is_str(str))
+                    return std::nullopt;
+                return std::string_view(yyjson_get_str(str), yyjson_get_len(str));
+            }
+
+            template <typename A>
+            bool into(A &a, error *err) const {
+                return Deserialize<yyjson_val, A>{val}.into(a, err);
+            }
+        };
     };
 
     // map
@@ -537,24 +1065,54 @@ namespace cppxx::serde {
         std::enable_if_t<std::is_default_constructible_v<T>>> {
         yyjson_val *val;
 
-        void into(std::unordered_map<std::basic_string<C, CT, CA>, T, H, P, A> &v) {
+        /// The map ends up with the keys of the object only. The entries whose key is not in the object are erased and
+        /// the others are decoded over in place, so that decoding a same-shaped object again allocates nothing but the
+        /// sorted list of its keys.
+        bool into(std::unordered_map<std::basic_string<C, CT, CA>, T, H, P, A> &v, error *err = nullptr) {
             auto obj = this->val;
             if (!yyjson_is_obj(obj))
-                throw type_mismatch_error("object", yyjson_get_type_desc(obj));
+                return detail::fail(err, type_mismatch_error("object", yyjson_get_type_desc(obj)));
+
+            using member = std::pair<std::string_view, yyjson_val *>;
+            std::vector<member> members;
+            members.reserve(yyjson_obj_size(obj));
+
             size_t      idx, max;
             yyjson_val *key, *val;
             yyjson_obj_foreach(obj, idx, max, key, val) {
-                std::basic_string<C, CT, CA> key_str;
-                Deserialize<yyjson_val, std::basic_string<C, CT, CA>>{key}.into(key_str);
-                auto item = T{};
-                try {
-                    Deserialize<yyjson_val, T>{val}.into(item);
-                } catch (error &e) {
-                    e.add_context(key_str);
-                    throw;
-                }
-                v.emplace(std::move(key_str), std::move(item));
+                members.emplace_back(std::string_view(yyjson_get_str(key), yyjson_get_len(key)), val);
+            }
+
+            // values are laid out in document order, so the first of duplicated keys sorts first and wins, as with
+            // `yyjson_obj_getn`
+            std::sort(members.begin(), members.end(), [](const member &a, const member &b) {
+                return a.first != b.first ? a.first < b.first : std::less<yyjson_val *>()(a.second, b.second);
+            });
+            members.erase(
+                std::unique(
+                    members.begin(), members.end(), [](const member &a, const member &b) { return a.first == b.first; }
+                ),
+                members.end()
+            );
+
+            auto in_object = [&](std::string_view k) {
+                auto it = std::lower_bound(
+                    members.begin(), members.end(), k, [](const member &m, std::string_view k) { return m.first < k; }
+                );
+                return it != members.end() && it->first == k;
+            };
+            for (auto it = v.begin(); it != v.end();)
+                it = in_object({it->first.data(), it->first.size()}) ? std::next(it) : v.erase(it);
+            v.reserve(members.size());
+
+            std::basic_string<C, CT, CA> key_str;
+            for (auto &[k, val] : members) {
+                key_str.assign(k.data(), k.size());
+                auto it = v.try_emplace(key_str).first;
+                if (!detail::with_context(err, k, [&] { return Deserialize<yyjson_val, T>{val}.into(it->second, err); }))
+                    return false;
             }
+            return true;
         }
     };
 
@@ -572,10 +1130,13 @@ namespace cppxx::serde {
     struct Deserialize<yyjson_val, std::tm> {
         yyjson_val *val;
 
-        void into(std::tm &tm) {
-            std::string str;
-            Deserialize<yyjson_val, std::string>{val}.into(str);
-            tm = tm_from_string(str);
+        bool into(std::tm &tm, error *err = nullptr) {
+            std::string_view str;
+            if (!Deserialize<yyjson_val, std::string_view>{val}.into(str, err))
+                return false;
+            if (!tm_from_string(str, tm))
+                return detail::fail(err, error("Invalid datetime format: " + std::string(str)));
+            return true;
         }
     };
 
@@ -594,10 +1155,11 @@ namespace cppxx::serde {
     template <typename S>
     struct Deserialize<yyjson_val, S, std::enable_if_t<std::is_aggregate_v<S> && !std::is_same_v<S, std::tm>>> {
         yyjson_val *val;
+        const bool *selected = nullptr; ///< fields to decode by index, all when null, see `serde::fields`
 
-        void into(S &v) {
+        bool into(S &v, error *err = nullptr) {
             auto tpl = boost::pfr::structure_tie(v);
-            Deserialize<yyjson_val, decltype(tpl)>{val}.into(tpl);
+            return Deserialize<yyjson_val, decltype(tpl)>{val, selected}.into(tpl, err);
         }
     };
 #endif
@@ -607,8 +1169,11 @@ namespace cppxx::serde {
     template <typename S>
     struct Serialize<yyjson_mut_val, S, std::enable_if_t<std::is_enum_v<S>>> {
         yyjson_mut_doc *doc;
+        bool            as_int = false; ///< from the `int` option of the field
 
         yyjson_mut_val *from(const S &v) const {
+            if (as_int)
+                return Serialize<yyjson_mut_val, std::underlying_type_t<S>>{doc}.from(std::underlying_type_t<S>(v));
             return Serialize<yyjson_mut_val, std::string_view>{doc}.from(magic_enum::enum_name(v));
         }
     };
@@ -616,20 +1181,17 @@ namespace cppxx::serde {
     template <typename S>
     struct Deserialize<yyjson_val, S, std::enable_if_t<std::is_enum_v<S>>> {
         yyjson_val *val;
+        bool        as_int = false; ///< from the `int` option of the field
 
-        void into(S &v) {
-            std::string str;
-            Deserialize<yyjson_val, std::string>{val}.into(str);
-            auto e = magic_enum::enum_cast<S>(str);
-            if (!e.has_value()) {
-                std::string what = "invalid value `" + str + "`, expected one of {";
-                for (auto &name : magic_enum::enum_names<S>()) {
-                    what += std::string(name) + ",";
-                }
-                what += "}";
-                throw error(std::move(what));
+        bool into(S &v, error *err = nullptr) const {
+            if (as_int) {
+                std::underlying_type_t<S> n;
+                return Deserialize<yyjson_val, std::underlying_type_t<S>>{val}.into(n, err) &&
+                       detail::enum_from_int<S>(n, v, err);
             }
-            v = *e;
+            if (!yyjson_is_str(val))
+                return detail::fail(err, type_mismatch_error("string", yyjson_get_type_desc(val)));
+            return detail::enum_from_name<S>({yyjson_get_str(val), yyjson_get_len(val)}, v, err);
         }
     };
 #endif
@@ -663,10 +1225,381 @@ namespace cppxx::json::yy_json {
         return val;
     }
 
+#ifdef BOOST_PFR_HPP
+    /// Parses only the fields of `val` selected by `fields`, e.g. `serde::fields(&Order::id, &Order::ts)`
+    template <typename T>
+    void parse(const std::string &str, T &val, const serde::projection<T> &fields, yyjson_read_flag flag) {
+        cppxx::serde::Parse<yyjson_doc, std::string>{str, flag}.into(val, fields);
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, T>
+    parse(const std::string &str, const serde::projection<T> &fields, yyjson_read_flag flag) {
+        T val = {};
+        cppxx::serde::Parse<yyjson_doc, std::string>{str, flag}.into(val, fields);
+        return val;
+    }
+#endif
+
+    /// Parses the value at the JSON pointer `pointer`, e.g. "/items/0/id", without decoding the rest of the document
+    template <typename T>
+    void get(const std::string &str, std::string_view pointer, T &val, yyjson_read_flag flag) {
+        cppxx::serde::Parse<yyjson_doc, std::string>{str, flag, nullptr, 1, pointer}.into(val);
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, T>
+    get(const std::string &str, std::string_view pointer, yyjson_read_flag flag) {
+        T val = {};
+        cppxx::serde::Parse<yyjson_doc, std::string>{str, flag, nullptr, 1, pointer}.into(val);
+        return val;
+    }
+
     template <typename T>
     [[nodiscard]]
     std::string dump(const T &val, yyjson_write_flag flag) {
         return cppxx::serde::Dump<yyjson_mut_doc, std::string>{flag}.from(val);
     }
+
+    template <typename T>
+    [[nodiscard]]
+    serde::result<void> try_parse(const std::string &str, T &val, yyjson_read_flag flag) {
+        return cppxx::serde::Parse<yyjson_doc, std::string>{str, flag}.try_into(val);
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, serde::result<T>> try_parse(const std::string &str, yyjson_read_flag flag) {
+        T    val = {};
+        auto res = cppxx::serde::Parse<yyjson_doc, std::string>{str, flag}.try_into(val);
+        if (!res)
+            return res.error();
+        return serde::result<T>(std::move(val));
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    serde::result<std::string> try_dump(const T &val, yyjson_write_flag flag) {
+        return cppxx::serde::Dump<yyjson_mut_doc, std::string>{flag}.try_from(val);
+    }
+
+#if __has_include(<unistd.h>)
+    /// Dumps `val` to the file descriptor `fd`. When `val` is a `std::vector`, `threads` threads (0 for one per core)
+    /// write slices of its elements, and each slice is written to `fd` in order as soon as it and the slices before it
+    /// are done, so only a few slices per thread are held in memory at once.
+    template <typename T>
+    void dump_to(int fd, const T &val, yyjson_write_flag flag, size_t threads) {
+        std::string buf;
+        Writer      w(&buf, flag);
+
+        auto flush = [&]() {
+            for (size_t done = 0; done < buf.size();) {
+                const ssize_t n = ::write(fd, buf.data() + done, buf.size() - done);
+                if (n < 0 && errno != EINTR)
+                    throw std::system_error(errno, std::generic_category(), "failed to write");
+                if (n > 0)
+                    done += size_t(n);
+            }
+            buf.clear();
+        };
+
+        if constexpr (detail::is_vector<T>::value) {
+            w.arr_begin();
+            cppxx::serde::Serialize<Writer, T>{w, threads}.from_elements(val, [&](std::string &fragment) {
+                w.splice(fragment);
+                flush();
+            });
+            w.arr_end();
+        } else
+            cppxx::serde::Serialize<Writer, T>{w}.from(val);
+
+        w.end();
+        flush();
+    }
+#endif
+
+
+    /// A value parsed in situ, together with the buffer and the document it was parsed from.
+    ///
+    /// The buffer is parsed with `YYJSON_READ_INSITU`, so strings are unescaped in place and `std::string_view` (or
+    /// `std::span<const char>`) fields point straight into it instead of being copied. Those fields are valid as long as
+    /// the document lives; moving the document keeps them valid.
+    /// @code
+    /// struct Line {
+    ///     Tag<std::string_view> level   = "json:`level`";
+    ///     Tag<std::string_view> message = "json:`message`";
+    /// };
+    ///
+    /// auto line = yy_json::parse_insitu<Line>(read_line());
+    /// std::cout << line->message() << std::endl;
+    /// @endcode
+    template <typename T>
+    class Document {
+    public:
+        explicit Document(std::string src, yyjson_read_flag flag = YYJSON_READ_NOFLAG)
+            : buffer(std::make_unique<std::string>(std::move(src)))
+            , doc(nullptr, yyjson_doc_free) {
+            // yyjson reads a few bytes past the end of an in situ buffer
+            const size_t len = buffer->size();
+            buffer->append(YYJSON_PADDING_SIZE, '\0');
+
+            yyjson_read_err err;
+            doc.reset(yyjson_read_opts(buffer->data(), len, flag | YYJSON_READ_INSITU, nullptr, &err));
+            if (!doc)
+                throw serde::error(err.msg);
+
+            cppxx::serde::Deserialize<yyjson_val, T>{yyjson_doc_get_root(doc.get())}.into(value);
+        }
+
+        T &operator*() & {
+            return value;
+        }
+        const T &operator*() const & {
+            return value;
+        }
+
+        T *operator->() {
+            return &value;
+        }
+        const T *operator->() const {
+            return &value;
+        }
+
+        T &get() & {
+            return value;
+        }
+        const T &get() const & {
+            return value;
+        }
+
+    protected:
+        // heap allocated so that moving the document never moves the characters the value points into
+        std::unique_ptr<std::string>                            buffer;
+        std::unique_ptr<yyjson_doc, decltype(&yyjson_doc_free)> doc;
+        T                                                       value = {};
+    };
+
+    template <typename T>
+    [[nodiscard]]
+    Document<T> parse_insitu(std::string buffer, yyjson_read_flag flag) {
+        return Document<T>(std::move(buffer), flag);
+    }
+
+    /// Reusable parser. Documents are allocated from a dynamic allocator owned by the parser, so the memory of a parsed
+    /// document is kept for the next one instead of being given back to the system.
+    ///
+    /// A parser must not be used by several threads at once, see `Parser::local` for a per-thread instance.
+    /// @code
+    /// auto &parser = yy_json::Parser::local();
+    /// for (const auto &line : lines)
+    ///     people.push_back(parser.parse<Person>(line));
+    /// @endcode
+    class Parser {
+    public:
+        explicit Parser(yyjson_read_flag flag = YYJSON_READ_NOFLAG)
+            : flag(flag)
+            , alc(yyjson_alc_dyn_new(), yyjson_alc_dyn_free) {
+            if (!alc)
+                throw serde::error("failed to create yyjson allocator");
+        }
+
+        template <typename T>
+        void parse(const std::string &str, T &val) {
+            cppxx::serde::Parse<yyjson_doc, std::string>{str, flag, alc.get()}.into(val);
+        }
+
+        template <typename T>
+        void parse_from_file(const std::string &path, T &val) {
+            cppxx::serde::Parse<yyjson_doc, std::string>{path, flag, alc.get()}.into(val, true);
+        }
+
+        template <typename T>
+        [[nodiscard]]
+        std::enable_if_t<std::is_default_constructible_v<T>, T> parse(const std::string &str) {
+            T val = {};
+            parse(str, val);
+            return val;
+        }
+
+        template <typename T>
+        [[nodiscard]]
+        std::enable_if_t<std::is_default_constructible_v<T>, T> parse_from_file(const std::string &path) {
+            T val = {};
+            parse_from_file(path, val);
+            return val;
+        }
+
+        /// Parser of the calling thread, with the default flags
+        static Parser &local() {
+            static thread_local Parser parser;
+            return parser;
+        }
+
+    protected:
+        yyjson_read_flag                                            flag;
+        std::unique_ptr<yyjson_alc, decltype(&yyjson_alc_dyn_free)> alc;
+    };
+
+    /// Parser fed with the chunks of a document as they arrive, e.g. from a socket, so that the document is parsed while
+    /// the rest of it is still being received.
+    ///
+    /// Each message starts with `begin`, announcing its size when known (e.g. a `Content-Length`). The chunks are then
+    /// parsed as they are fed, and `feed` returns true once the root is complete. When the size is unknown, the chunks are
+    /// only buffered and parsed at once by `finish`. The buffer and the allocator are kept between messages.
+    ///
+    /// An incremental parser must not be used by several threads at once.
+    /// @code
+    /// yy_json::IncrementalParser parser;
+    /// parser.begin(content_length);
+    /// while (!parser.feed(socket.receive()))
+    ///     ;
+    /// auto person = parser.get<Person>();
+    /// @endcode
+    class IncrementalParser {
+    public:
+        explicit IncrementalParser(yyjson_read_flag flag = YYJSON_READ_NOFLAG)
+            : flag(flag)
+            , alc(yyjson_alc_dyn_new(), yyjson_alc_dyn_free)
+            , state(nullptr, yyjson_incr_free)
+            , doc(nullptr, yyjson_doc_free) {
+            if (!alc)
+                throw serde::error("failed to create yyjson allocator");
+        }
+
+        /// Starts a message of `size` bytes
+        void begin(size_t size) {
+            reset();
+            this->size = size;
+
+            // parsed in situ, with the padding yyjson reads past the end
+            buffer.assign(size + YYJSON_PADDING_SIZE, '\0');
+            state.reset(yyjson_incr_new(buffer.data(), size, flag | YYJSON_READ_INSITU, alc.get()));
+            if (!state)
+                throw serde::error("failed to create yyjson incremental state");
+        }
+
+        /// Starts a message of unknown size
+        void begin() {
+            reset();
+            buffer.clear();
+        }
+
+        /// Appends `chunk` and parses as far as it goes, returns true once the document is complete
+        bool feed(std::string_view chunk) {
+            if (doc)
+                throw serde::error("document is already complete");
+            if (!state) {
+                buffer.append(chunk.data(), chunk.size());
+                len = buffer.size();
+                return false;
+            }
+            if (chunk.size() > size - len)
+                throw serde::error("received more than the " + std::to_string(size) + " bytes announced");
+
+            len += chunk.copy(buffer.data() + len, chunk.size());
+
+            yyjson_read_err err;
+            doc.reset(yyjson_incr_read(state.get(), len, &err));
+            if (!doc && err.code != YYJSON_READ_ERROR_MORE)
+                throw serde::error(err.msg);
+            return doc != nullptr;
+        }
+
+        /// Ends the message: parses the buffered document when its size is unknown, or checks that it is complete
+        void finish() {
+            if (doc)
+                return;
+            if (state)
+                throw serde::error("truncated document, " + std::to_string(len) + " of " + std::to_string(size) + " bytes");
+
+            buffer.append(YYJSON_PADDING_SIZE, '\0');
+            yyjson_read_err err;
+            doc.reset(yyjson_read_opts(buffer.data(), len, flag | YYJSON_READ_INSITU, alc.get(), &err));
+            if (!doc)
+                throw serde::error(err.msg);
+        }
+
+        /// True once the document is complete
+        bool done() const {
+            return doc != nullptr;
+        }
+
+        /// Decodes the completed document into `val`, over its current value
+        template <typename T>
+        void into(T &val) {
+            detail::assert_owned<T>();
+            finish();
+            cppxx::serde::Deserialize<yyjson_val, T>{yyjson_doc_get_root(doc.get())}.into(val);
+        }
+
+        template <typename T>
+        [[nodiscard]]
+        std::enable_if_t<std::is_default_constructible_v<T>, T> get() {
+            T val = {};
+            into(val);
+            return val;
+        }
+
+    protected:
+        yyjson_read_flag                                                 flag;
+        std::unique_ptr<yyjson_alc, decltype(&yyjson_alc_dyn_free)>      alc;
+        std::unique_ptr<yyjson_incr_state, decltype(&yyjson_incr_free)> state;
+        std::unique_ptr<yyjson_doc, decltype(&yyjson_doc_free)>          doc;
+        std::string                                                      buffer;
+        size_t                                                           size = 0;
+        size_t                                                           len  = 0;
+
+        void reset() {
+            doc.reset();
+            state.reset();
+            size = 0;
+            len  = 0;
+        }
+    };
+
+    /// Reusable dumper. The output buffer, the writer state and the allocator used for `noserde` fields are kept between
+    /// calls, so dumping many values of similar size allocates only while the buffer grows.
+    ///
+    /// A dumper must not be used by several threads at once, see `Dumper::local` for a per-thread instance.
+    class Dumper {
+    public:
+        /// With `validate_raw` off, the `noserde` fields are spliced into the output without being parsed
+        explicit Dumper(yyjson_write_flag flag = YYJSON_WRITE_NOFLAG, bool validate_raw = true)
+            : alc(yyjson_alc_dyn_new(), yyjson_alc_dyn_free)
+            , writer(nullptr, flag, alc.get()) {
+            if (!alc)
+                throw serde::error("failed to create yyjson allocator");
+            writer.validate_raw(validate_raw);
+        }
+
+        /// Dumps `val` into the internal buffer. The returned string is valid until the next call.
+        template <typename T>
+        const std::string &dump(const T &val) {
+            dump(val, buffer);
+            return buffer;
+        }
+
+        /// Dumps `val` into `out`, replacing its content but keeping its capacity
+        template <typename T>
+        void dump(const T &val, std::string &out) {
+            out.clear();
+            writer.reset(&out);
+            cppxx::serde::Serialize<Writer, T>{writer}.from(val);
+            writer.end();
+        }
+
+        /// Dumper of the calling thread, with the default flags
+        static Dumper &local() {
+            static thread_local Dumper dumper;
+            return dumper;
+        }
+
+    protected:
+        std::unique_ptr<yyjson_alc, decltype(&yyjson_alc_dyn_free)> alc;
+        Writer                                                      writer;
+        std::string                                                 buffer;
+    };
 } // namespace cppxx::json::yy_json
 #endif
@@ -0,0 +1,148 @@
+#ifndef CPPXX_JSON_YYJSON_LAZY_H
+#define CPPXX_JSON_YYJSON_LAZY_H
+
+#include <cpp++/json/yy_json.h>
+#include <cpp++/serde/error.h>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace cppxx::json {
+    /// A value decoded from its JSON on first access.
+    ///
+    /// When parsed with `yy_json::parse` and friends, the field keeps the undecoded subtree and a shared ownership of the
+    /// document, so a section that is never read costs nothing. As long as it is not modified, it is dumped from the
+    /// undecoded subtree without going through `T`: the values are the same, but they are written again in the
+    /// formatting of the dump, not copied from the original text. Where the document cannot be shared (a custom
+    /// allocator, `Document`, or a `Deserialize` called directly), the value is decoded right away.
+    ///
+    /// Decoding on first access is not thread safe, and its errors are thrown by `get`.
+    /// @code
+    /// struct Order {
+    ///     Tag<int>                           id    = "json:`id`";
+    ///     Tag<json::lazy<std::vector<Item>>> items = "json:`items`";
+    /// };
+    ///
+    /// Order order = yy_json::parse<Order>(body);
+    /// if (order.id() == wanted)
+    ///     handle(order.items().get());
+    /// @endcode
+    template <typename T>
+    class lazy {
+    public:
+        lazy() = default;
+
+        lazy(T value)
+            : value(std::move(value)) {}
+
+        lazy &operator=(T v) {
+            set(std::move(v));
+            return *this;
+        }
+
+        /// The value, decoded on the first call
+        const T &get() const {
+            if (!value)
+                decode();
+            return *value;
+        }
+
+        const T &operator*() const {
+            return get();
+        }
+
+        const T *operator->() const {
+            return &get();
+        }
+
+        /// The value to be modified. The subtree it was decoded from is dropped, it is then dumped from the value.
+        T &modify() {
+            get();
+            raw = nullptr;
+            doc.reset();
+            return *value;
+        }
+
+        void set(T v) {
+            value = std::move(v);
+            raw   = nullptr;
+            doc.reset();
+        }
+
+        /// True once the value was decoded or set
+        bool is_decoded() const {
+            return value.has_value();
+        }
+
+        /// The undecoded subtree, null once modified
+        yyjson_val *get_raw() const {
+            return raw;
+        }
+
+        /// Keeps `val`, which lives as long as `doc`
+        void reset(yyjson_val *val, std::shared_ptr<const yy_json::detail::document> doc) {
+            this->raw = val;
+            this->doc = std::move(doc);
+            value.reset();
+        }
+
+    protected:
+        yyjson_val                                      *raw = nullptr;
+        std::shared_ptr<const yy_json::detail::document> doc;
+        mutable std::optional<T>                         value;
+
+        void decode() const {
+            T v = {};
+            if (raw)
+                cppxx::serde::Deserialize<yyjson_val, T>{raw}.into(v);
+            value = std::move(v);
+        }
+    };
+} // namespace cppxx::json
+
+namespace cppxx::serde {
+    template <typename T>
+    struct Serialize<yyjson_mut_val, json::lazy<T>> {
+        yyjson_mut_doc *doc;
+
+        yyjson_mut_val *from(const json::lazy<T> &v) const {
+            if (yyjson_val *raw = v.get_raw())
+                return yyjson_val_mut_copy(doc, raw);
+            return Serialize<yyjson_mut_val, T>{doc}.from(v.get());
+        }
+    };
+
+    template <typename T>
+    struct Serialize<json::yy_json::Writer, json::lazy<T>> {
+        json::yy_json::Writer &w;
+
+        void from(const json::lazy<T> &v) const {
+            if (yyjson_val *raw = v.get_raw())
+                return w.value(raw);
+            Serialize<json::yy_json::Writer, T>{w}.from(v.get());
+        }
+    };
+
+    template <typename T>
+    struct Deserialize<yyjson_val, json::lazy<T>, std::enable_if_t<std::is_default_constructible_v<T>>> {
+        yyjson_val *val;
+
+        bool into(json::lazy<T> &v, error *err = nullptr) const {
+            auto scope = json::yy_json::detail::document_scope::current();
+            auto doc   = val && scope ? scope->share() : nullptr;
+            if (doc) {
+                v.reset(val, std::move(doc));
+                return true;
+            }
+
+            // a missing field or a document that cannot be shared, decoded right away
+            T value = {};
+            if (!Deserialize<yyjson_val, T>{val}.into(value, err))
+                return false;
+            v.set(std::move(value));
+            return true;
+        }
+    };
+} // namespace cppxx::serde
+
+#endif
@@ -0,0 +1,336 @@
+#ifndef CPPXX_JSON_YYJSON_NDJSON_H
+#define CPPXX_JSON_YYJSON_NDJSON_H
+
+#include <cpp++/json/yy_json.h>
+#include <cpp++/serde/error.h>
+#include <cpp++/defer.h>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace cppxx::json::yy_json::ndjson::detail {
+    /// A file descriptor, closed on destruction when owned
+    class file_descriptor {
+    public:
+        file_descriptor(int fd, bool owned)
+            : fd(fd)
+            , owned(owned) {}
+
+        /// Opens `path` with `flags`, throws when it cannot be opened
+        file_descriptor(const std::string &path, int flags, mode_t mode = 0)
+            : fd(::open(path.c_str(), flags | O_CLOEXEC, mode))
+            , owned(true) {
+            if (fd < 0)
+                throw std::system_error(errno, std::generic_category(), "failed to open " + path);
+        }
+
+        file_descriptor(file_descriptor &&other) noexcept
+            : fd(std::exchange(other.fd, -1))
+            , owned(std::exchange(other.owned, false)) {}
+
+        file_descriptor(const file_descriptor &)            = delete;
+        file_descriptor &operator=(const file_descriptor &) = delete;
+        file_descriptor &operator=(file_descriptor &&)      = delete;
+
+        ~file_descriptor() {
+            if (owned)
+                ::close(fd);
+        }
+
+        int get() const {
+            return fd;
+        }
+
+    protected:
+        int  fd;
+        bool owned;
+    };
+} // namespace cppxx::json::yy_json::ndjson::detail
+
+namespace cppxx::json::yy_json::ndjson {
+    /// What a reader does with a line that is not valid JSON or does not match the record type
+    enum class on_error {
+        raise, ///< throw a `serde::error` whose context starts with the zero-based line index, e.g. `[41].age`
+        skip,  ///< count the line in `reader::skipped` and go on with the next one
+    };
+
+    /// Reads JSON Lines (one JSON document per line) one record at a time.
+    ///
+    /// The input is read through a fixed buffer that only grows to fit the longest line, and documents are allocated from
+    /// an allocator kept between records, so the memory stays the same however big the input is. Blank lines are ignored.
+    ///
+    /// Each line is decoded into a default constructed record, so that a `skipmissing` field missing from a line takes its
+    /// default rather than the value of the previous record, and a skipped line leaves nothing behind.
+    /// @code
+    /// ndjson::reader<Event> events("events.jsonl", ndjson::on_error::skip);
+    /// for (const Event &event : events)
+    ///     handle(event);
+    /// @endcode
+    template <typename T>
+    class reader {
+    public:
+        class iterator;
+
+        explicit reader(
+            const std::string &path,
+            on_error           mode        = on_error::raise,
+            yyjson_read_flag   flag        = YYJSON_READ_NOFLAG,
+            size_t             buffer_size = 64 * 1024
+        )
+            : reader(detail::file_descriptor(path, O_RDONLY), mode, flag, buffer_size) {
+#ifdef POSIX_FADV_SEQUENTIAL
+            ::posix_fadvise(fd.get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        }
+
+        /// Reads from `fd`, which is not closed by the reader
+        explicit reader(
+            int fd, on_error mode = on_error::raise, yyjson_read_flag flag = YYJSON_READ_NOFLAG, size_t buffer_size = 64 * 1024
+        )
+            : reader(detail::file_descriptor(fd, false), mode, flag, buffer_size) {}
+
+        reader(const reader &)            = delete;
+        reader &operator=(const reader &) = delete;
+
+        /// Reads the next record into `val`, false at the end of the input
+        bool next(T &val) {
+            std::string_view line;
+            while (next_line(line)) {
+                ++n_lines;
+                if (line.find_first_not_of(" \t\r") == std::string_view::npos)
+                    continue;
+
+                // a skipped line is reported by return value, so that malformed input throws nothing
+                if (mode == on_error::raise)
+                    return serde::detail::with_context(nullptr, n_lines - 1, [&] { return decode(line, val, nullptr); });
+                if (decode(line, val, &err))
+                    return true;
+                ++n_skipped;
+            }
+            return false;
+        }
+
+        /// Number of lines read so far
+        size_t lines() const {
+            return n_lines;
+        }
+
+        /// Number of lines skipped because of an error, see `on_error::skip`
+        size_t skipped() const {
+            return n_skipped;
+        }
+
+        iterator begin() {
+            return iterator(this);
+        }
+
+        iterator end() {
+            return iterator();
+        }
+
+        /// Input iterator over the remaining records
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type        = T;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const T *;
+            using reference         = const T &;
+
+            iterator() = default;
+
+            explicit iterator(reader *r)
+                : r(r) {
+                ++*this;
+            }
+
+            reference operator*() const {
+                return val;
+            }
+
+            pointer operator->() const {
+                return &val;
+            }
+
+            iterator &operator++() {
+                if (!r->next(val))
+                    r = nullptr;
+                return *this;
+            }
+
+            bool operator==(const iterator &other) const {
+                return r == other.r;
+            }
+
+            bool operator!=(const iterator &other) const {
+                return r != other.r;
+            }
+
+        private:
+            reader *r   = nullptr;
+            T       val = {};
+        };
+
+    protected:
+        // first, so that an opened file is closed when the rest fails to construct
+        detail::file_descriptor fd;
+        on_error                mode;
+        yyjson_read_flag        flag;
+        std::vector<char>       buf;
+        size_t                  head      = 0; // start of the next line
+        size_t                  scan      = 0; // bytes before it are known to hold no newline
+        size_t                  tail      = 0; // end of the data read so far
+        bool                    eof       = false;
+        size_t                  n_lines   = 0;
+        size_t                  n_skipped = 0;
+        serde::error            err{""}; // of the last skipped line
+
+        std::unique_ptr<yyjson_alc, decltype(&yyjson_alc_dyn_free)> alc;
+
+        reader(detail::file_descriptor fd, on_error mode, yyjson_read_flag flag, size_t buffer_size)
+            : fd(std::move(fd))
+            , mode(mode)
+            , flag(flag)
+            , buf(buffer_size ? buffer_size : 1)
+            , alc(yyjson_alc_dyn_new(), yyjson_alc_dyn_free) {
+            if (!alc)
+                throw serde::error("failed to create yyjson allocator");
+        }
+
+        bool next_line(std::string_view &line) {
+            for (;;) {
+                if (auto nl = static_cast<char *>(std::memchr(buf.data() + scan, '\n', tail - scan))) {
+                    line = {buf.data() + head, size_t(nl - buf.data()) - head};
+                    head = scan = size_t(nl - buf.data()) + 1;
+                    return true;
+                }
+                scan = tail;
+
+                if (eof) {
+                    if (head == tail)
+                        return false;
+                    line = {buf.data() + head, tail - head};
+                    head = tail;
+                    return true;
+                }
+
+                // move the partial line to the front, and grow only when it fills the whole buffer
+                std::memmove(buf.data(), buf.data() + head, tail - head);
+                scan -= head;
+                tail -= head;
+                head = 0;
+                if (tail == buf.size())
+                    buf.resize(buf.size() * 2);
+
+                ssize_t n;
+                do
+                    n = ::read(fd.get(), buf.data() + tail, buf.size() - tail);
+                while (n < 0 && errno == EINTR);
+
+                if (n < 0)
+                    throw std::system_error(errno, std::generic_category(), "failed to read");
+                eof = n == 0;
+                tail += size_t(n);
+            }
+        }
+
+        /// Decodes `line` into `val`, the errors being thrown when `err` is null, see `serde::detail::fail`
+        bool decode(std::string_view line, T &val, serde::error *err) {
+            yy_json::detail::assert_owned<T>();
+
+            yyjson_read_err read_err;
+            yyjson_doc *doc = yyjson_read_opts(const_cast<char *>(line.data()), line.size(), flag, alc.get(), &read_err);
+            if (!doc)
+                return serde::detail::fail(err, serde::error(read_err.msg));
+
+            auto _   = defer([&]() { yyjson_doc_free(doc); });
+            T    res = {};
+            if (!cppxx::serde::Deserialize<yyjson_val, T>{yyjson_doc_get_root(doc)}.into(res, err))
+                return false;
+            val = std::move(res);
+            return true;
+        }
+    };
+
+    /// Writes records as JSON Lines, one compact document per line.
+    ///
+    /// Lines are gathered in a buffer that is written out once it holds `buffer_size` bytes, on `flush` and on
+    /// destruction. Pretty printing flags are ignored since a record must fit on one line.
+    /// @code
+    /// ndjson::writer<Event> events("events.jsonl");
+    /// events.write(event);
+    /// @endcode
+    template <typename T>
+    class writer {
+    public:
+        /// Appends to `path`, creating it if needed
+        explicit writer(const std::string &path, yyjson_write_flag flag = YYJSON_WRITE_NOFLAG, size_t buffer_size = 64 * 1024)
+            : writer(detail::file_descriptor(path, O_WRONLY | O_CREAT | O_APPEND, 0644), flag, buffer_size) {}
+
+        /// Writes to `fd`, which is not closed by the writer
+        explicit writer(int fd, yyjson_write_flag flag = YYJSON_WRITE_NOFLAG, size_t buffer_size = 64 * 1024)
+            : writer(detail::file_descriptor(fd, false), flag, buffer_size) {}
+
+        writer(const writer &)            = delete;
+        writer &operator=(const writer &) = delete;
+
+        ~writer() {
+            try {
+                flush();
+            } catch (...) {
+            }
+        }
+
+        void write(const T &val) {
+            // a record that fails to serialize leaves no partial line behind
+            const size_t size = buf.size();
+            try {
+                w.reset(&buf);
+                cppxx::serde::Serialize<Writer, T>{w}.from(val);
+            } catch (...) {
+                buf.resize(size);
+                throw;
+            }
+            buf.push_back('\n');
+
+            if (buf.size() >= buffer_size)
+                flush();
+        }
+
+        /// Writes the buffered lines out
+        void flush() {
+            for (size_t done = 0; done < buf.size();) {
+                const ssize_t n = ::write(fd.get(), buf.data() + done, buf.size() - done);
+                if (n < 0 && errno != EINTR)
+                    throw std::system_error(errno, std::generic_category(), "failed to write");
+                if (n > 0)
+                    done += size_t(n);
+            }
+            buf.clear();
+        }
+
+    protected:
+        // first, so that an opened file is closed when the rest fails to construct
+        detail::file_descriptor fd;
+        size_t                  buffer_size;
+        Writer                  w;
+        std::string             buf;
+
+        writer(detail::file_descriptor fd, yyjson_write_flag flag, size_t buffer_size)
+            : fd(std::move(fd))
+            , buffer_size(buffer_size)
+            , w(nullptr, flag & ~(YYJSON_WRITE_PRETTY | YYJSON_WRITE_PRETTY_TWO_SPACES | YYJSON_WRITE_NEWLINE_AT_END)) {
+            buf.reserve(buffer_size);
+        }
+    };
+} // namespace cppxx::json::yy_json::ndjson
+
+#endif
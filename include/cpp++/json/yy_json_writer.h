@@ -0,0 +1,816 @@
+#ifndef CPPXX_JSON_YYJSON_WRITER_H
+#define CPPXX_JSON_YYJSON_WRITER_H
+
+#include <cpp++/json/json.h>
+#include <cpp++/serde/serialize.h>
+#include <cpp++/serde/enum.h>
+#include <cpp++/serde/error.h>
+#include <cpp++/serde/parallel.h>
+#include <cpp++/time.h>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#if __has_include(<span>)
+#    include <span>
+#endif
+
+#ifndef YYJSON_H
+#    include <yyjson.h>
+#endif
+
+#ifndef BOOST_PFR_HPP
+#    if __has_include(<boost/pfr.hpp>)
+#        include <boost/pfr.hpp>
+#    endif
+#endif
+
+#ifndef NEARGYE_MAGIC_ENUM_HPP
+#    if __has_include(<magic_enum/magic_enum.hpp>)
+#        include <magic_enum/magic_enum.hpp>
+#    endif
+#endif
+
+namespace cppxx::json::yy_json {
+    /// Writes JSON text straight into a string, without building a `yyjson_mut_doc` first.
+    ///
+    /// The output follows the `YYJSON_WRITE_*` flags: pretty printing with 4 or 2 spaces, unicode and slash escaping,
+    /// inf/nan handling, invalid unicode, single precision reals and the newline at the end. Fixed-point reals
+    /// (`YYJSON_WRITE_FP_TO_FIXED`) are not supported and throw. When constructed without an output string, nothing is
+    /// written and only the size of the output is counted.
+    class Writer {
+    public:
+        explicit Writer(std::string *out, yyjson_write_flag flag = YYJSON_WRITE_NOFLAG, const yyjson_alc *alc = nullptr)
+            : out(out)
+            , flag(flag)
+            , indent(flag & YYJSON_WRITE_PRETTY_TWO_SPACES ? 2 : flag & YYJSON_WRITE_PRETTY ? 4 : 0)
+            , alc(alc) {
+#ifdef YYJSON_WRITE_FP_TO_FIXED
+            if (flag & YYJSON_WRITE_FP_TO_FIXED(15))
+                throw serde::error("YYJSON_WRITE_FP_TO_FIXED is not supported by the writer, use yyjson_mut_write");
+#endif
+        }
+
+        /// Number of bytes written so far
+        size_t size() const {
+            return len;
+        }
+
+        /// Starts a new document into `out`, keeping the memory of the previous one
+        void reset(std::string *out) {
+            this->out = out;
+            len       = 0;
+            after_key = false;
+            first.clear();
+        }
+
+        void null() {
+            prefix();
+            put("null", 4);
+        }
+
+        void boolean(bool v) {
+            prefix();
+            v ? put("true", 4) : put("false", 5);
+        }
+
+        void sint(int64_t v) {
+            prefix();
+            put_number(v);
+        }
+
+        void uint(uint64_t v) {
+            prefix();
+            put_number(v);
+        }
+
+        void real(double v) {
+#ifdef YYJSON_WRITE_FP_TO_FIXED
+            // in single precision, the doubles out of its range being infinite
+            if (flag & YYJSON_WRITE_FP_TO_FLOAT) {
+                constexpr float inf = std::numeric_limits<float>::infinity();
+                if (std::isfinite(v) && std::fabs(v) > std::numeric_limits<float>::max())
+                    return write_real(v < 0 ? -inf : inf);
+                return write_real(float(v));
+            }
+#endif
+            write_real(v);
+        }
+
+        void str(std::string_view v) {
+            prefix();
+            put_str(v);
+        }
+
+        /// Writes a parsed JSON value node by node, in the formatting of this writer
+        void value(yyjson_val *val) {
+            switch (yyjson_get_type(val)) {
+            case YYJSON_TYPE_RAW:
+                prefix();
+                return put(yyjson_get_raw(val), yyjson_get_len(val));
+            case YYJSON_TYPE_NULL:
+                return null();
+            case YYJSON_TYPE_BOOL:
+                return boolean(yyjson_get_bool(val));
+            case YYJSON_TYPE_NUM:
+                if (yyjson_is_uint(val))
+                    return uint(yyjson_get_uint(val));
+                if (yyjson_is_sint(val))
+                    return sint(yyjson_get_sint(val));
+                return real(yyjson_get_real(val));
+            case YYJSON_TYPE_STR:
+                return str({yyjson_get_str(val), yyjson_get_len(val)});
+            case YYJSON_TYPE_ARR: {
+                arr_begin();
+                size_t      idx, max;
+                yyjson_val *item;
+                yyjson_arr_foreach(val, idx, max, item) {
+                    value(item);
+                }
+                return arr_end();
+            }
+            case YYJSON_TYPE_OBJ: {
+                obj_begin();
+                size_t      idx, max;
+                yyjson_val *k, *item;
+                yyjson_obj_foreach(val, idx, max, k, item) {
+                    key({yyjson_get_str(k), yyjson_get_len(k)});
+                    value(item);
+                }
+                return obj_end();
+            }
+            default:
+                throw serde::error("invalid JSON value type");
+            }
+        }
+
+        /// Writes `v`, a JSON text, verbatim, used for `noserde` fields. It is not reformatted, and only parsed to be
+        /// validated, see `validate_raw`.
+        void raw(std::string_view v) {
+            if (validate) {
+                yyjson_read_err err;
+                yyjson_doc     *doc = yyjson_read_opts(const_cast<char *>(v.data()), v.size(), 0, alc, &err);
+                if (!doc)
+                    throw serde::error(err.msg);
+                yyjson_doc_free(doc);
+            } else if (v.find_first_not_of(" \t\r\n") == std::string_view::npos)
+                throw serde::error("empty raw JSON value");
+            else if (!balanced(v))
+                throw serde::error("unbalanced raw JSON value");
+
+            prefix();
+            put(v.data(), v.size());
+        }
+
+        /// Whether the raw values are parsed before being written, on by default. Off, a raw value costs a copy and a
+        /// scan that only checks that its brackets and quotes are closed, so that it cannot break the rest of the output.
+        void validate_raw(bool on) {
+            validate = on;
+        }
+
+        void arr_begin() {
+            prefix();
+            put('[');
+            first.push_back(true);
+        }
+
+        void arr_end() {
+            close(']');
+        }
+
+        void obj_begin() {
+            prefix();
+            put('{');
+            first.push_back(true);
+        }
+
+        void key(std::string_view k) {
+            prefix();
+            put_str(k);
+            indent ? put(": ", 2) : put(':');
+            after_key = true;
+        }
+
+        void obj_end() {
+            close('}');
+        }
+
+        /// A writer continuing from the current position into `out`, e.g. to write a slice of the current array on another
+        /// thread. With `after_sibling`, the first value it writes is preceded by a separator.
+        Writer fork(std::string *out, bool after_sibling) const {
+            Writer w(out, flag, alc);
+            w.validate = validate;
+            w.first    = first;
+            if (after_sibling && !w.first.empty())
+                w.first.back() = false;
+            return w;
+        }
+
+        /// Appends the values written by a fork of this writer
+        void splice(std::string_view fragment) {
+            put(fragment.data(), fragment.size());
+            if (!fragment.empty() && !first.empty())
+                first.back() = false;
+        }
+
+        /// Counts the `size` bytes of values counted by a fork of this writer, see `is_counting`
+        void splice(size_t size) {
+            len += size;
+            if (size && !first.empty())
+                first.back() = false;
+        }
+
+        /// True when nothing is written and only the size of the output is counted
+        bool is_counting() const {
+            return out == nullptr;
+        }
+
+        /// Ends the document
+        void end() {
+            if (flag & YYJSON_WRITE_NEWLINE_AT_END)
+                put('\n');
+        }
+
+    protected:
+        std::string            *out;
+        size_t                  len = 0;
+        const yyjson_write_flag flag;
+        const int               indent;
+        const yyjson_alc       *alc;
+        std::vector<bool>       first     = {};
+        bool                    after_key = false;
+        bool                    validate  = true;
+
+        void put(char c) {
+            ++len;
+            if (out)
+                out->push_back(c);
+        }
+
+        void put(const char *s, size_t n) {
+            len += n;
+            if (out)
+                out->append(s, n);
+        }
+
+        void put(size_t n, char c) {
+            len += n;
+            if (out)
+                out->append(n, c);
+        }
+
+        template <typename T>
+        void put_number(T v) {
+            char buf[24];
+            auto [end, _] = std::to_chars(buf, buf + sizeof(buf), v);
+            put(buf, end - buf);
+        }
+
+        /// Writes a real of any value, see `put_real` for the finite ones
+        template <typename T>
+        void write_real(T v) {
+            if (!std::isfinite(v)) {
+                if (flag & YYJSON_WRITE_INF_AND_NAN_AS_NULL)
+                    return null();
+                if (!(flag & YYJSON_WRITE_ALLOW_INF_AND_NAN))
+                    throw serde::error("nan or inf number is not allowed");
+
+                prefix();
+                if (std::isnan(v))
+                    put("NaN", 3);
+                else
+                    v < 0 ? put("-Infinity", 9) : put("Infinity", 8);
+                return;
+            }
+
+            prefix();
+            put_real(v);
+        }
+
+        /// Writes a finite real as yyjson does: the shortest digits reading back as `v`, written in decimal when the
+        /// decimal point is less than 6 places before the first digit and at most 21 after it, with at least one digit
+        /// after the point, and in scientific notation otherwise, e.g. `1.0`, `0.000001`, `1e-7` or `1.5e300`
+        template <typename T>
+        void put_real(T v) {
+            char sci[32];
+            auto [sci_end, _] = std::to_chars(sci, sci + sizeof(sci), v, std::chars_format::scientific);
+
+            // `-d.ddde+XX` split into its sign, digits and exponent
+            const char *p   = sci;
+            const bool  neg = *p == '-';
+            p += neg;
+            char   digits[24];
+            size_t n = 0;
+            for (; *p != 'e'; ++p)
+                if (*p != '.')
+                    digits[n++] = *p;
+            int exp = 0;
+            ++p;
+            std::from_chars(p + (*p == '+'), sci_end, exp);
+
+            char      buf[48];
+            char     *o   = buf;
+            const int dot = exp + 1; // position of the decimal point from the first digit
+            if (neg)
+                *o++ = '-';
+            if (-6 < dot && dot <= 21) {
+                if (dot <= 0) {
+                    o = std::copy_n("0.", 2, o);
+                    o = std::fill_n(o, -dot, '0');
+                    o = std::copy_n(digits, n, o);
+                } else {
+                    for (int i = 0; i < dot; ++i)
+                        *o++ = size_t(i) < n ? digits[i] : '0';
+                    *o++ = '.';
+                    o = size_t(dot) < n ? std::copy(digits + dot, digits + n, o) : (*o = '0', o + 1);
+                }
+            } else {
+                *o++ = digits[0];
+                if (n > 1) {
+                    *o++ = '.';
+                    o    = std::copy(digits + 1, digits + n, o);
+                }
+                *o++ = 'e';
+                o    = std::to_chars(o, buf + sizeof(buf), exp).ptr;
+            }
+            put(buf, o - buf);
+        }
+
+        void newline() {
+            put('\n');
+            put(first.size() * indent, ' ');
+        }
+
+        // separator and indentation before a value or a key
+        void prefix() {
+            if (std::exchange(after_key, false) || first.empty())
+                return;
+            if (!first.back())
+                put(',');
+            first.back() = false;
+            if (indent)
+                newline();
+        }
+
+        // brackets matched and strings closed, in one pass
+        static bool balanced(std::string_view v) {
+            std::string open;
+            bool        in_str = false;
+            for (size_t i = 0; i < v.size(); ++i) {
+                const char c = v[i];
+                if (in_str) {
+                    if (c == '\\')
+                        ++i;
+                    else if (c == '"')
+                        in_str = false;
+                } else if (c == '"')
+                    in_str = true;
+                else if (c == '[' || c == '{')
+                    open.push_back(c == '[' ? ']' : '}');
+                else if (c == ']' || c == '}') {
+                    if (open.empty() || open.back() != c)
+                        return false;
+                    open.pop_back();
+                }
+            }
+            return !in_str && open.empty();
+        }
+
+        void close(char c) {
+            const bool empty = first.back();
+            first.pop_back();
+            if (indent && !empty)
+                newline();
+            put(c);
+        }
+
+        void put_escaped(uint32_t cp) {
+            static constexpr char hex[] = "0123456789ABCDEF";
+
+            char buf[6] = {'\\', 'u', hex[(cp >> 12) & 0xf], hex[(cp >> 8) & 0xf], hex[(cp >> 4) & 0xf], hex[cp & 0xf]};
+            put(buf, sizeof(buf));
+        }
+
+        void put_str(std::string_view v) {
+            const bool escape_unicode = flag & YYJSON_WRITE_ESCAPE_UNICODE;
+            const bool escape_slashes = flag & YYJSON_WRITE_ESCAPE_SLASHES;
+            const bool allow_invalid  = flag & YYJSON_WRITE_ALLOW_INVALID_UNICODE;
+
+            auto p   = reinterpret_cast<const unsigned char *>(v.data());
+            auto end = p + v.size();
+            auto run = p;
+
+            put('"');
+            while (p < end) {
+                const unsigned char c = *p;
+                if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\' && !(c == '/' && escape_slashes)) {
+                    ++p;
+                    continue;
+                }
+
+                put(reinterpret_cast<const char *>(run), p - run);
+                if (c < 0x80) {
+                    switch (c) {
+                    case '"':
+                        put("\\\"", 2);
+                        break;
+                    case '\\':
+                        put("\\\\", 2);
+                        break;
+                    case '/':
+                        put("\\/", 2);
+                        break;
+                    case '\b':
+                        put("\\b", 2);
+                        break;
+                    case '\f':
+                        put("\\f", 2);
+                        break;
+                    case '\n':
+                        put("\\n", 2);
+                        break;
+                    case '\r':
+                        put("\\r", 2);
+                        break;
+                    case '\t':
+                        put("\\t", 2);
+                        break;
+                    default:
+                        put_escaped(c);
+                    }
+                    run = ++p;
+                    continue;
+                }
+
+                // multi-byte UTF-8 sequence
+                const size_t n  = c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : c >= 0xc0 ? 2 : 0;
+                uint32_t     cp = n == 4 ? c & 0x07 : n == 3 ? c & 0x0f : c & 0x1f;
+                bool         ok = n != 0 && size_t(end - p) >= n;
+                for (size_t i = 1; ok && i < n; ++i)
+                    if ((p[i] & 0xc0) == 0x80)
+                        cp = (cp << 6) | (p[i] & 0x3f);
+                    else
+                        ok = false;
+                ok = ok && cp <= 0x10ffff && !(cp >= 0xd800 && cp <= 0xdfff) &&
+                     cp >= (n == 2 ? 0x80u : n == 3 ? 0x800u : 0x10000u);
+
+                if (!ok) {
+                    if (!allow_invalid)
+                        throw serde::error("invalid utf-8 encoding in string");
+                    // copied as is
+                    run = p++;
+                    continue;
+                }
+
+                if (escape_unicode) {
+                    if (cp >= 0x10000) {
+                        cp -= 0x10000;
+                        put_escaped(0xd800 + (cp >> 10));
+                        put_escaped(0xdc00 + (cp & 0x3ff));
+                    } else
+                        put_escaped(cp);
+                    run = p += n;
+                } else {
+                    run = p;
+                    p += n;
+                }
+            }
+            put(reinterpret_cast<const char *>(run), p - run);
+            put('"');
+        }
+    };
+} // namespace cppxx::json::yy_json
+
+
+namespace cppxx::serde {
+    // bool
+    template <>
+    struct Serialize<json::yy_json::Writer, bool> {
+        json::yy_json::Writer &w;
+
+        void from(bool v) const {
+            w.boolean(v);
+        }
+    };
+
+    // sint
+    template <typename T>
+    struct Serialize<
+        json::yy_json::Writer,
+        T,
+        std::enable_if_t<std::is_signed_v<T> && !std::is_same_v<T, bool> && !std::is_floating_point_v<T>>> {
+        json::yy_json::Writer &w;
+
+        void from(T v) const {
+            w.sint(v);
+        }
+    };
+
+    // uint
+    template <typename T>
+    struct Serialize<json::yy_json::Writer, T, std::enable_if_t<std::is_unsigned_v<T> && !std::is_same_v<T, bool>>> {
+        json::yy_json::Writer &w;
+
+        void from(T v) const {
+            w.uint(v);
+        }
+    };
+
+    // float
+    template <typename T>
+    struct Serialize<json::yy_json::Writer, T, std::enable_if_t<std::is_floating_point_v<T>>> {
+        json::yy_json::Writer &w;
+
+        void from(T v) const {
+            w.real(v);
+        }
+    };
+
+    // string
+    template <typename CT>
+    struct Serialize<json::yy_json::Writer, std::basic_string_view<char, CT>> {
+        json::yy_json::Writer &w;
+
+        void from(std::basic_string_view<char, CT> v) const {
+            w.str({v.data(), v.size()});
+        }
+
+        void from_raw(std::basic_string_view<char, CT> v) const {
+            w.raw({v.data(), v.size()});
+        }
+    };
+
+#if __cpp_lib_span >= 202002L
+    template <>
+    struct Serialize<json::yy_json::Writer, std::span<const char>> {
+        json::yy_json::Writer &w;
+
+        void from(std::span<const char> v) const {
+            w.str({v.data(), v.size()});
+        }
+    };
+#endif
+
+    template <typename CT, typename A>
+    struct Serialize<json::yy_json::Writer, std::basic_string<char, CT, A>> {
+        json::yy_json::Writer &w;
+
+        void from(const std::basic_string<char, CT, A> &v) const {
+            w.str({v.data(), v.size()});
+        }
+
+        void from_raw(const std::basic_string<char, CT, A> &v) const {
+            w.raw({v.data(), v.size()});
+        }
+    };
+
+    // optional
+    template <typename T>
+    struct Serialize<json::yy_json::Writer, std::optional<T>> {
+        json::yy_json::Writer &w;
+        bool                   as_int = false; ///< from the `int` option of the field, for an optional enum
+
+        void from(const std::optional<T> &v) const {
+            if (!v.has_value())
+                return w.null();
+            if constexpr (detail::is_named_enum_v<T>)
+                Serialize<json::yy_json::Writer, T>{w, as_int}.from(*v);
+            else
+                Serialize<json::yy_json::Writer, T>{w}.from(*v);
+        }
+    };
+
+    // array
+    template <typename T, size_t N>
+    struct Serialize<json::yy_json::Writer, std::array<T, N>> {
+        json::yy_json::Writer &w;
+
+        void from(const std::array<T, N> &v) const {
+            w.arr_begin();
+            for (size_t i = 0; i < v.size(); ++i)
+                try {
+                    Serialize<json::yy_json::Writer, T>{w}.from(v[i]);
+                } catch (error &e) {
+                    e.add_context(i);
+                    throw;
+                }
+            w.arr_end();
+        }
+    };
+
+    // vector
+    template <typename T, typename A>
+    struct Serialize<json::yy_json::Writer, std::vector<T, A>> {
+        json::yy_json::Writer &w;
+
+        /// Number of threads writing the elements, 0 for one per core. The elements are cut into slices of `min_chunk`
+        /// elements, each written by a thread into its own buffer, and the buffers are joined in order, so the output is
+        /// the same as with one thread.
+        size_t threads = 1;
+
+        static constexpr size_t min_chunk = 256;
+
+        void from(const std::vector<T, A> &v) const {
+            w.arr_begin();
+            from_elements(v, [this](std::string &fragment) { w.splice(fragment); });
+            w.arr_end();
+        }
+
+        /// Writes the elements into the array the writer is in. When written by several threads, the buffer of each
+        /// slice is given to `emit` instead, in order and as soon as it and the slices before it are written, to be
+        /// spliced into the writer or written elsewhere. Only a few slices per thread are written ahead of the one
+        /// waiting for `emit`, so the memory held does not grow with the size of the vector.
+        ///
+        /// When `w` only counts the size of the output, the slices are counted by the threads without being written,
+        /// and `emit` is not called.
+        template <typename F>
+        void from_elements(const std::vector<T, A> &v, F &&emit) const {
+            const size_t workers = threads == 1 ? 1 : parallel_chunk_count(v.size(), threads, min_chunk);
+            if (workers == 1)
+                return write(w, v, 0, v.size());
+
+            // one slice per thread, the counts keeping no buffer to bound
+            if (w.is_counting()) {
+                std::vector<size_t> sizes(workers);
+                parallel_chunks(v.size(), workers, [&](size_t chunk, size_t begin, size_t end) {
+                    json::yy_json::Writer fork = w.fork(nullptr, chunk > 0);
+                    write(fork, v, begin, end);
+                    sizes[chunk] = fork.size();
+                });
+                for (size_t size : sizes)
+                    w.splice(size);
+                return;
+            }
+
+            // `w` is written by `emit` while the slices are, so they fork from a copy of its current state
+            const size_t                chunks = std::max(workers, v.size() / min_chunk);
+            const json::yy_json::Writer start  = w.fork(nullptr, false);
+            std::vector<std::string>    fragments(chunks);
+            parallel_chunks_ordered(
+                v.size(),
+                chunks,
+                workers,
+                2 * workers,
+                [&](size_t chunk, size_t begin, size_t end) {
+                    json::yy_json::Writer fork = start.fork(&fragments[chunk], chunk > 0);
+                    write(fork, v, begin, end);
+                },
+                [&](size_t chunk) {
+                    emit(fragments[chunk]);
+                    std::string().swap(fragments[chunk]);
+                }
+            );
+        }
+
+    protected:
+        static void write(json::yy_json::Writer &w, const std::vector<T, A> &v, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                try {
+                    Serialize<json::yy_json::Writer, T>{w}.from(v[i]);
+                } catch (error &e) {
+                    e.add_context(i);
+                    throw;
+                }
+        }
+    };
+
+    // tuple
+    template <typename... Ts>
+    struct Serialize<json::yy_json::Writer, std::tuple<Ts...>> {
+        json::yy_json::Writer &w;
+
+        void from(const std::tuple<Ts...> &tpl) const {
+            cppxx::json::with_tag_info_tuple(tpl, [&](const TagInfoTuple<sizeof...(Ts)> &ti) {
+                const std::array<TagInfo, sizeof...(Ts)> &ts     = ti.ts;
+                const bool                                is_obj = ti.is_obj;
+
+                is_obj ? w.obj_begin() : w.arr_begin();
+                tuple_for_each(tpl, [&](const auto &item, auto i) {
+                    const TagInfo &t            = ts[i];
+                    const auto    &v            = detail::get_underlying_value(item);
+                    using T                     = std::decay_t<decltype(v)>;
+                    constexpr bool     serializable = is_serializable_v<json::yy_json::Writer, T>;
+                    constexpr TagFlags f            = tag_flags_v<cppxx::json::TagKey, std::tuple<Ts...>, i>;
+
+                    if constexpr (serializable) {
+                        if constexpr (f.unkeyed)
+                            if (is_obj && t.key == "")
+                                return;
+                        if constexpr (f.omitempty)
+                            if (t.omitempty && detail::is_empty_value(v))
+                                return;
+
+                        auto encode = [&] {
+                            if constexpr (f.noserde)
+                                if (t.noserde) {
+                                    if constexpr (std::is_same_v<T, std::string>)
+                                        Serialize<json::yy_json::Writer, std::string>{w}.from_raw(v);
+                                    else
+                                        throw error("field with tag `noserde` can only be serialized from std::string");
+                                    return;
+                                }
+                            detail::check_as_int<T, f.is_static, f.as_int>(t.as_int);
+                            if constexpr (detail::takes_as_int_v<T> && f.as_int)
+                                Serialize<json::yy_json::Writer, T>{w, t.as_int}.from(v);
+                            else
+                                Serialize<json::yy_json::Writer, T>{w}.from(v);
+                        };
+
+                        if (is_obj)
+                            w.key(t.key);
+                        try {
+                            encode();
+                        } catch (error &e) {
+                            if (is_obj)
+                                e.add_context(t.key);
+                            else
+                                e.add_context(i);
+                            throw;
+                        }
+                    }
+                });
+                is_obj ? w.obj_end() : w.arr_end();
+            });
+        }
+    };
+
+    // variant
+    template <typename... T>
+    struct Serialize<json::yy_json::Writer, std::variant<T...>> {
+        json::yy_json::Writer &w;
+
+        void from(const std::variant<T...> &v) const {
+            std::visit(
+                [&](const auto &var) { Serialize<json::yy_json::Writer, std::decay_t<decltype(var)>>{w}.from(var); }, v
+            );
+        }
+    };
+
+    // map
+    template <typename CT, typename CA, typename T, typename H, typename P, typename A>
+    struct Serialize<json::yy_json::Writer, std::unordered_map<std::basic_string<char, CT, CA>, T, H, P, A>> {
+        json::yy_json::Writer &w;
+
+        void from(const std::unordered_map<std::basic_string<char, CT, CA>, T, H, P, A> &v) const {
+            w.obj_begin();
+            for (auto &[k, item] : v) {
+                w.key({k.data(), k.size()});
+                try {
+                    Serialize<json::yy_json::Writer, T>{w}.from(item);
+                } catch (error &e) {
+                    throw e.add_context(k);
+                }
+            }
+            w.obj_end();
+        }
+    };
+
+    // std::tm
+    template <>
+    struct Serialize<json::yy_json::Writer, std::tm> {
+        json::yy_json::Writer &w;
+
+        void from(const std::tm &tm) const {
+            w.str(tm_to_string(tm));
+        }
+    };
+
+#ifdef BOOST_PFR_HPP
+    // aggregate struct
+    template <typename S>
+    struct Serialize<json::yy_json::Writer, S, std::enable_if_t<std::is_aggregate_v<S> && !std::is_same_v<S, std::tm>>> {
+        json::yy_json::Writer &w;
+
+        void from(const S &v) const {
+            auto tpl = boost::pfr::structure_tie(v);
+            Serialize<json::yy_json::Writer, decltype(tpl)>{w}.from(tpl);
+        }
+    };
+#endif
+
+#ifdef NEARGYE_MAGIC_ENUM_HPP
+    // enum
+    template <typename S>
+    struct Serialize<json::yy_json::Writer, S, std::enable_if_t<std::is_enum_v<S>>> {
+        json::yy_json::Writer &w;
+        bool                   as_int = false; ///< from the `int` option of the field
+
+        void from(const S &v) const {
+            if (as_int)
+                return Serialize<json::yy_json::Writer, std::underlying_type_t<S>>{w}.from(std::underlying_type_t<S>(v));
+            w.str(magic_enum::enum_name(v));
+        }
+    };
+#endif
+} // namespace cppxx::serde
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef CPPXX_MMAP_H
+#define CPPXX_MMAP_H
+
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#    define CPPXX_HAS_MMAP 1
+
+#    include <cpp++/defer.h>
+#    include <cerrno>
+#    include <string>
+#    include <system_error>
+#    include <utility>
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+
+namespace cppxx {
+    /// A whole file mapped into memory, with the kernel told that it is read sequentially.
+    ///
+    /// With a `padding`, the mapping is private and writable: writes are copy-on-write and never reach the file, and the
+    /// content is followed by at least `padding` zero bytes, as needed by parsers reading in situ.
+    /// @code
+    /// MappedFile file("data.json");
+    /// std::string_view content(file.data(), file.size());
+    /// @endcode
+    class MappedFile {
+    public:
+        MappedFile() = default;
+
+        explicit MappedFile(const std::string &path, size_t padding = 0) {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                throw_errno("failed to open " + path);
+            auto _ = defer([&]() { ::close(fd); });
+
+            struct stat st;
+            if (::fstat(fd, &st) < 0)
+                throw_errno("failed to stat " + path);
+
+            const size_t page       = size_t(::sysconf(_SC_PAGESIZE));
+            const size_t file_pages = (size_t(st.st_size) + page - 1) / page * page;
+
+            len     = size_t(st.st_size);
+            map_len = padding ? (len + padding + page - 1) / page * page : file_pages;
+            if (map_len == 0)
+                return;
+
+            const int prot = padding ? PROT_READ | PROT_WRITE : PROT_READ;
+            void     *addr;
+            if (map_len > file_pages) {
+                // the padding runs past the last page of the file, reserve zeroed memory and map the file over it
+                addr = ::mmap(nullptr, map_len, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (addr == MAP_FAILED)
+                    throw_errno("failed to map " + path);
+
+                if (len && ::mmap(addr, len, prot, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+                    const int err = errno;
+                    ::munmap(addr, map_len);
+                    errno = err;
+                    throw_errno("failed to map " + path);
+                }
+            } else {
+                addr = ::mmap(nullptr, map_len, prot, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED)
+                    throw_errno("failed to map " + path);
+            }
+
+            ptr = static_cast<char *>(addr);
+            ::madvise(addr, map_len, MADV_SEQUENTIAL);
+        }
+
+        MappedFile(const MappedFile &)            = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept
+            : ptr(std::exchange(other.ptr, nullptr))
+            , len(std::exchange(other.len, 0))
+            , map_len(std::exchange(other.map_len, 0)) {}
+
+        MappedFile &operator=(MappedFile &&other) noexcept {
+            std::swap(ptr, other.ptr);
+            std::swap(len, other.len);
+            std::swap(map_len, other.map_len);
+            return *this;
+        }
+
+        ~MappedFile() {
+            if (ptr)
+                ::munmap(ptr, map_len);
+        }
+
+        /// Content of the file, writable only when mapped with a padding
+        char *data() const {
+            return ptr;
+        }
+
+        /// Size of the file, without the padding
+        size_t size() const {
+            return len;
+        }
+
+        /// Only regular files can be mapped, pipes and character devices such as `/dev/stdin` must be read
+        static bool is_mappable(const std::string &path) {
+            struct stat st;
+            return ::stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+        }
+
+    protected:
+        char  *ptr     = nullptr;
+        size_t len     = 0;
+        size_t map_len = 0;
+
+        [[noreturn]] static void throw_errno(const std::string &what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+    };
+} // namespace cppxx
+
+#endif
+#endif
@@ -5,9 +5,16 @@
 #include <cpp++/serde/serialize.h>
 #include <cpp++/serde/deserialize.h>
 #include <cpp++/serde/error.h>
+#include <cpp++/serde/result.h>
 #include <array>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <optional>
 #include <tuple>
 #include <string>
+#include <utility>
 #include <vector>
 
 #ifndef GOOGLE_PROTOBUF_IO_CODED_STREAM_H__
@@ -33,13 +40,143 @@ namespace cppxx::proto::google_protobuf {
     template <typename From>
     using Serialize = ::cppxx::serde::Serialize<google::protobuf::io::CodedOutputStream, From>;
 
+    template <typename To>
+    using Deserialize = ::cppxx::serde::Deserialize<google::protobuf::io::CodedInputStream, To>;
+
     using Dump = ::cppxx::serde::Dump<google::protobuf::io::CodedOutputStream, std::string>;
 
+    using Parse = ::cppxx::serde::Parse<google::protobuf::io::CodedInputStream, std::string>;
+
     template <typename T>
     [[nodiscard]]
     std::string dump(const T &val);
+
+    template <typename T>
+    [[nodiscard]]
+    serde::result<std::string> try_dump(const T &val);
+
+    template <typename T>
+    void parse(const std::string &buffer, T &val);
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, T> parse(const std::string &buffer);
+
+    template <typename T>
+    [[nodiscard]]
+    serde::result<void> try_parse(const std::string &buffer, T &val);
 } // namespace cppxx::proto::google_protobuf
 
+namespace cppxx::proto::google_protobuf::detail {
+    using WireFormatLite = google::protobuf::internal::WireFormatLite;
+
+    /// Fields that may be missing from a message: optional ones, and repeated ones which have no element
+    template <typename T>
+    struct is_optional_field : std::false_type {};
+
+    template <typename T, typename K>
+    struct is_optional_field<Tag<std::optional<T>, K>> : std::true_type {};
+
+    template <typename T, typename K>
+    struct is_optional_field<Tag<std::vector<T>, K>> : std::bool_constant<!std::is_same_v<T, uint8_t>> {};
+
+    template <typename T>
+    struct is_std_array : std::false_type {};
+
+    template <typename T, size_t N>
+    struct is_std_array<std::array<T, N>> : std::true_type {};
+
+    /// Fields whose occurrences append to each other, and which are cleared on the first one
+    template <typename T>
+    struct is_repeated_field : std::false_type {};
+
+    template <typename T, typename K>
+    struct is_repeated_field<Tag<std::vector<T>, K>> : std::bool_constant<!std::is_same_v<T, uint8_t>> {};
+
+    /// Fields holding an embedded message, optional or not, whose occurrences after the first merge into it
+    template <typename T>
+    struct is_message_field : std::false_type {};
+
+    template <typename S, typename K>
+    struct is_message_field<Tag<S, K>>
+        : std::bool_constant<std::is_aggregate_v<S> && !std::is_same_v<S, std::tm> && !is_std_array<S>::value> {};
+
+    template <typename K, typename... Ts>
+    struct is_message_field<Tag<std::tuple<Ts...>, K>> : std::true_type {};
+
+    template <typename T, typename K>
+    struct is_message_field<Tag<std::optional<T>, K>> : is_message_field<Tag<T>> {};
+
+    inline bool expect_wire_type(uint32_t tag, WireFormatLite::WireType wire_type, serde::error *err) {
+        if (WireFormatLite::GetTagWireType(tag) != wire_type)
+            return serde::detail::fail(
+                err,
+                serde::error(
+                    "mismatch wire type, expect " + std::to_string(int(wire_type)) + " got " +
+                    std::to_string(int(WireFormatLite::GetTagWireType(tag)))
+                )
+            );
+        return true;
+    }
+
+    /// Value of a varint, fixed64 or fixed32 field
+    inline bool read_number(google::protobuf::io::CodedInputStream &doc, uint32_t tag, uint64_t &v64, serde::error *err) {
+        uint32_t v32 = 0;
+        bool     ok  = false;
+        switch (WireFormatLite::GetTagWireType(tag)) {
+        case WireFormatLite::WIRETYPE_VARINT:
+            ok = doc.ReadVarint64(&v64);
+            break;
+        case WireFormatLite::WIRETYPE_FIXED64:
+            ok = doc.ReadLittleEndian64(&v64);
+            break;
+        case WireFormatLite::WIRETYPE_FIXED32:
+            ok  = doc.ReadLittleEndian32(&v32);
+            v64 = v32;
+            break;
+        default:
+            return serde::detail::fail(
+                err,
+                serde::error(
+                    "mismatch wire type, expect a number got " + std::to_string(int(WireFormatLite::GetTagWireType(tag)))
+                )
+            );
+        }
+        if (!ok)
+            return serde::detail::fail(err, serde::error("truncated message"));
+        return true;
+    }
+
+    inline bool read_fixed32(google::protobuf::io::CodedInputStream &doc, uint32_t tag, uint32_t &v, serde::error *err) {
+        if (!expect_wire_type(tag, WireFormatLite::WIRETYPE_FIXED32, err))
+            return false;
+        if (!doc.ReadLittleEndian32(&v))
+            return serde::detail::fail(err, serde::error("truncated message"));
+        return true;
+    }
+
+    inline bool read_fixed64(google::protobuf::io::CodedInputStream &doc, uint32_t tag, uint64_t &v, serde::error *err) {
+        if (!expect_wire_type(tag, WireFormatLite::WIRETYPE_FIXED64, err))
+            return false;
+        if (!doc.ReadLittleEndian64(&v))
+            return serde::detail::fail(err, serde::error("truncated message"));
+        return true;
+    }
+
+    /// Length of a length-delimited field, checked against what is left to read
+    inline bool read_length(google::protobuf::io::CodedInputStream &doc, uint32_t tag, int &length, serde::error *err) {
+        if (!expect_wire_type(tag, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, err))
+            return false;
+        uint32_t n;
+        if (!doc.ReadVarint32(&n))
+            return serde::detail::fail(err, serde::error("truncated message"));
+        if (n > uint32_t(std::numeric_limits<int>::max()))
+            return serde::detail::fail(err, serde::error("length out of range"));
+        length = int(n);
+        return true;
+    }
+} // namespace cppxx::proto::google_protobuf::detail
+
 namespace cppxx::serde {
     template <>
     struct Dump<google::protobuf::io::CodedOutputStream, std::string> {
@@ -51,10 +188,23 @@ namespace cppxx::serde {
 
             google::protobuf::io::ArrayInputStream ais(buffer.data(), (int)buffer.size());
 
-            tuple_for_each(tpl, [&](const auto &v, size_t) {
-                using T = std::decay_t<decltype(v)>;
-                if constexpr (is_serializable_v<google::protobuf::io::CodedOutputStream, T>)
-                    Serialize<google::protobuf::io::CodedOutputStream, T>{doc}.from(v);
+            proto::with_tag_info_tuple(tpl, [&](const TagInfoTuple<sizeof...(Ts)> &ti, const std::array<int, sizeof...(Ts)> &fns) {
+                tuple_for_each(tpl, [&](const auto &item, auto i) {
+                    using T = std::decay_t<decltype(item)>;
+                    if constexpr (is_serializable_v<google::protobuf::io::CodedOutputStream, T>) {
+                        const TagInfo     &t = ti.ts[i];
+                        const auto        &v = detail::get_underlying_value(item);
+                        constexpr TagFlags f = tag_flags_v<proto::TagKey, std::tuple<Ts...>, i>;
+
+                        if constexpr (f.unkeyed)
+                            if (t.key == "")
+                                return;
+                        if constexpr (f.omitempty)
+                            if (t.omitempty && detail::is_empty_value(v))
+                                return;
+                        Serialize<google::protobuf::io::CodedOutputStream, T>{doc}.from(v, fns[i]);
+                    }
+                });
             });
 
             return buffer;
@@ -67,6 +217,12 @@ namespace cppxx::serde {
             return from(tpl);
         }
 #endif
+
+        /// Same as `from`, with the errors caught and returned instead of thrown
+        template <typename T>
+        result<std::string> try_from(const T &val) const {
+            return capture([&]() { return from(val); });
+        }
     };
 
     template <>
@@ -75,118 +231,159 @@ namespace cppxx::serde {
 
         template <typename... Ts>
         void into(std::tuple<Ts...> &tpl) const {
-            google::protobuf::io::ArrayInputStream ais(buffer.data(), (int)buffer.size());
-            google::protobuf::io::CodedInputStream doc(&ais);
-
-            std::array<TagInfo, sizeof...(Ts)>     tis    = {};
-            std::array<int, sizeof...(Ts)>         fns    = {};
-            std::array<std::string, sizeof...(Ts)> raws   = {};
-            std::array<uint32_t, sizeof...(Ts)>    raws32 = {};
-            std::array<uint64_t, sizeof...(Ts)>    raws64 = {};
-
-            tuple_for_each(tpl, [&](const auto &v, size_t i) {
-                using T = std::decay_t<decltype(v)>;
-                if constexpr (is_tagged_v<T>) {
-                    tis[i] = proto::get_tag_info(v);
-                    fns[i] = proto::get_field_number(tis[i]);
-                }
-            });
-
-            auto get_index = [&](int field_number) {
-                size_t i = 0;
-                for (; i < fns.size(); i++)
-                    if (fns[i] == field_number)
-                        break;
-                return i;
-            };
-
-            while (!doc.ConsumedEntireMessage()) {
-                uint32_t tag;
-                if (!doc.ReadVarint32(&tag))
-                    break;
-
-                const uint32_t field_number = tag >> 3;
-                const uint32_t wire_type    = tag & 0x07;
-                const size_t   index        = get_index(field_number);
-
-                std::string &raw   = raws[index];
-                uint32_t    &raw32 = raws32[index];
-                uint64_t    &raw64 = raws64[index];
-
-                switch (wire_type) {
-                case google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT:
-                    doc.ReadVarint64(&raw64);
-                    raw.assign(reinterpret_cast<char *>(&raw64), sizeof(raw64));
-                    break;
-                case google::protobuf::internal::WireFormatLite::WIRETYPE_FIXED64:
-                    doc.ReadLittleEndian64(&raw64);
-                    raw.assign(reinterpret_cast<char *>(&raw64), sizeof(raw64));
-                    break;
-                case google::protobuf::internal::WireFormatLite::WIRETYPE_FIXED32:
-                    doc.ReadLittleEndian32(&raw32);
-                    raw.assign(reinterpret_cast<char *>(&raw32), sizeof(raw32));
-                    break;
-                case google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED:
-                    doc.ReadVarint32(&raw32);
-                    doc.ReadString(&raw, (int)raw32);
-                    break;
-                default:
-                    break;
-                }
-            }
-
-            tuple_for_each(tpl, [&](auto &v, size_t i) {
-                std::string raw = std::move(raws[i]);
-
-                using T = std::decay_t<decltype(v)>;
-                if constexpr (is_deserializable_v<google::protobuf::io::CodedInputStream, T>)
-                    Deserialize<google::protobuf::io::CodedInputStream, T>{raw, raws32[i], raws64[i]}.into(
-                        detail::get_underlying_value(v), tis[i]
-                    );
-            });
+            decode(tpl, nullptr);
         }
 
 #ifdef BOOST_PFR_HPP
         template <typename S>
-        std::enable_if_t<std::is_aggregate_v<S>> into(const S &v) const {
+        std::enable_if_t<std::is_aggregate_v<S>> into(S &v) const {
             auto tpl = boost::pfr::structure_tie(v);
             into(tpl);
         }
 #endif
 
+        /// Same as `into`, with the errors returned instead of thrown. The message is decoded with an error
+        /// out-parameter, see `detail::fail`, so that an invalid message throws nothing.
         template <typename T>
-        static std::pair<T, bool> read_varint(const std::string &raw, const TagInfo &t) {
-            if (t.key.empty())
-                return {0, false};
-            if (raw.empty()) {
-                if (t.skipmissing)
-                    return {0, false};
-                throw error(t.key, "missing field");
-            }
-            T v;
-            if (raw.size() != sizeof(v))
-                throw error(
-                    t.key, "mismatch message size, expect " + std::to_string(sizeof(v)) + " got " + std::to_string(raw.size())
-                );
-            ::memcpy(&v, raw.data(), sizeof(v));
-            return {v, true};
-        }
-
-        static std::pair<uint64_t, bool> read_fixed64(const std::string &raw, const TagInfo &t) {
-            return read_varint<uint64_t>(raw, t);
-        }
-
-        static std::pair<uint32_t, bool> read_fixed32(const std::string &raw, const TagInfo &t) {
-            return read_varint<uint32_t>(raw, t);
+        result<void> try_into(T &val) const {
+            error err("");
+            if (!decode(val, &err))
+                return err;
+            return {};
+        }
+
+        /// Decodes the fields of a message until the end of `doc` or its current limit, in one pass: the number of each
+        /// field is dispatched to the decoder of its field, which decodes the value in place, and the fields of no
+        /// known number are skipped without being copied.
+        ///
+        /// As protobuf does, a repeated field is cleared on its first occurrence and appended to by the next ones, and
+        /// a message field is merged into by its later occurrences. With `merge`, the message itself is merged into
+        /// what an earlier occurrence decoded, so even its first repeated fields are appended to.
+        ///
+        /// The errors are thrown when `err` is null, see `detail::fail`.
+        template <typename... Ts>
+        static bool read(
+            google::protobuf::io::CodedInputStream &doc, std::tuple<Ts...> &tpl, bool merge = false, error *err = nullptr
+        ) {
+            using WireFormatLite = google::protobuf::internal::WireFormatLite;
+
+            return proto::with_field_finder(tpl, [&](const TagInfoTuple<sizeof...(Ts)> &ti, auto find) {
+                std::array<bool, sizeof...(Ts)> seen = {};
+
+                for (uint32_t tag; (tag = doc.ReadTag()) != 0;) {
+                    const size_t i = find(WireFormatLite::GetTagFieldNumber(tag));
+                    if (i == sizeof...(Ts)) {
+                        if (!WireFormatLite::SkipField(&doc, tag))
+                            return detail::fail(err, error("truncated message"));
+                        continue;
+                    }
+
+                    if (!detail::with_context(err, ti.ts[i].key, [&] {
+                            return readers<std::tuple<Ts...>>[i](doc, tpl, tag, merge || seen[i], err);
+                        }))
+                        return false;
+                    seen[i] = true;
+                }
+                if (!doc.ConsumedEntireMessage())
+                    return detail::fail(err, error("invalid tag"));
+
+                // missing fields, which an occurrence merged into an earlier one may leave out
+                if (merge)
+                    return true;
+                bool ok = true;
+                tuple_for_each(tpl, [&](auto &item, auto i) {
+                    using T = std::decay_t<decltype(item)>;
+                    if constexpr (is_deserializable_v<google::protobuf::io::CodedInputStream, T> &&
+                                  !proto::google_protobuf::detail::is_optional_field<T>::value) {
+                        const TagInfo     &t = ti.ts[i];
+                        constexpr TagFlags f = tag_flags_v<proto::TagKey, std::tuple<Ts...>, i>;
+
+                        if constexpr (f.unkeyed)
+                            if (t.key == "")
+                                return;
+                        if constexpr (f.skipmissing)
+                            if (t.skipmissing)
+                                return;
+                        if (ok && !seen[i])
+                            ok = detail::fail(err, error(t.key, "missing field"));
+                    }
+                });
+                return ok;
+            });
         }
+
+        /// Decodes a field holding an embedded message, whose fields are read straight from `doc` within its length,
+        /// see `read` for `merge`
+        template <typename... Ts>
+        static bool read_message(
+            google::protobuf::io::CodedInputStream &doc, uint32_t tag, std::tuple<Ts...> &tpl, bool merge, error *err
+        ) {
+            int length;
+            if (!proto::google_protobuf::detail::read_length(doc, tag, length, err))
+                return false;
+            if (!doc.IncrementRecursionDepth())
+                return detail::fail(err, error("message nested too deep"));
+
+            const auto limit = doc.PushLimit(length);
+            if (!read(doc, tpl, merge, err))
+                return false;
+            doc.PopLimit(limit);
+            doc.DecrementRecursionDepth();
+            return true;
+        }
+
+    protected:
+        template <typename... Ts>
+        bool decode(std::tuple<Ts...> &tpl, error *err) const {
+            google::protobuf::io::CodedInputStream doc(
+                reinterpret_cast<const uint8_t *>(buffer.data()), static_cast<int>(buffer.size())
+            );
+            return read(doc, tpl, false, err);
+        }
+
+#ifdef BOOST_PFR_HPP
+        template <typename S>
+        std::enable_if_t<std::is_aggregate_v<S>, bool> decode(S &v, error *err) const {
+            auto tpl = boost::pfr::structure_tie(v);
+            return decode(tpl, err);
+        }
+#endif
+
+        /// Decodes an occurrence of field `I`, `again` when the field already occurred in the message
+        template <typename Tuple, size_t I>
+        static bool
+        read_field(google::protobuf::io::CodedInputStream &doc, Tuple &tpl, uint32_t tag, bool again, error *err) {
+            using T = std::decay_t<std::tuple_element_t<I, Tuple>>;
+            if constexpr (proto::google_protobuf::detail::is_repeated_field<T>::value) {
+                if (!again)
+                    detail::get_underlying_value(std::get<I>(tpl)).clear();
+                return Deserialize<google::protobuf::io::CodedInputStream, T>{doc, tag}.into(std::get<I>(tpl), err);
+            } else if constexpr (proto::google_protobuf::detail::is_message_field<T>::value)
+                return Deserialize<google::protobuf::io::CodedInputStream, T>{doc, tag, again}.into(std::get<I>(tpl), err);
+            else if constexpr (is_deserializable_v<google::protobuf::io::CodedInputStream, T>)
+                return Deserialize<google::protobuf::io::CodedInputStream, T>{doc, tag}.into(std::get<I>(tpl), err);
+            else if (!google::protobuf::internal::WireFormatLite::SkipField(&doc, tag))
+                return detail::fail(err, error("truncated message"));
+            return true;
+        }
+
+        template <typename Tuple, size_t... I>
+        static constexpr auto make_readers(std::index_sequence<I...>) {
+            using reader = bool (*)(google::protobuf::io::CodedInputStream &, Tuple &, uint32_t, bool, error *);
+            return std::array<reader, sizeof...(I)>{&read_field<Tuple, I>...};
+        }
+
+        /// Decoder of each field by index, the jump table of `read`
+        template <typename Tuple>
+        static constexpr auto readers = make_readers<Tuple>(std::make_index_sequence<std::tuple_size_v<Tuple>>{});
     };
 
     // bool
-    template <>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<bool>> {
+    template <typename K>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<bool, K>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<bool> &v) const {
+        void from(const Tag<bool, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -205,29 +402,30 @@ namespace cppxx::serde {
         }
     };
 
-    template <>
-    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<bool>> {
-        const std::string &raw;
-        uint32_t           raw32 = 0;
-        uint64_t           raw64 = 0;
+    template <typename K>
+    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<bool, K>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
 
-        void into(Tag<bool> &v) const {
-            into(v.get_value(), proto::get_tag_info(v));
+        bool into(Tag<bool, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
         }
 
-        void into(bool &v, const TagInfo &t) const {
-            auto [val, ok] = Parse<google::protobuf::io::CodedInputStream, std::string>::read_fixed64(raw, t);
-            if (ok)
-                v = val;
+        bool into(bool &v, error *err = nullptr) const {
+            uint64_t n;
+            if (!proto::google_protobuf::detail::read_number(doc, tag, n, err))
+                return false;
+            v = n != 0;
+            return true;
         }
     };
 
     // uint32_t
-    template <>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<uint32_t>> {
+    template <typename K>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<uint32_t, K>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<uint32_t> &v) const {
+        void from(const Tag<uint32_t, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -246,33 +444,30 @@ namespace cppxx::serde {
         }
     };
 
-    template <>
-    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<uint32_t>> {
-        std::string raw;
+    template <typename K>
+    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<uint32_t, K>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
 
-        void into(Tag<uint32_t> &v) const {
-            into(v.get_value(), proto::get_tag_info(v));
+        bool into(Tag<uint32_t, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
         }
 
-        void into(uint32_t &v, const TagInfo &t) const {
-            if (raw.size() == sizeof(uint32_t)) {
-                auto [val, ok] = Parse<google::protobuf::io::CodedInputStream, std::string>::read_fixed32(raw, t);
-                if (ok)
-                    v = val;
-            } else {
-                auto [val, ok] = Parse<google::protobuf::io::CodedInputStream, std::string>::read_fixed64(raw, t);
-                if (ok)
-                    v = val;
-            }
+        bool into(uint32_t &v, error *err = nullptr) const {
+            uint64_t n;
+            if (!proto::google_protobuf::detail::read_number(doc, tag, n, err))
+                return false;
+            v = static_cast<uint32_t>(n);
+            return true;
         }
     };
 
     // int32_t
-    template <>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<int32_t>> {
+    template <typename K>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<int32_t, K>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<int32_t> &v) const {
+        void from(const Tag<int32_t, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -285,33 +480,30 @@ namespace cppxx::serde {
         }
     };
 
-    template <>
-    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<int32_t>> {
-        std::string raw;
+    template <typename K>
+    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<int32_t, K>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
 
-        void into(Tag<int32_t> &v) const {
-            into(v.get_value(), proto::get_tag_info(v));
+        bool into(Tag<int32_t, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
         }
 
-        void into(int32_t &v, const TagInfo &t) const {
-            if (raw.size() == sizeof(int32_t)) {
-                auto [val, ok] = Parse<google::protobuf::io::CodedInputStream, std::string>::read_fixed32(raw, t);
-                if (ok)
-                    v = static_cast<int32_t>(val);
-            } else {
-                auto [val, ok] = Parse<google::protobuf::io::CodedInputStream, std::string>::read_fixed64(raw, t);
-                if (ok)
-                    v = static_cast<int32_t>(val);
-            }
+        bool into(int32_t &v, error *err = nullptr) const {
+            uint64_t n;
+            if (!proto::google_protobuf::detail::read_number(doc, tag, n, err))
+                return false;
+            v = static_cast<int32_t>(n);
+            return true;
         }
     };
 
     // uint64_t
-    template <>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<uint64_t>> {
+    template <typename K>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<uint64_t, K>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<uint64_t> &v) const {
+        void from(const Tag<uint64_t, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -330,27 +522,30 @@ namespace cppxx::serde {
         }
     };
 
-    template <>
-    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<uint64_t>> {
-        std::string raw;
+    template <typename K>
+    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<uint64_t, K>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
 
-        void into(Tag<uint64_t> &v) const {
-            into(v.get_value(), proto::get_tag_info(v));
+        bool into(Tag<uint64_t, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
         }
 
-        void into(uint64_t &v, const TagInfo &t) const {
-            auto [val, ok] = Parse<google::protobuf::io::CodedInputStream, std::string>::read_fixed64(raw, t);
-            if (ok)
-                v = val;
+        bool into(uint64_t &v, error *err = nullptr) const {
+            uint64_t n;
+            if (!proto::google_protobuf::detail::read_number(doc, tag, n, err))
+                return false;
+            v = static_cast<uint64_t>(n);
+            return true;
         }
     };
 
     // int64_t
-    template <>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<int64_t>> {
+    template <typename K>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<int64_t, K>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<int64_t> &v) const {
+        void from(const Tag<int64_t, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -363,27 +558,30 @@ namespace cppxx::serde {
         }
     };
 
-    template <>
-    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<int64_t>> {
-        std::string raw;
+    template <typename K>
+    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<int64_t, K>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
 
-        void into(Tag<int64_t> &v) const {
-            into(v.get_value(), proto::get_tag_info(v));
+        bool into(Tag<int64_t, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
         }
 
-        void into(int64_t &v, const TagInfo &t) const {
-            auto [val, ok] = Parse<google::protobuf::io::CodedInputStream, std::string>::read_fixed64(raw, t);
-            if (ok)
-                v = static_cast<int64_t>(val);
+        bool into(int64_t &v, error *err = nullptr) const {
+            uint64_t n;
+            if (!proto::google_protobuf::detail::read_number(doc, tag, n, err))
+                return false;
+            v = static_cast<int64_t>(n);
+            return true;
         }
     };
 
     // enum
-    template <typename T>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<T>, std::enable_if_t<std::is_enum_v<T>>> {
+    template <typename T, typename K>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<T, K>, std::enable_if_t<std::is_enum_v<T>>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<T> &v) const {
+        void from(const Tag<T, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -396,27 +594,30 @@ namespace cppxx::serde {
         }
     };
 
-    template <typename T>
-    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<T>, std::enable_if_t<std::is_enum_v<T>>> {
-        const std::string &raw;
+    template <typename T, typename K>
+    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<T, K>, std::enable_if_t<std::is_enum_v<T>>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
 
-        void into(Tag<T> &v) const {
-            into(v.get_value(), proto::get_tag_info(v));
+        bool into(Tag<T, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
         }
 
-        void into(T &v, const TagInfo &t) const {
-            int32_t i;
-            Deserialize<google::protobuf::io::CodedInputStream, Tag<int32_t>>{raw}.into(i, t);
-            v = static_cast<T>(i);
+        bool into(T &v, error *err = nullptr) const {
+            uint64_t n;
+            if (!proto::google_protobuf::detail::read_number(doc, tag, n, err))
+                return false;
+            v = static_cast<T>(n);
+            return true;
         }
     };
 
     // float
-    template <>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<float>> {
+    template <typename K>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<float, K>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<float> &v) const {
+        void from(const Tag<float, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -438,12 +639,31 @@ namespace cppxx::serde {
         }
     };
 
+    template <typename K>
+    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<float, K>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
+
+        bool into(Tag<float, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
+        }
+
+        bool into(float &v, error *err = nullptr) const {
+            uint32_t bits;
+            if (!proto::google_protobuf::detail::read_fixed32(doc, tag, bits, err))
+                return false;
+            static_assert(sizeof(bits) == sizeof(v));
+            std::memcpy(&v, &bits, sizeof(v));
+            return true;
+        }
+    };
+
     // double
-    template <>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<double>> {
+    template <typename K>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<double, K>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<double> &v) const {
+        void from(const Tag<double, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -455,7 +675,7 @@ namespace cppxx::serde {
         void from(double v, int field_number) const {
             doc.WriteTag(
                 google::protobuf::internal::WireFormatLite::MakeTag(
-                    field_number, google::protobuf::internal::WireFormatLite::WIRETYPE_FIXED32
+                    field_number, google::protobuf::internal::WireFormatLite::WIRETYPE_FIXED64
                 )
             );
             uint64_t bits;
@@ -465,12 +685,31 @@ namespace cppxx::serde {
         }
     };
 
+    template <typename K>
+    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<double, K>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
+
+        bool into(Tag<double, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
+        }
+
+        bool into(double &v, error *err = nullptr) const {
+            uint64_t bits;
+            if (!proto::google_protobuf::detail::read_fixed64(doc, tag, bits, err))
+                return false;
+            static_assert(sizeof(bits) == sizeof(v));
+            std::memcpy(&v, &bits, sizeof(v));
+            return true;
+        }
+    };
+
     // string
-    template <>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<std::string>> {
+    template <typename K>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<std::string, K>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<std::string> &v) const {
+        void from(const Tag<std::string, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -490,12 +729,31 @@ namespace cppxx::serde {
         }
     };
 
+    template <typename K>
+    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<std::string, K>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
+
+        bool into(Tag<std::string, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
+        }
+
+        bool into(std::string &v, error *err = nullptr) const {
+            int length;
+            if (!proto::google_protobuf::detail::read_length(doc, tag, length, err))
+                return false;
+            if (!doc.ReadString(&v, length))
+                return detail::fail(err, error("truncated message"));
+            return true;
+        }
+    };
+
     // bytes
-    template <>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<std::vector<uint8_t>>> {
+    template <typename K>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<std::vector<uint8_t>, K>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<std::vector<uint8_t>> &v) const {
+        void from(const Tag<std::vector<uint8_t>, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -515,12 +773,34 @@ namespace cppxx::serde {
         }
     };
 
+    template <typename K>
+    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<std::vector<uint8_t>, K>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
+
+        bool into(Tag<std::vector<uint8_t>, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
+        }
+
+        bool into(std::vector<uint8_t> &v, error *err = nullptr) const {
+            int length;
+            if (!proto::google_protobuf::detail::read_length(doc, tag, length, err))
+                return false;
+            if (doc.BytesUntilLimit() >= 0 && length > doc.BytesUntilLimit())
+                return detail::fail(err, error("truncated message"));
+            v.resize(size_t(length));
+            if (!doc.ReadRaw(v.data(), length))
+                return detail::fail(err, error("truncated message"));
+            return true;
+        }
+    };
+
     // optional
-    template <typename T>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<std::optional<T>>> {
+    template <typename T, typename K>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<std::optional<T>, K>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<std::optional<T>> &v) const {
+        void from(const Tag<std::optional<T>, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -535,15 +815,36 @@ namespace cppxx::serde {
         }
     };
 
+    template <typename T, typename K>
+    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<std::optional<T>, K>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
+        bool                                    merge = false; ///< into the message of an earlier occurrence
+
+        bool into(Tag<std::optional<T>, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
+        }
+
+        bool into(std::optional<T> &v, error *err = nullptr) const {
+            const bool merging = merge && v.has_value();
+            if (!merging)
+                v.emplace();
+            if constexpr (proto::google_protobuf::detail::is_message_field<Tag<T>>::value)
+                return Deserialize<google::protobuf::io::CodedInputStream, Tag<T>>{doc, tag, merging}.into(*v, err);
+            else
+                return Deserialize<google::protobuf::io::CodedInputStream, Tag<T>>{doc, tag}.into(*v, err);
+        }
+    };
+
     // repeated
-    template <typename T, size_t N>
+    template <typename T, size_t N, typename K>
     struct Serialize<
         google::protobuf::io::CodedOutputStream,
-        Tag<std::array<T, N>>,
+        Tag<std::array<T, N>, K>,
         std::enable_if_t<!std::is_same_v<T, uint8_t>>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<std::array<T, N>> &v) const {
+        void from(const Tag<std::array<T, N>, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -558,14 +859,14 @@ namespace cppxx::serde {
         }
     };
 
-    template <typename T>
+    template <typename T, typename K>
     struct Serialize<
         google::protobuf::io::CodedOutputStream,
-        Tag<std::vector<T>>,
+        Tag<std::vector<T>, K>,
         std::enable_if_t<!std::is_same_v<T, uint8_t>>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<std::vector<T>> &v) const {
+        void from(const Tag<std::vector<T>, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -580,12 +881,52 @@ namespace cppxx::serde {
         }
     };
 
+    template <typename T, typename K>
+    struct Deserialize<
+        google::protobuf::io::CodedInputStream,
+        Tag<std::vector<T>, K>,
+        std::enable_if_t<!std::is_same_v<T, uint8_t>>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
+
+        bool into(Tag<std::vector<T>, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
+        }
+
+        /// One element per field, or all of them in one length-delimited field when packed
+        bool into(std::vector<T> &v, error *err = nullptr) const {
+            using WireFormatLite = google::protobuf::internal::WireFormatLite;
+
+            if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+                if (WireFormatLite::GetTagWireType(tag) == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+                    const uint32_t element = WireFormatLite::MakeTag(
+                        WireFormatLite::GetTagFieldNumber(tag),
+                        std::is_same_v<T, float>    ? WireFormatLite::WIRETYPE_FIXED32
+                        : std::is_same_v<T, double> ? WireFormatLite::WIRETYPE_FIXED64
+                                                    : WireFormatLite::WIRETYPE_VARINT
+                    );
+
+                    int length;
+                    if (!proto::google_protobuf::detail::read_length(doc, tag, length, err))
+                        return false;
+                    const auto limit = doc.PushLimit(length);
+                    while (doc.BytesUntilLimit() > 0)
+                        if (!Deserialize<google::protobuf::io::CodedInputStream, Tag<T>>{doc, element}.into(v.emplace_back(), err))
+                            return false;
+                    doc.PopLimit(limit);
+                    return true;
+                }
+
+            return Deserialize<google::protobuf::io::CodedInputStream, Tag<T>>{doc, tag}.into(v.emplace_back(), err);
+        }
+    };
+
     // message
-    template <typename... Ts>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<std::tuple<Ts...>>> {
+    template <typename K, typename... Ts>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<std::tuple<Ts...>, K>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<std::tuple<Ts...>> &v) const {
+        void from(const Tag<std::tuple<Ts...>, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -600,12 +941,27 @@ namespace cppxx::serde {
         }
     };
 
+    template <typename K, typename... Ts>
+    struct Deserialize<google::protobuf::io::CodedInputStream, Tag<std::tuple<Ts...>, K>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
+        bool                                    merge = false; ///< into what an earlier occurrence decoded
+
+        bool into(Tag<std::tuple<Ts...>, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
+        }
+
+        bool into(std::tuple<Ts...> &v, error *err = nullptr) const {
+            return Parse<google::protobuf::io::CodedInputStream, std::string>::read_message(doc, tag, v, merge, err);
+        }
+    };
+
 #ifdef BOOST_PFR_HPP
-    template <typename S>
-    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<S>, std::enable_if_t<std::is_aggregate_v<S>>> {
+    template <typename S, typename K>
+    struct Serialize<google::protobuf::io::CodedOutputStream, Tag<S, K>, std::enable_if_t<std::is_aggregate_v<S>>> {
         google::protobuf::io::CodedOutputStream &doc;
 
-        void from(const Tag<S> &v) const {
+        void from(const Tag<S, K> &v) const {
             from(v.get_value(), proto::get_tag_info(v));
         }
 
@@ -619,6 +975,26 @@ namespace cppxx::serde {
             Serialize<google::protobuf::io::CodedOutputStream, Tag<std::string>>{doc}.from(buffer, field_number);
         }
     };
+
+    template <typename S, typename K>
+    struct Deserialize<
+        google::protobuf::io::CodedInputStream,
+        Tag<S, K>,
+        std::enable_if_t<
+            std::is_aggregate_v<S> && !std::is_same_v<S, std::tm> && !proto::google_protobuf::detail::is_std_array<S>::value>> {
+        google::protobuf::io::CodedInputStream &doc;
+        uint32_t                                tag;
+        bool                                    merge = false; ///< into what an earlier occurrence decoded
+
+        bool into(Tag<S, K> &v, error *err = nullptr) const {
+            return into(v.get_value(), err);
+        }
+
+        bool into(S &v, error *err = nullptr) const {
+            auto tpl = boost::pfr::structure_tie(v);
+            return Parse<google::protobuf::io::CodedInputStream, std::string>::read_message(doc, tag, tpl, merge, err);
+        }
+    };
 #endif
 } // namespace cppxx::serde
 
@@ -628,5 +1004,30 @@ namespace cppxx::proto::google_protobuf {
     std::string dump(const T &val) {
         return Dump{}.from(val);
     }
+
+    template <typename T>
+    [[nodiscard]]
+    serde::result<std::string> try_dump(const T &val) {
+        return Dump{}.try_from(val);
+    }
+
+    template <typename T>
+    void parse(const std::string &buffer, T &val) {
+        Parse{buffer}.into(val);
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, T> parse(const std::string &buffer) {
+        T val = {};
+        Parse{buffer}.into(val);
+        return val;
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    serde::result<void> try_parse(const std::string &buffer, T &val) {
+        return Parse{buffer}.try_into(val);
+    }
 } // namespace cppxx::proto::google_protobuf
 #endif
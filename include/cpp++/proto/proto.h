@@ -3,8 +3,11 @@
 
 #include <cpp++/serde/tag_info.h>
 #include <array>
+#include <cstdint>
 
 namespace cppxx::proto {
+    using TagKey = tag_string<'p', 'r', 'o', 't', 'o'>;
+
     template <typename T>
     constexpr serde::TagInfo get_tag_info(const T &field) {
         return serde::get_tag_info(field, "proto");
@@ -41,6 +44,84 @@ namespace cppxx::proto {
         return ret;
     }
 
+    template <size_t N>
+    constexpr std::array<int, N> get_field_numbers(const serde::TagInfoTuple<N> &ti) {
+        std::array<int, N> ret = {};
+        for (size_t i = 0; i < N; ++i)
+            ret[i] = get_field_number(ti.ts[i]);
+        return ret;
+    }
+
+    /// Compile-time field numbers of a tuple with static tags
+    template <typename Tuple>
+    inline constexpr std::array<int, std::tuple_size_v<Tuple>> static_field_numbers_v =
+        get_field_numbers(serde::static_tag_info_tuple_v<TagKey, Tuple>);
+
+    /// Index of the field numbered `field_number` in `fns`, `N` when there is none
+    template <size_t N>
+    constexpr size_t find_field(const std::array<int, N> &fns, uint32_t field_number) {
+        for (size_t i = 0; i < N; ++i)
+            if (fns[i] > 0 && uint32_t(fns[i]) == field_number)
+                return i;
+        return N;
+    }
+
+    /// Largest field number looked up in a table, see `static_field_table_v`
+    inline constexpr int max_table_field_number = 1024;
+
+    template <typename Tuple>
+    constexpr size_t static_field_table_size() {
+        int max = 0;
+        for (int n : static_field_numbers_v<Tuple>)
+            max = n > max ? n : max;
+        return max <= max_table_field_number ? size_t(max) + 1 : 0;
+    }
+
+    template <typename Tuple>
+    constexpr std::array<uint16_t, static_field_table_size<Tuple>()> make_static_field_table() {
+        static_assert(std::tuple_size_v<Tuple> < 0xffff, "too many fields");
+
+        std::array<uint16_t, static_field_table_size<Tuple>()> table = {};
+        for (size_t n = 0; n < table.size(); ++n)
+            table[n] = uint16_t(find_field(static_field_numbers_v<Tuple>, uint32_t(n)));
+        return table;
+    }
+
+    /// Index of the field of each field number of a tuple with static tags, the tuple size for the numbers of no field.
+    /// Empty when a field number is larger than `max_table_field_number`.
+    template <typename Tuple>
+    inline constexpr auto static_field_table_v = make_static_field_table<Tuple>();
+
+    /// Calls `fn(tag_infos, find)` for `tpl`, where `find(field_number)` is the index of the field of that number or the
+    /// tuple size. With static tags, `find` is a single lookup in a table built at compile time.
+    template <typename... Ts, typename F>
+    decltype(auto) with_field_finder(const std::tuple<Ts...> &tpl, F &&fn) {
+        using Tuple = std::tuple<Ts...>;
+        if constexpr (serde::has_static_tags_v<Tuple>) {
+            return fn(serde::static_tag_info_tuple_v<TagKey, Tuple>, [](uint32_t field_number) -> size_t {
+                constexpr auto &table = static_field_table_v<Tuple>;
+                if constexpr (table.size() > 0)
+                    return field_number < table.size() ? table[field_number] : sizeof...(Ts);
+                else
+                    return find_field(static_field_numbers_v<Tuple>, field_number);
+            });
+        } else {
+            const serde::TagInfoTuple<sizeof...(Ts)> ti  = serde::get_tag_info_from_tuple(tpl, "proto");
+            const std::array<int, sizeof...(Ts)>     fns = get_field_numbers(ti);
+            return fn(ti, [&fns](uint32_t field_number) { return find_field(fns, field_number); });
+        }
+    }
+
+    /// Calls `fn(tag_infos, field_numbers)` for `tpl`, both being compile-time constants when the tuple has static tags
+    template <typename... Ts, typename F>
+    decltype(auto) with_tag_info_tuple(const std::tuple<Ts...> &tpl, F &&fn) {
+        if constexpr (serde::has_static_tags_v<std::tuple<Ts...>>)
+            return fn(serde::static_tag_info_tuple_v<TagKey, std::tuple<Ts...>>, static_field_numbers_v<std::tuple<Ts...>>);
+        else {
+            const serde::TagInfoTuple<sizeof...(Ts)> ti = serde::get_tag_info_from_tuple(tpl, "proto");
+            return fn(ti, get_field_numbers(ti));
+        }
+    }
 } // namespace cppxx::proto
 
 #endif
@@ -4,6 +4,8 @@
 #include <type_traits>
 
 namespace cppxx::serde {
+    /// Decodes a node of `Deserializer` with `bool into(To &v, error *err = nullptr)`, which throws its error when `err` is
+    /// null and returns false with the error in `*err` otherwise, see `detail::fail`
     template <typename Deserializer, typename To, typename Enable = void>
     struct Deserialize;
 
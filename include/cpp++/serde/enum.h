@@ -0,0 +1,91 @@
+#ifndef CPPXX_SERDE_ENUM_H
+#define CPPXX_SERDE_ENUM_H
+
+#include <cpp++/serde/error.h>
+#include <cpp++/serde/key_map.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#ifndef NEARGYE_MAGIC_ENUM_HPP
+#    if __has_include(<magic_enum/magic_enum.hpp>)
+#        include <magic_enum/magic_enum.hpp>
+#    endif
+#endif
+
+namespace cppxx::serde::detail {
+    /// True for the enums that are serialized by name, or by value with the `int` option
+#ifdef NEARGYE_MAGIC_ENUM_HPP
+    template <typename T>
+    inline constexpr bool is_named_enum_v = std::is_enum_v<T>;
+#else
+    template <typename T>
+    inline constexpr bool is_named_enum_v = false;
+#endif
+
+    /// True for the types the `int` option applies to: the enums of `is_named_enum_v`, and optional ones, the option
+    /// applying to the value inside
+    template <typename T>
+    struct takes_as_int : std::bool_constant<is_named_enum_v<T>> {};
+
+    template <typename T>
+    struct takes_as_int<std::optional<T>> : std::bool_constant<is_named_enum_v<T>> {};
+
+    template <typename T>
+    inline constexpr bool takes_as_int_v = takes_as_int<T>::value;
+
+    /// Rejects the `int` option on a field of type `T` that is not an enum, see `takes_as_int_v`. `is_static` and
+    /// `may_be_int` are the `TagFlags` of the field, so that a static tag with `int` on such a field does not compile.
+    template <typename T, bool is_static = false, bool may_be_int = true>
+    bool check_as_int(bool as_int, error *err = nullptr) {
+        if constexpr (!takes_as_int_v<T> && may_be_int) {
+            static_assert(!is_static, "field with tag `int` must be an enum");
+            if (as_int)
+                return fail(err, error("field with tag `int` must be an enum"));
+        }
+        return true;
+    }
+} // namespace cppxx::serde::detail
+
+#ifdef NEARGYE_MAGIC_ENUM_HPP
+namespace cppxx::serde {
+    /// Compile-time map of the names of the enum `E` to their index in `magic_enum::enum_values<E>()`
+    template <typename E>
+    inline constexpr KeyMap<magic_enum::enum_count<E>()> enum_name_map_v =
+        KeyMap<magic_enum::enum_count<E>()>(magic_enum::enum_names<E>(), 1024);
+} // namespace cppxx::serde
+
+namespace cppxx::serde::detail {
+    /// Sets `v` to the value of `E` named `name`, compared against the names in place so that nothing is allocated unless
+    /// it fails, see `fail`
+    template <typename E>
+    bool enum_from_name(std::string_view name, E &v, error *err = nullptr) {
+        const size_t i = enum_name_map_v<E>.find(name);
+        if (i != enum_name_map_v<E>.npos) {
+            v = magic_enum::enum_values<E>()[i];
+            return true;
+        }
+
+        std::string what = "invalid value `" + std::string(name) + "`, expected one of {";
+        for (std::string_view name : magic_enum::enum_names<E>())
+            (what += name) += ',';
+        what += "}";
+        return fail(err, error(std::move(what)));
+    }
+
+    /// Sets `v` to the value of `E` whose underlying value is `n`, for fields tagged with `int`
+    template <typename E>
+    bool enum_from_int(std::underlying_type_t<E> n, E &v, error *err = nullptr) {
+        if (auto e = magic_enum::enum_cast<E>(n)) {
+            v = *e;
+            return true;
+        }
+        return fail(
+            err, error("invalid value `" + std::to_string(n) + "` for " + std::string(magic_enum::enum_type_name<E>()))
+        );
+    }
+} // namespace cppxx::serde::detail
+#endif
+
+#endif
@@ -2,51 +2,135 @@
 #define CPPXX_SERDE_ERROR_H
 
 #include <exception>
+#include <ostream>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace cppxx::serde {
+    /// Location of an error in a document, e.g. `.people[3].name`.
+    ///
+    /// Kept as a stack of key and index segments that grows from the innermost one as the error goes up, and only
+    /// rendered to a string when asked for, so reporting an error costs the same at any depth. The characters of the
+    /// keys share one buffer, so adding a segment allocates only while the buffers grow.
+    class path {
+    public:
+        path() = default;
+
+        /// Adds the segment the current location is in
+        void push_front(std::string_view key) {
+            reserve();
+            segments.push_back({keys.size(), key.size(), false});
+            keys.append(key);
+        }
+
+        void push_front(size_t index) {
+            reserve();
+            segments.push_back({0, index, true});
+        }
+
+        bool empty() const {
+            return segments.empty();
+        }
+
+        std::string str() const {
+            std::string res;
+            for (auto it = segments.rbegin(); it != segments.rend(); ++it)
+                if (it->is_index)
+                    res.append("[").append(std::to_string(it->value)).append("]");
+                else
+                    res.append(".").append(keys, it->offset, it->value);
+            return res;
+        }
+
+        operator std::string() const {
+            return str();
+        }
+
+        friend bool operator==(const path &a, std::string_view b) {
+            return a.str() == b;
+        }
+
+        friend bool operator==(std::string_view a, const path &b) {
+            return b == a;
+        }
+
+        friend bool operator!=(const path &a, std::string_view b) {
+            return !(a == b);
+        }
+
+        friend bool operator!=(std::string_view a, const path &b) {
+            return !(b == a);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os, const path &p) {
+            return os << p.str();
+        }
+
+    protected:
+        struct segment {
+            size_t offset;   ///< of the key in `keys`
+            size_t value;    ///< size of the key, or the index
+            bool   is_index;
+        };
+
+        void reserve() {
+            if (segments.capacity() == 0) {
+                segments.reserve(8);
+                keys.reserve(64);
+            }
+        }
+
+        // innermost first
+        std::vector<segment> segments;
+        std::string          keys;
+    };
+
     class error : public std::exception {
     protected:
         mutable std::string what_;
 
     public:
-        std::string context;
+        serde::path context;
         std::string msg;
+        std::string expected_type; ///< of a type mismatch, see `type_mismatch_error`, empty for the other errors
 
         explicit error(std::string msg)
             : msg(std::move(msg)) {}
 
         error(std::string_view key, std::string msg)
-            : context("." + std::string(key))
-            , msg(std::move(msg)) {}
+            : msg(std::move(msg)) {
+            context.push_front(key);
+        }
 
         error(size_t key, std::string msg)
-            : context("[" + std::to_string(key) + "]")
-            , msg(std::move(msg)) {}
+            : msg(std::move(msg)) {
+            context.push_front(key);
+        }
 
         error &add_context(std::string_view key) & {
-            context = "." + std::string(key) + std::move(context);
+            context.push_front(key);
             return *this;
         }
 
         error &add_context(size_t key) & {
-            context = "[" + std::to_string(key) + "]" + std::move(context);
+            context.push_front(key);
             return *this;
         }
 
         const char *what() const noexcept override {
-            what_ = "Error at " + (context.empty() ? "<root>" : context) + ": " + msg;
+            what_ = "Error at " + (context.empty() ? "<root>" : context.str()) + ": " + msg;
             return what_.c_str();
         }
     };
 
     class type_mismatch_error : public error {
     public:
-        std::string expected_type;
-
         type_mismatch_error(const std::string &expected_type, const std::string &got)
-            : error("Type mismatch error: expect `" + expected_type + "` got `" + got + "`")
-            , expected_type(expected_type) {}
+            : error("Type mismatch error: expect `" + expected_type + "` got `" + got + "`") {
+            this->expected_type = expected_type;
+        }
     };
 
     class size_mismatch_error : public error {
@@ -56,4 +140,33 @@ namespace cppxx::serde {
     };
 } // namespace cppxx::serde
 
+namespace cppxx::serde::detail {
+    /// Reports the error `e` of an `into(v, err)`, which returns the result: `e` is thrown when `err` is null, for the
+    /// throwing entry points, and stored in `*err` otherwise, for the `try_*` ones, so that they decode without throwing
+    template <typename E>
+    bool fail(error *err, E &&e) {
+        if (!err)
+            throw std::forward<E>(e);
+        *err = std::forward<E>(e);
+        return false;
+    }
+
+    /// Runs `fn`, the `into` of the value at `key`, adding `key` to the path of its error as it goes up
+    template <typename K, typename F>
+    bool with_context(error *err, const K &key, F &&fn) {
+        if (err) {
+            if (fn())
+                return true;
+            err->add_context(key);
+            return false;
+        }
+        try {
+            return fn();
+        } catch (error &e) {
+            e.add_context(key);
+            throw;
+        }
+    }
+} // namespace cppxx::serde::detail
+
 #endif
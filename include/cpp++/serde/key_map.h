@@ -0,0 +1,122 @@
+#ifndef CPPXX_SERDE_KEY_MAP_H
+#define CPPXX_SERDE_KEY_MAP_H
+
+#include <cpp++/serde/tag_info.h>
+#include <array>
+#include <cstdint>
+
+namespace cppxx::serde {
+    /// Maps the keys of a `TagInfoTuple` to their field index.
+    ///
+    /// When built at compile time (see `static_key_map_v`), a seed is searched so that the keys hash without collision,
+    /// and `find` costs one hash and one key comparison. If no such seed is found, or when built at runtime, collisions
+    /// are resolved by linear probing.
+    template <size_t N>
+    class KeyMap {
+    public:
+        static constexpr size_t npos = N;
+
+        constexpr KeyMap() = default;
+
+        constexpr explicit KeyMap(const TagInfoTuple<N> &ti, uint32_t max_seeds = 0) {
+            for (size_t i = 0; i < N; ++i)
+                keys[i] = ti.ts[i].key;
+            init(max_seeds);
+        }
+
+        /// Maps each of `names` to its index, e.g. the names of an enum
+        constexpr explicit KeyMap(const std::array<std::string_view, N> &names, uint32_t max_seeds = 0)
+            : keys(names) {
+            init(max_seeds);
+        }
+
+        /// Index of the field whose key is `key`, `npos` if none
+        constexpr size_t find(std::string_view key) const {
+            for (size_t slot = hash(key, seed) & mask;; slot = (slot + 1) & mask) {
+                const size_t i = table[slot];
+                if (i == 0)
+                    return npos;
+                if (keys[i - 1] == key)
+                    return i - 1;
+                if (perfect)
+                    return npos;
+            }
+        }
+
+    protected:
+        // power of two with a load factor of at most 1/4
+        static constexpr size_t capacity = [] {
+            size_t n = 4;
+            while (n < N * 4)
+                n <<= 1;
+            return n;
+        }();
+        static constexpr size_t mask = capacity - 1;
+
+        using index_type = std::conditional_t<(N < 0xff), uint8_t, uint16_t>;
+
+        std::array<std::string_view, N>  keys    = {};
+        std::array<index_type, capacity> table   = {};
+        uint32_t                         seed    = 0;
+        bool                             perfect = false;
+
+        static constexpr uint32_t hash(std::string_view key, uint32_t seed) {
+            // FNV-1a
+            uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+            for (char c : key)
+                h = (h ^ uint8_t(c)) * 16777619u;
+            return h ^ (h >> 15);
+        }
+
+        constexpr void init(uint32_t max_seeds) {
+            for (uint32_t s = 0; s < max_seeds && !perfect; ++s)
+                perfect = build(s, true);
+
+            if (!perfect)
+                build(0, false);
+        }
+
+        constexpr bool build(uint32_t s, bool collision_free) {
+            table = {};
+            seed  = s;
+            for (size_t i = 0; i < N; ++i) {
+                if (keys[i] == "")
+                    continue;
+
+                size_t slot = hash(keys[i], seed) & mask;
+                while (table[slot] != 0) {
+                    // a duplicated key is never looked up past its first field
+                    if (collision_free || keys[table[slot] - 1] == keys[i])
+                        break;
+                    slot = (slot + 1) & mask;
+                }
+
+                if (table[slot] == 0)
+                    table[slot] = index_type(i + 1);
+                else if (collision_free)
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    /// Compile-time key map of a tuple with static tags, `Key::value` being the tag name, e.g. "json"
+    template <typename Key, typename Tuple>
+    inline constexpr KeyMap<std::tuple_size_v<Tuple>> static_key_map_v = KeyMap<std::tuple_size_v<Tuple>>(
+        static_tag_info_tuple_v<Key, Tuple>, 1024
+    );
+
+    /// Calls `fn` with the key map of `tpl` whose tag infos are `ti`. When the tuple has static tags, the key map is a
+    /// compile-time constant.
+    template <typename Key, typename... T, typename F>
+    decltype(auto) with_key_map(const std::tuple<T...> &, const TagInfoTuple<sizeof...(T)> &ti, F &&fn) {
+        if constexpr (has_static_tags_v<std::tuple<T...>>)
+            return fn(static_key_map_v<Key, std::tuple<T...>>);
+        else {
+            const KeyMap<sizeof...(T)> km(ti);
+            return fn(km);
+        }
+    }
+} // namespace cppxx::serde
+
+#endif
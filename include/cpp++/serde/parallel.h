@@ -0,0 +1,160 @@
+#ifndef CPPXX_SERDE_PARALLEL_H
+#define CPPXX_SERDE_PARALLEL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace cppxx::serde {
+    /// Number of chunks to split `n` elements into, using `threads` threads (0 for one per core) and giving each chunk at
+    /// least `min_chunk` elements
+    inline size_t parallel_chunk_count(size_t n, size_t threads, size_t min_chunk) {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        return std::max<size_t>(1, std::min(threads, n / std::max<size_t>(1, min_chunk)));
+    }
+
+    /// Splits `[0, n)` into `chunks` contiguous ranges and calls `fn(chunk, begin, end)` for each of them concurrently,
+    /// the calling thread running the first one.
+    ///
+    /// When some calls throw, the exception of the lowest chunk is rethrown once every call has returned, so the error
+    /// does not depend on the scheduling.
+    template <typename F>
+    void parallel_chunks(size_t n, size_t chunks, F &&fn) {
+        if (chunks <= 1)
+            return fn(size_t(0), size_t(0), n);
+
+        std::vector<std::exception_ptr> errors(chunks);
+        auto run = [&](size_t chunk) {
+            try {
+                fn(chunk, n * chunk / chunks, n * (chunk + 1) / chunks);
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(chunks - 1);
+        for (size_t chunk = 1; chunk < chunks; ++chunk) {
+            try {
+                workers.emplace_back(run, chunk);
+            } catch (const std::system_error &) {
+                // out of threads, the chunk is run here instead
+                run(chunk);
+            }
+        }
+
+        run(0);
+        for (auto &worker : workers)
+            worker.join();
+
+        for (auto &err : errors)
+            if (err)
+                std::rethrow_exception(err);
+    }
+
+    /// Splits `[0, n)` into `chunks` contiguous ranges and calls `fn(chunk, begin, end)` for each of them on `workers`
+    /// threads, while the calling thread calls `done(chunk)` for every chunk in order, as soon as it and the chunks
+    /// before it have returned. At most `window` chunks are run ahead of the next one to be given to `done`, so the
+    /// results waiting for their turn stay bounded however many chunks there are.
+    ///
+    /// When a call throws, the chunks after it are no longer started, `done` is called for the chunks before it, and the
+    /// exception of the lowest chunk is rethrown once the running calls have returned.
+    template <typename F, typename D>
+    void parallel_chunks_ordered(size_t n, size_t chunks, size_t workers, size_t window, F &&fn, D &&done) {
+        std::mutex                      mutex;
+        std::condition_variable         cv;
+        std::vector<char>               finished(chunks);
+        std::vector<std::exception_ptr> errors(chunks);
+        size_t                          next_start = 0;
+        size_t                          next_done  = 0;
+        bool                            stop       = false;
+
+        window = std::max<size_t>(1, window);
+        auto work = [&]() {
+            for (;;) {
+                size_t chunk;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&] { return stop || next_start == chunks || next_start < next_done + window; });
+                    if (stop || next_start == chunks)
+                        return;
+                    chunk = next_start++;
+                }
+
+                std::exception_ptr err;
+                try {
+                    fn(chunk, n * chunk / chunks, n * (chunk + 1) / chunks);
+                } catch (...) {
+                    err = std::current_exception();
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished[chunk] = true;
+                    errors[chunk]   = err;
+                    stop |= err != nullptr;
+                }
+                cv.notify_all();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) {
+            try {
+                threads.emplace_back(work);
+            } catch (const std::system_error &) {
+                // out of threads, the started ones do the work
+                break;
+            }
+        }
+
+        auto join = [&]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            cv.notify_all();
+            for (auto &thread : threads)
+                thread.join();
+        };
+
+        try {
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (threads.empty()) {
+                    // no worker could be started, the chunk is run here instead
+                    lock.unlock();
+                    fn(chunk, n * chunk / chunks, n * (chunk + 1) / chunks);
+                } else {
+                    cv.wait(lock, [&] { return finished[chunk]; });
+                    if (errors[chunk])
+                        break;
+                    lock.unlock();
+                }
+
+                done(chunk);
+
+                lock.lock();
+                next_done = chunk + 1;
+                lock.unlock();
+                cv.notify_all();
+            }
+        } catch (...) {
+            join();
+            throw;
+        }
+
+        join();
+        for (auto &err : errors)
+            if (err)
+                std::rethrow_exception(err);
+    }
+} // namespace cppxx::serde
+
+#endif
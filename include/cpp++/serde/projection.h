@@ -0,0 +1,63 @@
+#ifndef CPPXX_SERDE_PROJECTION_H
+#define CPPXX_SERDE_PROJECTION_H
+
+#include <cpp++/tuple.h>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#ifndef BOOST_PFR_HPP
+#    if __has_include(<boost/pfr.hpp>)
+#        include <boost/pfr.hpp>
+#    endif
+#endif
+
+#ifdef BOOST_PFR_HPP
+namespace cppxx::serde {
+    /// Fields of the struct `S` to decode, see `fields`
+    template <typename S>
+    class projection {
+    public:
+        static constexpr size_t size = boost::pfr::tuple_size_v<S>;
+
+        static_assert(
+            std::is_default_constructible_v<S>,
+            "serde::fields needs a default constructible struct, its members are told apart by their address in a "
+            "value built once"
+        );
+
+        template <typename... M>
+        explicit projection(M S::*...members) {
+            // member pointers are runtime values, so they are matched against the fields of a value built once per `S`
+            static const S sample = {};
+
+            tuple_for_each(boost::pfr::structure_tie(sample), [&](const auto &field, auto i) {
+                selected[i] = ((static_cast<const void *>(&field) == static_cast<const void *>(&(sample.*members))) || ...);
+            });
+        }
+
+        bool operator[](size_t i) const {
+            return selected[i];
+        }
+
+        /// One flag per field of `S`, in declaration order
+        const bool *data() const {
+            return selected.data();
+        }
+
+    protected:
+        std::array<bool, size> selected = {};
+    };
+
+    /// Decodes only the given members, the other fields are skipped entirely and keep their value
+    /// @code
+    /// auto order = yy_json::parse<Order>(body, serde::fields(&Order::id, &Order::ts));
+    /// @endcode
+    template <typename S, typename... M>
+    projection<S> fields(M S::*...members) {
+        return projection<S>(members...);
+    }
+} // namespace cppxx::serde
+#endif
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef CPPXX_SERDE_RESULT_H
+#define CPPXX_SERDE_RESULT_H
+
+#include <cpp++/serde/error.h>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace cppxx::serde {
+    /// Outcome of a `try_parse` or a `try_dump`: either the value or the error that prevented it.
+    ///
+    /// A `try_parse` decodes with an error out-parameter, see `detail::fail`: the error is returned up through the
+    /// `Deserialize` specializations, each adding its path segment, so that an invalid document throws nothing. A
+    /// `try_dump` catches the errors thrown by the `Serialize` specializations, which only fail on values that cannot be
+    /// represented.
+    /// @code
+    /// auto res = yy_json::try_parse<Person>(body);
+    /// if (!res)
+    ///     return reply(400, res.error().context.str());
+    /// handle(*res);
+    /// @endcode
+    template <typename T>
+    class result {
+    public:
+        result(T value)
+            : v(std::in_place_index<0>, std::move(value)) {}
+
+        result(serde::error err)
+            : v(std::in_place_index<1>, std::move(err)) {}
+
+        bool ok() const {
+            return v.index() == 0;
+        }
+
+        explicit operator bool() const {
+            return ok();
+        }
+
+        /// The value, only when `ok()`
+        T &value() & {
+            return *std::get_if<0>(&v);
+        }
+        const T &value() const & {
+            return *std::get_if<0>(&v);
+        }
+        T &&value() && {
+            return std::move(*std::get_if<0>(&v));
+        }
+
+        T &operator*() & {
+            return value();
+        }
+        const T &operator*() const & {
+            return value();
+        }
+
+        T *operator->() {
+            return &value();
+        }
+        const T *operator->() const {
+            return &value();
+        }
+
+        /// The error, only when not `ok()`
+        const serde::error &error() const {
+            return *std::get_if<1>(&v);
+        }
+
+    protected:
+        std::variant<T, serde::error> v;
+    };
+
+    template <>
+    class result<void> {
+    public:
+        result() = default;
+
+        result(serde::error err)
+            : err(std::move(err)) {}
+
+        bool ok() const {
+            return !err.has_value();
+        }
+
+        explicit operator bool() const {
+            return ok();
+        }
+
+        /// The error, only when not `ok()`
+        const serde::error &error() const {
+            return *err;
+        }
+
+    protected:
+        std::optional<serde::error> err;
+    };
+
+    /// Runs `fn`, catching the errors it throws into a failed result
+    template <typename F>
+    auto capture(F &&fn) -> result<decltype(fn())> {
+        try {
+            if constexpr (std::is_void_v<decltype(fn())>) {
+                fn();
+                return {};
+            } else
+                return fn();
+        } catch (serde::error &e) {
+            return std::move(e);
+        } catch (std::bad_alloc &) {
+            return serde::error("out of memory");
+        } catch (std::exception &e) {
+            return serde::error(e.what());
+        } catch (...) {
+            return serde::error("unknown error");
+        }
+    }
+} // namespace cppxx::serde
+
+#endif
@@ -0,0 +1,767 @@
+#ifndef CPPXX_SERDE_SNAPSHOT_H
+#define CPPXX_SERDE_SNAPSHOT_H
+
+#include <cpp++/serde/serialize.h>
+#include <cpp++/serde/deserialize.h>
+#include <cpp++/serde/tag_info.h>
+#include <cpp++/serde/error.h>
+#include <cpp++/tag.h>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+extern "C" {
+#include <sha256.h>
+}
+
+#ifndef BOOST_PFR_HPP
+#    if __has_include(<boost/pfr.hpp>)
+#        include <boost/pfr.hpp>
+#    endif
+#endif
+
+#ifndef NEARGYE_MAGIC_ENUM_HPP
+#    if __has_include(<magic_enum/magic_enum.hpp>)
+#        include <magic_enum/magic_enum.hpp>
+#    endif
+#endif
+
+namespace cppxx::serde::snapshot {
+    /// Bumped whenever the encoding changes, so that older snapshots are never decoded
+    inline constexpr std::string_view version = "cppxx-snapshot-1";
+
+    /// Magic bytes at the start of a snapshot file
+    inline constexpr std::string_view magic = "CPPXXSNP";
+
+    using digest_t = std::array<uint8_t, SHA256_BYTES_SIZE>;
+
+    /// Writes values in the snapshot encoding: fields by position without any key, integers as LEB128 varints (signed
+    /// ones zigzagged), floats as their IEEE-754 bits in little-endian and strings prefixed by their size.
+    ///
+    /// Nothing describes the layout in the output itself, a snapshot is only read back by the same `T`, see
+    /// `fingerprint`.
+    class Writer {
+    public:
+        explicit Writer(std::string *out)
+            : out(out) {}
+
+        void byte(uint8_t v) {
+            out->push_back(char(v));
+        }
+
+        void uint(uint64_t v) {
+            for (; v >= 0x80; v >>= 7)
+                byte(uint8_t(v) | 0x80);
+            byte(uint8_t(v));
+        }
+
+        void sint(int64_t v) {
+            uint((uint64_t(v) << 1) ^ uint64_t(v >> 63));
+        }
+
+        void real(double v) {
+            uint64_t bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            for (int i = 0; i < 8; ++i, bits >>= 8)
+                byte(uint8_t(bits));
+        }
+
+        void str(std::string_view v) {
+            uint(v.size());
+            out->append(v.data(), v.size());
+        }
+
+    protected:
+        std::string *out;
+    };
+
+    /// Reads what `Writer` wrote, throwing on truncated input
+    class Reader {
+    public:
+        explicit Reader(std::string_view src)
+            : src(src) {}
+
+        uint8_t byte() {
+            need(1);
+            return uint8_t(src[pos++]);
+        }
+
+        uint64_t uint() {
+            uint64_t v = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                const uint8_t b = byte();
+                v |= uint64_t(b & 0x7f) << shift;
+                if (!(b & 0x80))
+                    return v;
+            }
+            throw error("invalid varint in snapshot");
+        }
+
+        int64_t sint() {
+            const uint64_t v = uint();
+            return int64_t(v >> 1) ^ -int64_t(v & 1);
+        }
+
+        double real() {
+            uint64_t bits = 0;
+            for (int i = 0; i < 8; ++i)
+                bits |= uint64_t(byte()) << (8 * i);
+            double v;
+            std::memcpy(&v, &bits, sizeof(v));
+            return v;
+        }
+
+        std::string_view str() {
+            const size_t n = size();
+            need(n);
+            std::string_view res = src.substr(pos, n);
+            pos += n;
+            return res;
+        }
+
+        /// A count of items, each taking at least one byte, so that a corrupt count never allocates past the input
+        size_t size() {
+            const uint64_t n = uint();
+            need(n);
+            return size_t(n);
+        }
+
+        bool done() const {
+            return pos == src.size();
+        }
+
+    protected:
+        std::string_view src;
+        size_t           pos = 0;
+
+        void need(uint64_t n) const {
+            if (n > src.size() - pos)
+                throw error("truncated snapshot");
+        }
+    };
+
+    /// Appends a description of the layout of `T` to `out`, see `fingerprint`
+    template <typename T, typename = void>
+    struct Layout;
+} // namespace cppxx::serde::snapshot
+
+namespace cppxx::serde::snapshot::detail {
+    /// Fields stored in a snapshot: the tagged ones, or all of them when none is tagged, the same fields that a document
+    /// gives a value to
+    template <typename... T>
+    inline constexpr bool none_tagged_v = (!is_tagged_v<std::decay_t<T>> && ...);
+
+    template <typename F, typename... T>
+    inline constexpr bool is_stored_v = is_tagged_v<std::decay_t<F>> || none_tagged_v<T...>;
+
+    template <typename F>
+    using field_t = std::decay_t<decltype(serde::detail::get_underlying_value(std::declval<F &>()))>;
+
+    template <typename... T>
+    void describe_fields(std::string &out, const std::tuple<T...> &tpl) {
+        out += '{';
+        tuple_for_each(tpl, [&](const auto &field, auto) {
+            using F = std::decay_t<decltype(field)>;
+            if constexpr (is_stored_v<F, T...>) {
+                if constexpr (is_tagged_v<F>)
+                    (out += field.get_tags()) += '=';
+                Layout<field_t<F>>::describe(out);
+                out += ';';
+            }
+        });
+        out += '}';
+    }
+
+    template <typename T>
+    struct is_std_array : std::false_type {};
+
+    template <typename T, size_t N>
+    struct is_std_array<std::array<T, N>> : std::true_type {};
+} // namespace cppxx::serde::snapshot::detail
+
+namespace cppxx::serde::snapshot {
+    template <>
+    struct Layout<bool> {
+        static void describe(std::string &out) {
+            out += 'b';
+        }
+    };
+
+    template <typename T>
+    struct Layout<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+        static void describe(std::string &out) {
+            (out += std::is_signed_v<T> ? 'i' : 'u') += std::to_string(sizeof(T));
+        }
+    };
+
+    template <typename T>
+    struct Layout<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+        static void describe(std::string &out) {
+            (out += 'f') += std::to_string(sizeof(T));
+        }
+    };
+
+    /// An enum is stored by its underlying value, so its layout names every enumerator with its value: renaming,
+    /// adding or renumbering one invalidates the snapshots that hold the old values
+    template <typename T>
+    struct Layout<T, std::enable_if_t<std::is_enum_v<T>>> {
+        static void describe(std::string &out) {
+            (out += 'e') += std::to_string(sizeof(T));
+#ifdef NEARGYE_MAGIC_ENUM_HPP
+            out += '(';
+            for (T v : magic_enum::enum_values<T>())
+                ((out += magic_enum::enum_name(v)) += '=') += std::to_string(+std::underlying_type_t<T>(v)) + ";";
+            out += ')';
+#endif
+        }
+    };
+
+    template <typename CT, typename A>
+    struct Layout<std::basic_string<char, CT, A>> {
+        static void describe(std::string &out) {
+            out += 's';
+        }
+    };
+
+    template <typename T>
+    struct Layout<std::optional<T>> {
+        static void describe(std::string &out) {
+            out += "o(";
+            Layout<T>::describe(out);
+            out += ')';
+        }
+    };
+
+    template <typename T, size_t N>
+    struct Layout<std::array<T, N>> {
+        static void describe(std::string &out) {
+            (out += 'a') += std::to_string(N) + "(";
+            Layout<T>::describe(out);
+            out += ')';
+        }
+    };
+
+    template <typename T, typename A>
+    struct Layout<std::vector<T, A>> {
+        static void describe(std::string &out) {
+            out += "v(";
+            Layout<T>::describe(out);
+            out += ')';
+        }
+    };
+
+    template <typename... T>
+    struct Layout<std::tuple<T...>> {
+        static void describe(std::string &out) {
+            detail::describe_fields(out, std::tuple<T...>{});
+        }
+    };
+
+    template <typename... T>
+    struct Layout<std::variant<T...>> {
+        static void describe(std::string &out) {
+            out += "V(";
+            ((Layout<T>::describe(out), out += '|'), ...);
+            out += ')';
+        }
+    };
+
+    template <typename CT, typename CA, typename T, typename H, typename P, typename A>
+    struct Layout<std::unordered_map<std::basic_string<char, CT, CA>, T, H, P, A>> {
+        static void describe(std::string &out) {
+            out += "m(";
+            Layout<T>::describe(out);
+            out += ')';
+        }
+    };
+
+    template <>
+    struct Layout<std::tm> {
+        static void describe(std::string &out) {
+            out += 't';
+        }
+    };
+
+#ifdef BOOST_PFR_HPP
+    template <typename S>
+    struct Layout<
+        S,
+        std::enable_if_t<std::is_aggregate_v<S> && !std::is_same_v<S, std::tm> && !detail::is_std_array<S>::value>> {
+        static void describe(std::string &out) {
+            // the tags of a field may only be known from a value
+            static const S sample = {};
+            detail::describe_fields(out, boost::pfr::structure_tie(sample));
+        }
+    };
+#endif
+
+    /// SHA-256 of the layout of `T`: the type of each stored field and the whole of its tag, so that a snapshot is never
+    /// decoded into a struct whose fields were added, removed, reordered, retyped or retagged since it was written.
+    ///
+    /// The encoding of a default `T` is hashed too: a field the document leaves out keeps its default, which the
+    /// snapshot then holds, so changing a default must invalidate it.
+    template <typename T>
+    const digest_t &fingerprint() {
+        static const digest_t res = []() {
+            std::string desc(version);
+            desc += ' ';
+            Layout<T>::describe(desc);
+            if constexpr (std::is_default_constructible_v<T>) {
+                desc += ' ';
+                Writer w(&desc);
+                Serialize<Writer, T>{w}.from(T{});
+            }
+
+            digest_t d;
+            sha256_bytes(desc.data(), desc.size(), d.data());
+            return d;
+        }();
+        return res;
+    }
+} // namespace cppxx::serde::snapshot
+
+
+namespace cppxx::serde {
+    // bool
+    template <>
+    struct Serialize<snapshot::Writer, bool> {
+        snapshot::Writer &w;
+
+        void from(bool v) const {
+            w.byte(v);
+        }
+    };
+
+    template <>
+    struct Deserialize<snapshot::Reader, bool> {
+        snapshot::Reader &r;
+
+        void into(bool &v) const {
+            v = r.byte() != 0;
+        }
+    };
+
+    // int
+    template <typename T>
+    struct Serialize<snapshot::Writer, T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+        snapshot::Writer &w;
+
+        void from(T v) const {
+            if constexpr (std::is_signed_v<T>)
+                w.sint(v);
+            else
+                w.uint(v);
+        }
+    };
+
+    template <typename T>
+    struct Deserialize<snapshot::Reader, T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+        snapshot::Reader &r;
+
+        void into(T &v) const {
+            if constexpr (std::is_signed_v<T>)
+                v = T(r.sint());
+            else
+                v = T(r.uint());
+        }
+    };
+
+    // real
+    template <typename T>
+    struct Serialize<snapshot::Writer, T, std::enable_if_t<std::is_floating_point_v<T>>> {
+        snapshot::Writer &w;
+
+        void from(T v) const {
+            w.real(double(v));
+        }
+    };
+
+    template <typename T>
+    struct Deserialize<snapshot::Reader, T, std::enable_if_t<std::is_floating_point_v<T>>> {
+        snapshot::Reader &r;
+
+        void into(T &v) const {
+            v = T(r.real());
+        }
+    };
+
+    // enum, by its underlying value, whatever the document spells
+    template <typename T>
+    struct Serialize<snapshot::Writer, T, std::enable_if_t<std::is_enum_v<T>>> {
+        snapshot::Writer &w;
+
+        void from(T v) const {
+            Serialize<snapshot::Writer, std::underlying_type_t<T>>{w}.from(std::underlying_type_t<T>(v));
+        }
+    };
+
+    template <typename T>
+    struct Deserialize<snapshot::Reader, T, std::enable_if_t<std::is_enum_v<T>>> {
+        snapshot::Reader &r;
+
+        void into(T &v) const {
+            std::underlying_type_t<T> u;
+            Deserialize<snapshot::Reader, std::underlying_type_t<T>>{r}.into(u);
+            v = T(u);
+        }
+    };
+
+    // string
+    template <typename CT, typename A>
+    struct Serialize<snapshot::Writer, std::basic_string<char, CT, A>> {
+        snapshot::Writer &w;
+
+        void from(const std::basic_string<char, CT, A> &v) const {
+            w.str({v.data(), v.size()});
+        }
+    };
+
+    template <typename CT, typename A>
+    struct Deserialize<snapshot::Reader, std::basic_string<char, CT, A>> {
+        snapshot::Reader &r;
+
+        void into(std::basic_string<char, CT, A> &v) const {
+            const std::string_view s = r.str();
+            v.assign(s.data(), s.size());
+        }
+    };
+
+    // optional
+    template <typename T>
+    struct Serialize<snapshot::Writer, std::optional<T>> {
+        snapshot::Writer &w;
+
+        void from(const std::optional<T> &v) const {
+            w.byte(v.has_value());
+            if (v)
+                Serialize<snapshot::Writer, T>{w}.from(*v);
+        }
+    };
+
+    template <typename T>
+    struct Deserialize<snapshot::Reader, std::optional<T>> {
+        snapshot::Reader &r;
+
+        void into(std::optional<T> &v) const {
+            if (!r.byte())
+                return v.reset();
+            Deserialize<snapshot::Reader, T>{r}.into(v.emplace());
+        }
+    };
+
+    // array
+    template <typename T, size_t N>
+    struct Serialize<snapshot::Writer, std::array<T, N>> {
+        snapshot::Writer &w;
+
+        void from(const std::array<T, N> &v) const {
+            for (auto &item : v)
+                Serialize<snapshot::Writer, T>{w}.from(item);
+        }
+    };
+
+    template <typename T, size_t N>
+    struct Deserialize<snapshot::Reader, std::array<T, N>> {
+        snapshot::Reader &r;
+
+        void into(std::array<T, N> &v) const {
+            for (auto &item : v)
+                Deserialize<snapshot::Reader, T>{r}.into(item);
+        }
+    };
+
+    // vector
+    template <typename T, typename A>
+    struct Serialize<snapshot::Writer, std::vector<T, A>> {
+        snapshot::Writer &w;
+
+        void from(const std::vector<T, A> &v) const {
+            w.uint(v.size());
+            for (auto &item : v)
+                Serialize<snapshot::Writer, T>{w}.from(item);
+        }
+    };
+
+    template <typename T, typename A>
+    struct Deserialize<snapshot::Reader, std::vector<T, A>> {
+        snapshot::Reader &r;
+
+        void into(std::vector<T, A> &v) const {
+            v.clear();
+            v.resize(r.size());
+            for (auto &item : v)
+                Deserialize<snapshot::Reader, T>{r}.into(item);
+        }
+    };
+
+    // tuple
+    template <typename... Ts>
+    struct Serialize<snapshot::Writer, std::tuple<Ts...>> {
+        snapshot::Writer &w;
+
+        void from(const std::tuple<Ts...> &tpl) const {
+            tuple_for_each(tpl, [&](const auto &item, auto) {
+                using F = std::decay_t<decltype(item)>;
+                if constexpr (snapshot::detail::is_stored_v<F, Ts...>)
+                    Serialize<snapshot::Writer, snapshot::detail::field_t<F>>{w}.from(detail::get_underlying_value(item));
+            });
+        }
+    };
+
+    template <typename... Ts>
+    struct Deserialize<snapshot::Reader, std::tuple<Ts...>> {
+        snapshot::Reader &r;
+
+        void into(std::tuple<Ts...> &tpl) const {
+            tuple_for_each(tpl, [&](auto &item, auto) {
+                using F = std::decay_t<decltype(item)>;
+                if constexpr (snapshot::detail::is_stored_v<F, Ts...>)
+                    Deserialize<snapshot::Reader, snapshot::detail::field_t<F>>{r}.into(detail::get_underlying_value(item));
+            });
+        }
+    };
+
+    // variant, by the index of its alternative
+    template <typename... T>
+    struct Serialize<snapshot::Writer, std::variant<T...>> {
+        snapshot::Writer &w;
+
+        void from(const std::variant<T...> &v) const {
+            w.uint(v.index());
+            std::visit([&](const auto &var) { Serialize<snapshot::Writer, std::decay_t<decltype(var)>>{w}.from(var); }, v);
+        }
+    };
+
+    template <typename... T>
+    struct Deserialize<snapshot::Reader, std::variant<T...>> {
+        snapshot::Reader &r;
+
+        void into(std::variant<T...> &v) const {
+            alternative(r.uint(), v);
+        }
+
+    protected:
+        template <size_t I = 0>
+        void alternative(uint64_t index, std::variant<T...> &v) const {
+            if constexpr (I < sizeof...(T)) {
+                if (index != I)
+                    return alternative<I + 1>(index, v);
+                using A = std::variant_alternative_t<I, std::variant<T...>>;
+                Deserialize<snapshot::Reader, A>{r}.into(v.template emplace<I>());
+            } else
+                throw error("invalid variant index in snapshot");
+        }
+    };
+
+    // map
+    template <typename CT, typename CA, typename T, typename H, typename P, typename A>
+    struct Serialize<snapshot::Writer, std::unordered_map<std::basic_string<char, CT, CA>, T, H, P, A>> {
+        snapshot::Writer &w;
+
+        void from(const std::unordered_map<std::basic_string<char, CT, CA>, T, H, P, A> &v) const {
+            w.uint(v.size());
+            for (auto &[k, item] : v) {
+                w.str({k.data(), k.size()});
+                Serialize<snapshot::Writer, T>{w}.from(item);
+            }
+        }
+    };
+
+    template <typename CT, typename CA, typename T, typename H, typename P, typename A>
+    struct Deserialize<snapshot::Reader, std::unordered_map<std::basic_string<char, CT, CA>, T, H, P, A>> {
+        snapshot::Reader &r;
+
+        void into(std::unordered_map<std::basic_string<char, CT, CA>, T, H, P, A> &v) const {
+            v.clear();
+            const size_t n = r.size();
+            v.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                const std::string_view k = r.str();
+                Deserialize<snapshot::Reader, T>{r}.into(v[std::basic_string<char, CT, CA>(k.data(), k.size())]);
+            }
+        }
+    };
+
+    // std::tm
+    template <>
+    struct Serialize<snapshot::Writer, std::tm> {
+        snapshot::Writer &w;
+
+        void from(const std::tm &tm) const {
+            for (int v : {tm.tm_sec, tm.tm_min, tm.tm_hour, tm.tm_mday, tm.tm_mon, tm.tm_year, tm.tm_wday, tm.tm_yday, tm.tm_isdst})
+                w.sint(v);
+        }
+    };
+
+    template <>
+    struct Deserialize<snapshot::Reader, std::tm> {
+        snapshot::Reader &r;
+
+        void into(std::tm &tm) const {
+            for (int *v : {&tm.tm_sec, &tm.tm_min, &tm.tm_hour, &tm.tm_mday, &tm.tm_mon, &tm.tm_year, &tm.tm_wday, &tm.tm_yday, &tm.tm_isdst})
+                *v = int(r.sint());
+        }
+    };
+
+#ifdef BOOST_PFR_HPP
+    // aggregate struct
+    template <typename S>
+    struct Serialize<
+        snapshot::Writer,
+        S,
+        std::enable_if_t<std::is_aggregate_v<S> && !std::is_same_v<S, std::tm> && !snapshot::detail::is_std_array<S>::value>> {
+        snapshot::Writer &w;
+
+        void from(const S &v) const {
+            auto tpl = boost::pfr::structure_tie(v);
+            Serialize<snapshot::Writer, decltype(tpl)>{w}.from(tpl);
+        }
+    };
+
+    template <typename S>
+    struct Deserialize<
+        snapshot::Reader,
+        S,
+        std::enable_if_t<std::is_aggregate_v<S> && !std::is_same_v<S, std::tm> && !snapshot::detail::is_std_array<S>::value>> {
+        snapshot::Reader &r;
+
+        void into(S &v) const {
+            auto tpl = boost::pfr::structure_tie(v);
+            Deserialize<snapshot::Reader, decltype(tpl)>{r}.into(tpl);
+        }
+    };
+#endif
+} // namespace cppxx::serde
+
+
+namespace cppxx::serde::snapshot {
+    /// Encodes `val`, without any header
+    template <typename T>
+    [[nodiscard]]
+    std::string dump(const T &val) {
+        std::string res;
+        Writer      w(&res);
+        Serialize<Writer, T>{w}.from(val);
+        return res;
+    }
+
+    /// Decodes what `dump` encoded from a value of the same `T`
+    template <typename T>
+    void parse(std::string_view src, T &val) {
+        Reader r(src);
+        Deserialize<Reader, T>{r}.into(val);
+        if (!r.done())
+            throw error("trailing bytes in snapshot");
+    }
+
+    /// File the snapshot of `path` is kept in
+    inline std::string path_of(const std::string &path) {
+        return path + ".snapshot";
+    }
+
+    /// Decodes the snapshot file `snap` into `val` when it was written from a source of digest `source` and for the
+    /// layout of `T`. Returns false, leaving `val` untouched, when it was not or cannot be read.
+    template <typename T>
+    bool load(const std::string &snap, const digest_t &source, T &val) {
+        std::ifstream f(snap, std::ios::binary);
+        if (!f)
+            return false;
+        const std::string content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+        const size_t header = magic.size() + 2 * sizeof(digest_t);
+        const auto  *data   = reinterpret_cast<const uint8_t *>(content.data());
+        if (content.size() < header || std::string_view(content).substr(0, magic.size()) != magic ||
+            std::memcmp(data + magic.size(), source.data(), source.size()) != 0 ||
+            std::memcmp(data + magic.size() + sizeof(digest_t), fingerprint<T>().data(), sizeof(digest_t)) != 0)
+            return false;
+
+        try {
+            T res = {};
+            parse(std::string_view(content).substr(header), res);
+            val = std::move(res);
+            return true;
+        } catch (error &) {
+            return false;
+        }
+    }
+
+    /// Writes the snapshot of `val` to `snap`, through a temporary file renamed over it so that a concurrent reader
+    /// never sees half of it. Returns false when it cannot be written, e.g. in a read-only directory.
+    template <typename T>
+    bool save(const std::string &snap, const digest_t &source, const T &val) {
+        std::string content(magic);
+        content.append(reinterpret_cast<const char *>(source.data()), source.size());
+        content.append(reinterpret_cast<const char *>(fingerprint<T>().data()), sizeof(digest_t));
+        Writer w(&content);
+        Serialize<Writer, T>{w}.from(val);
+
+        const std::string tmp = snap + ".tmp";
+        {
+            std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+            if (!f || !f.write(content.data(), std::streamsize(content.size())) || !f.flush()) {
+                std::remove(tmp.c_str());
+                return false;
+            }
+        }
+        if (std::rename(tmp.c_str(), snap.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    /// Decodes the document file `path` of type `Doc` (e.g. `::toml::table`, `yyjson_doc` or `nlohmann::json`) into
+    /// `val`, through a binary snapshot kept next to it, see `path_of`.
+    ///
+    /// The snapshot is decoded instead of the document when it was written from a file of the same SHA-256 and for the
+    /// same layout of `T`, see `fingerprint`. Otherwise the document is parsed and, once decoded without error, a new
+    /// snapshot is written for the next time. Returns whether `val` came from the snapshot.
+    /// @code
+    /// Config config;
+    /// serde::snapshot::parse_from_file<::toml::table>("/etc/app/config.toml", config);
+    /// @endcode
+    template <typename Doc, typename T>
+    std::enable_if_t<std::is_default_constructible_v<T>, bool> parse_from_file(const std::string &path, T &val) {
+        std::ifstream f(path, std::ios::binary);
+        if (!f)
+            throw error("failed to open " + path);
+        const std::string content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+        digest_t source;
+        sha256_bytes(content.data(), content.size(), source.data());
+
+        const std::string snap = path_of(path);
+        if (load(snap, source, val))
+            return true;
+
+        // decoded over a default value, not over `val`, so that the snapshot holds what the document alone gives
+        T res = {};
+        Parse<Doc, std::string>{content}.into(res);
+        save(snap, source, res);
+        val = std::move(res);
+        return false;
+    }
+
+    template <typename Doc, typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, T> parse_from_file(const std::string &path) {
+        T val = {};
+        parse_from_file<Doc>(path, val);
+        return val;
+    }
+} // namespace cppxx::serde::snapshot
+
+#endif
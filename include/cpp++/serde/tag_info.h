@@ -13,7 +13,9 @@ namespace cppxx::serde {
         bool             omitempty   = false;
         bool             noserde     = false;
         bool             positional  = false;
+        bool             as_int      = false; ///< enums as their underlying integer, see `int`
         std::string_view help        = "";
+        std::string_view tag         = ""; ///< key naming the alternative of a variant field, see `tag=`
 
         TagInfo() = default;
     };
@@ -24,15 +26,10 @@ namespace cppxx::serde {
         bool                   is_obj = true;
     };
 
-    template <typename T>
-    constexpr TagInfo get_tag_info(const T &field, std::string_view tag, char separator = ',') {
+    constexpr TagInfo parse_tag_info(std::string_view sv, char separator = ',') {
         TagInfo ti    = {};
         bool    first = true;
 
-        std::string_view sv;
-        if constexpr (is_tagged_v<T>)
-            sv = field.get_tag(tag);
-
         while (!sv.empty()) {
             size_t           next = sv.find(separator);
             std::string_view part = sv.substr(0, next);
@@ -47,8 +44,12 @@ namespace cppxx::serde {
                 ti.noserde = true;
             else if (part == "positional")
                 ti.positional = true;
+            else if (part == "int")
+                ti.as_int = true;
             else if (std::string_view h = "help="; part.size() >= h.size() && part.compare(0, h.size(), h) == 0)
                 ti.help = part.substr(h.size());
+            else if (std::string_view d = "tag="; part.size() >= d.size() && part.compare(0, d.size(), d) == 0)
+                ti.tag = part.substr(d.size());
 
             if (next == std::string_view::npos)
                 break;
@@ -58,6 +59,25 @@ namespace cppxx::serde {
         return ti;
     }
 
+    /// Tag info of a field type whose tag is known at compile time, empty otherwise
+    template <typename T>
+    constexpr TagInfo get_static_tag_info(std::string_view tag, char separator = ',') {
+        if constexpr (is_static_tagged_v<T>)
+            return parse_tag_info(T::get_tag(tag), separator);
+        else
+            return {};
+    }
+
+    template <typename T>
+    constexpr TagInfo get_tag_info(const T &field, std::string_view tag, char separator = ',') {
+        if constexpr (is_static_tagged_v<T>)
+            return get_static_tag_info<T>(tag, separator);
+        else if constexpr (is_tagged_v<T>)
+            return parse_tag_info(field.get_tag(tag), separator);
+        else
+            return {};
+    }
+
     template <typename... T>
     constexpr TagInfoTuple<sizeof...(T)>
     get_tag_info_from_tuple(const std::tuple<T...> &fields, std::string_view tag, char separator = ',') {
@@ -72,6 +92,84 @@ namespace cppxx::serde {
         ts.is_obj = !is_array;
         return ts;
     }
+
+
+    /// True when every tagged field of the tuple carries its tag in its type
+    template <typename Tuple>
+    struct has_static_tags;
+
+    template <typename... T>
+    struct has_static_tags<std::tuple<T...>>
+        : std::bool_constant<((!is_tagged_v<std::decay_t<T>> || is_static_tagged_v<std::decay_t<T>>) && ...)> {};
+
+    template <typename Tuple>
+    inline constexpr bool has_static_tags_v = has_static_tags<Tuple>::value;
+
+    template <typename... T>
+    constexpr TagInfoTuple<sizeof...(T)> get_static_tag_info_from_tuple(std::string_view tag, char separator = ',') {
+        TagInfoTuple<sizeof...(T)> ts       = {};
+        bool                       is_array = sizeof...(T) > 0;
+        size_t                     i        = 0;
+
+        ((ts.ts[i] = get_static_tag_info<std::decay_t<T>>(tag, separator),
+          is_array &= ts.ts[i].key == "" || ts.ts[i].positional,
+          ++i),
+         ...);
+
+        ts.is_obj = !is_array;
+        return ts;
+    }
+
+    /// Compile-time tag infos of a tuple with static tags, `Key::value` being the tag name, e.g. "json"
+    template <typename Key, typename Tuple>
+    inline constexpr TagInfoTuple<std::tuple_size_v<Tuple>> static_tag_info_tuple_v = {};
+
+    template <typename Key, typename... T>
+    inline constexpr TagInfoTuple<sizeof...(T)> static_tag_info_tuple_v<Key, std::tuple<T...>> =
+        get_static_tag_info_from_tuple<T...>(Key::value);
+
+    /// The flags field `I` of a tuple may carry: its own flags when the tuple has static tags, every flag otherwise.
+    /// Backends test these with `if constexpr` before reading the runtime `TagInfo`, so a field with a static tag has
+    /// no branch for a flag it does not carry.
+    struct TagFlags {
+        bool skipmissing = true;
+        bool omitempty   = true;
+        bool noserde     = true;
+        bool as_int      = true;
+        bool unkeyed     = true; ///< may have no key, i.e. be left out of an object
+        bool is_static   = false; ///< the flags are the ones of the tag, not every flag
+    };
+
+    template <typename Key, typename Tuple, size_t I>
+    constexpr TagFlags get_tag_flags() {
+        if constexpr (has_static_tags_v<Tuple>) {
+            constexpr TagInfo t = static_tag_info_tuple_v<Key, Tuple>.ts[I];
+            TagFlags          f = {};
+            f.skipmissing       = t.skipmissing;
+            f.omitempty         = t.omitempty;
+            f.noserde           = t.noserde;
+            f.as_int            = t.as_int;
+            f.unkeyed           = t.key == "";
+            f.is_static         = true;
+            return f;
+        } else
+            return {};
+    }
+
+    template <typename Key, typename Tuple, size_t I>
+    inline constexpr TagFlags tag_flags_v = get_tag_flags<Key, Tuple, I>();
+
+    /// Calls `fn` with the tag infos of `tpl`. When the tuple has static tags, the infos are a compile-time constant and
+    /// nothing is parsed at runtime.
+    template <typename Key, typename... T, typename F>
+    decltype(auto) with_tag_info_tuple(const std::tuple<T...> &tpl, F &&fn) {
+        if constexpr (has_static_tags_v<std::tuple<T...>>)
+            return fn(static_tag_info_tuple_v<Key, std::tuple<T...>>);
+        else {
+            const TagInfoTuple<sizeof...(T)> ti = get_tag_info_from_tuple(tpl, Key::value);
+            return fn(ti);
+        }
+    }
 } // namespace cppxx::serde
 
 namespace cppxx::serde::detail {
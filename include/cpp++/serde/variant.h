@@ -0,0 +1,295 @@
+#ifndef CPPXX_SERDE_VARIANT_H
+#define CPPXX_SERDE_VARIANT_H
+
+#include <cpp++/serde/deserialize.h>
+#include <cpp++/serde/error.h>
+#include <cpp++/serde/tag_info.h>
+#include <cpp++/optional.h>
+#include <array>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#if __has_include(<span>)
+#    include <span>
+#endif
+
+#ifndef BOOST_PFR_HPP
+#    if __has_include(<boost/pfr.hpp>)
+#        include <boost/pfr.hpp>
+#    endif
+#endif
+
+namespace cppxx::serde {
+    /// Kinds of document nodes, as bits of a set
+    namespace node_kind {
+        inline constexpr unsigned null     = 1u << 0;
+        inline constexpr unsigned boolean  = 1u << 1;
+        inline constexpr unsigned uint     = 1u << 2;
+        inline constexpr unsigned sint     = 1u << 3;
+        inline constexpr unsigned real     = 1u << 4;
+        inline constexpr unsigned string   = 1u << 5;
+        inline constexpr unsigned datetime = 1u << 6;
+        inline constexpr unsigned array    = 1u << 7;
+        inline constexpr unsigned object   = 1u << 8;
+        inline constexpr unsigned any      = (1u << 9) - 1;
+
+        /// e.g. "uint|sint"
+        inline std::string names(unsigned kinds) {
+            static constexpr std::string_view all[] = {
+                "null", "bool", "uint", "sint", "real", "string", "datetime", "array", "object"
+            };
+            std::string res;
+            for (size_t i = 0; i < std::size(all); ++i)
+                if (kinds & (1u << i))
+                    (res += all[i]) += '|';
+            if (!res.empty())
+                res.pop_back();
+            return res;
+        }
+    } // namespace node_kind
+
+    namespace detail {
+        template <typename T>
+        constexpr unsigned default_accepted_kinds() {
+            if constexpr (std::is_same_v<T, bool>)
+                return node_kind::boolean;
+            else if constexpr (std::is_enum_v<T>)
+                return node_kind::string | node_kind::uint | node_kind::sint;
+            else if constexpr (std::is_unsigned_v<T>)
+                return node_kind::uint;
+            else if constexpr (std::is_integral_v<T>)
+                return node_kind::uint | node_kind::sint;
+            else if constexpr (std::is_floating_point_v<T>)
+                return node_kind::real;
+            else if constexpr (std::is_same_v<T, std::tm>)
+                return node_kind::string | node_kind::datetime;
+            else if constexpr (std::is_aggregate_v<T>)
+                return node_kind::array | node_kind::object;
+            else
+                return node_kind::any;
+        }
+    } // namespace detail
+
+    /// Kinds of nodes that `T` may be deserialized from, by any format.
+    ///
+    /// It only has to be a superset: a node of another kind is known to fail without trying, which is what lets a
+    /// variant pick its alternative without throwing. Types not known here accept any node, and may be specialized.
+    template <typename T>
+    struct accepted_kinds : std::integral_constant<unsigned, detail::default_accepted_kinds<T>()> {};
+
+    template <typename T>
+    inline constexpr unsigned accepted_kinds_v = accepted_kinds<T>::value;
+
+    template <typename C, typename CT, typename A>
+    struct accepted_kinds<std::basic_string<C, CT, A>> : std::integral_constant<unsigned, node_kind::string> {};
+
+    template <typename C, typename CT>
+    struct accepted_kinds<std::basic_string_view<C, CT>> : std::integral_constant<unsigned, node_kind::string> {};
+
+#if __cpp_lib_span >= 202002L
+    template <>
+    struct accepted_kinds<std::span<const char>> : std::integral_constant<unsigned, node_kind::string> {};
+#endif
+
+    template <typename T>
+    struct accepted_kinds<std::optional<T>> : std::integral_constant<unsigned, node_kind::null | accepted_kinds_v<T>> {};
+
+    template <typename T, size_t N>
+    struct accepted_kinds<std::array<T, N>> : std::integral_constant<unsigned, node_kind::array> {};
+
+    template <typename T, typename A>
+    struct accepted_kinds<std::vector<T, A>> : std::integral_constant<unsigned, node_kind::array> {};
+
+    template <typename K, typename T, typename H, typename P, typename A>
+    struct accepted_kinds<std::unordered_map<K, T, H, P, A>> : std::integral_constant<unsigned, node_kind::object> {};
+
+    template <typename... T>
+    struct accepted_kinds<std::tuple<T...>> : std::integral_constant<unsigned, node_kind::array | node_kind::object> {};
+
+    template <typename... T>
+    struct accepted_kinds<std::variant<T...>> : std::integral_constant<unsigned, (accepted_kinds_v<T> | ... | 0u)> {};
+} // namespace cppxx::serde
+
+namespace cppxx::serde::detail {
+    template <typename T>
+    struct is_variant : std::false_type {};
+
+    template <typename... T>
+    struct is_variant<std::variant<T...>> : std::true_type {};
+
+    /// What a struct alternative needs from an object node, read once from a default constructed value
+    struct variant_shape {
+        bool                     known  = false; // false when nothing is known, the alternative is then always tried
+        bool                     is_obj = true;
+        std::vector<std::string> required;       // keys that must be present for the decoding to succeed
+    };
+
+    template <typename Node, typename Key, typename S>
+    const variant_shape &get_variant_shape() {
+        static const variant_shape shape = [] {
+            variant_shape res;
+#ifdef BOOST_PFR_HPP
+            if constexpr (accepted_kinds_v<S> == (node_kind::array | node_kind::object) && std::is_aggregate_v<S>) {
+                S    tmp = {};
+                auto tpl = boost::pfr::structure_tie(tmp);
+
+                res.known = true;
+                with_tag_info_tuple<Key>(tpl, [&](const auto &ti) {
+                    res.is_obj = ti.is_obj;
+                    tuple_for_each(tpl, [&](auto &item, auto i) {
+                        using T          = std::decay_t<decltype(get_underlying_value(item))>;
+                        const TagInfo &t = ti.ts[i];
+                        if (ti.is_obj && t.key != "" && !t.skipmissing && !is_optional_v<T> &&
+                            is_deserializable_v<Node, T>)
+                            res.required.emplace_back(t.key);
+                    });
+                });
+            }
+#endif
+            return res;
+        }();
+        return shape;
+    }
+
+    /// Value of the field keyed `tag` in a default constructed `S`, empty if it has none
+    template <typename Key, typename S>
+    std::string get_variant_discriminator(std::string_view tag) {
+        std::string res;
+#ifdef BOOST_PFR_HPP
+        if constexpr (accepted_kinds_v<S> == (node_kind::array | node_kind::object) && std::is_aggregate_v<S>) {
+            S    tmp = {};
+            auto tpl = boost::pfr::structure_tie(tmp);
+
+            with_tag_info_tuple<Key>(tpl, [&](const auto &ti) {
+                tuple_for_each(tpl, [&](auto &item, auto i) {
+                    const auto &v = get_underlying_value(item);
+                    if constexpr (std::is_convertible_v<decltype(v), std::string_view>)
+                        if (ti.ts[i].key == tag)
+                            res = std::string(std::string_view(v));
+                });
+            });
+        }
+#endif
+        return res;
+    }
+
+    /// Discriminator of each alternative for the tag key `tag`, computed once per thread and tag
+    template <typename Key, typename... T>
+    const std::array<std::string, sizeof...(T)> &get_variant_discriminators(std::string_view tag) {
+        thread_local std::string                           cached_tag;
+        thread_local std::array<std::string, sizeof...(T)> names;
+        thread_local bool                                  cached = false;
+
+        if (!cached || cached_tag != tag) {
+            names      = {get_variant_discriminator<Key, T>(tag)...};
+            cached_tag = tag;
+            cached     = true;
+        }
+        return names;
+    }
+
+    template <size_t... I, typename F>
+    void visit_index(size_t i, F &&fn, std::index_sequence<I...>) {
+        ((i == I ? fn(std::integral_constant<size_t, I>{}) : void()), ...);
+    }
+
+    /// Deserializes a variant without trying the alternatives that cannot match.
+    ///
+    /// `node` describes the node to decode, with:
+    ///   - `unsigned kinds() const`, the `node_kind`s it may be read as
+    ///   - `std::string type_name() const`, for error messages
+    ///   - `bool has_key(std::string_view) const`, for object nodes
+    ///   - `std::optional<std::string_view> string_at(std::string_view) const`, for object nodes
+    ///   - `bool into(Alt &, error *) const`, decoding it into an alternative, see `fail`
+    ///
+    /// With a `tag`, an object node carrying a string at that key is decoded into the alternative whose field of the
+    /// same key defaults to that string, without looking at the other alternatives. Otherwise, the alternatives that do
+    /// not accept the kind of the node, and the structs missing one of their required keys, are left out. When a single
+    /// alternative is left, it is decoded directly; when several are, they are tried in order as the last resort, each
+    /// into its own error so that a failed one throws nothing.
+    template <typename Node, typename Key, typename... T, typename View>
+    bool deserialize_variant(std::variant<T...> &v, const View &node, std::string_view tag, error *err = nullptr) {
+        constexpr size_t                   N        = sizeof...(T);
+        constexpr std::array<unsigned, N>  accepted = {accepted_kinds_v<T>...};
+        constexpr auto                     indices  = std::index_sequence_for<T...>{};
+        const unsigned                     kinds    = node.kinds();
+        const bool                         is_obj   = kinds & node_kind::object;
+
+        auto decode = [&](size_t i, error *err) {
+            bool ok = false;
+            visit_index(
+                i, [&](auto I) { ok = node.into(v.template emplace<I>(), err); }, indices
+            );
+            return ok;
+        };
+
+        if (!tag.empty() && is_obj)
+            if (std::optional<std::string_view> name = node.string_at(tag)) {
+                const auto &names = get_variant_discriminators<Key, T...>(tag);
+                for (size_t i = 0; i < N; ++i)
+                    if (!names[i].empty() && names[i] == *name)
+                        return decode(i, err);
+                return fail(err, error(tag, "unknown variant `" + std::string(*name) + "`"));
+            }
+
+        // alternatives of the right kind, and among them those whose shape fits the node
+        std::array<bool, N> fits       = {};
+        size_t              n_kind     = 0;
+        size_t              n_fit      = 0;
+        const variant_shape *shapes[N] = {&get_variant_shape<Node, Key, T>()...};
+
+        for (size_t i = 0; i < N; ++i) {
+            if (!(accepted[i] & kinds))
+                continue;
+            ++n_kind;
+
+            const variant_shape &shape = *shapes[i];
+            fits[i] = !shape.known || (shape.is_obj ? is_obj : kinds & node_kind::array);
+            if (fits[i] && shape.known && shape.is_obj)
+                for (const std::string &key : shape.required)
+                    if (!node.has_key(key)) {
+                        fits[i] = false;
+                        break;
+                    }
+            n_fit += fits[i];
+        }
+
+        if (n_kind == 0)
+            return fail(
+                err, type_mismatch_error(node_kind::names(accepted_kinds_v<std::variant<T...>>), node.type_name())
+            );
+
+        // when no shape fits, the alternatives of the right kind are tried so that the error is the one of decoding
+        if (n_fit == 0)
+            for (size_t i = 0; i < N; ++i)
+                n_fit += fits[i] = accepted[i] & kinds;
+
+        if (n_fit == 1)
+            for (size_t i = 0; i < N; ++i)
+                if (fits[i])
+                    return decode(i, err);
+
+        std::string type_names;
+        error       tried("");
+        for (size_t i = 0; i < N; ++i) {
+            if (!fits[i])
+                continue;
+            if (decode(i, &tried))
+                return true;
+            if (tried.expected_type.empty())
+                return fail(err, std::move(tried));
+            type_names += tried.expected_type + '|';
+            tried = error("");
+        }
+        type_names.pop_back();
+        return fail(err, type_mismatch_error(type_names, node.type_name()));
+    }
+} // namespace cppxx::serde::detail
+
+#endif
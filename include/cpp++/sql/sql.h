@@ -3,6 +3,7 @@
 
 #include <cpp++/tag.h>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <optional>
 
@@ -25,7 +26,7 @@ namespace cppxx::sql {
     template <typename Params, typename Row>
     struct Statement;
 
-    template <typename T>
+    template <typename T, typename S = void>
     class Column;
 
     template <typename T>
@@ -37,12 +38,12 @@ namespace cppxx::sql {
  * Specialization of tag traits for sql::Column
  */
 namespace cppxx {
-    template <typename T>
-    struct is_tagged<sql::Column<T>> : std::true_type {};
+    template <typename T, typename S>
+    struct is_tagged<sql::Column<T, S>> : std::true_type {};
 
-    template <typename T>
-    struct remove_tag<sql::Column<T>> {
-        using type = typename sql::Column<T>::type;
+    template <typename T, typename S>
+    struct remove_tag<sql::Column<T, S>> {
+        using type = typename sql::Column<T, S>::type;
     };
 } // namespace cppxx
 
@@ -69,6 +70,11 @@ namespace cppxx::sql::detail {
 
     template <typename Tuple, template <typename> typename Pred>
     using apply_tuple_t = typename apply_tuple<Tuple, Pred>::type;
+
+    inline std::string column_name(std::string_view column);
+
+    template <typename Col, typename S>
+    struct column_order;
 } // namespace cppxx::sql::detail
 
 
@@ -239,19 +245,30 @@ namespace cppxx::sql {
         }
     };
 
-    template <typename T>
-    class Column : public Tag<T> {
+    /// A table column, i.e. a `Tag` whose `sql` tag holds the column definition.
+    ///
+    /// Like `Tag`, the definition can be given as a type so that the column has the same size as its value:
+    /// @code
+    /// struct User {
+    ///     static constexpr const char *TableName = "Users";
+    ///
+    ///     sql::Column<int, decltype("sql:`id integer primary key`"_tag)> id;
+    ///     sql::Column<std::string> name = "sql:`name varchar(32) not null`";
+    /// };
+    /// @endcode
+    template <typename T, typename S>
+    class Column
+        : public Tag<T, S>
+        , public detail::column_order<Column<T, S>, S> {
     public:
-        using Tag<T>::Tag;
+        using Tag<T, S>::Tag;
 
         std::string column() const {
             return std::string(this->get_tag("sql"));
         }
 
         std::string name() const {
-            auto col = column();
-            auto pos = col.find(' ');
-            return pos == std::string::npos ? col : col.substr(0, pos);
+            return detail::column_name(this->get_tag("sql"));
         }
 
         template <typename U>
@@ -259,23 +276,23 @@ namespace cppxx::sql {
             return name() + " as " + alias.name();
         }
 
-        template <typename U>
-        auto operator+(const Column<U> &other) const {
+        template <typename U, typename V>
+        auto operator+(const Column<U, V> &other) const {
             return Alias<decltype(std::declval<T>() + std::declval<U>())>('(' + name() + " + " + other.name() + ')');
         }
 
-        template <typename U>
-        auto operator-(const Column<U> &other) const {
+        template <typename U, typename V>
+        auto operator-(const Column<U, V> &other) const {
             return Alias<decltype(std::declval<T>() - std::declval<U>())>(name() + " - " + other.name());
         }
 
-        template <typename U>
-        auto operator*(const Column<U> &other) const {
+        template <typename U, typename V>
+        auto operator*(const Column<U, V> &other) const {
             return Alias<decltype(std::declval<T>() * std::declval<U>())>(name() + " * " + other.name());
         }
 
-        template <typename U>
-        auto operator/(const Column<U> &other) const {
+        template <typename U, typename V>
+        auto operator/(const Column<U, V> &other) const {
             return Alias<decltype(std::declval<T>() / std::declval<U>())>(name() + " / " + other.name());
         }
 
@@ -368,20 +385,6 @@ namespace cppxx::sql {
         auto operator<=(const Statement<Params, Row> &stmt) const {
             return Statement<>{name() + " <= "} + stmt;
         }
-
-        const struct Asc {
-            const Column *col;
-            std::string   name() const {
-                return col->name() + " asc";
-            }
-        } asc{this};
-
-        const struct Desc {
-            const Column *col;
-            std::string   name() const {
-                return col->name() + " desc";
-            }
-        } desc{this};
     };
 
     template <typename T>
@@ -461,6 +464,43 @@ namespace cppxx::sql {
  * Helpers Implementations
  */
 namespace cppxx::sql::detail {
+    inline std::string column_name(std::string_view column) {
+        return std::string(column.substr(0, column.find(' ')));
+    }
+
+    /// `asc` and `desc` of a column whose definition is part of its type, no storage needed
+    template <typename Col, typename S>
+    struct column_order {
+        static constexpr struct Asc {
+            static std::string name() {
+                return column_name(cppxx::detail::find_tag(S::value, "sql")) + " asc";
+            }
+        } asc = {};
+
+        static constexpr struct Desc {
+            static std::string name() {
+                return column_name(cppxx::detail::find_tag(S::value, "sql")) + " desc";
+            }
+        } desc = {};
+    };
+
+    template <typename Col>
+    struct column_order<Col, void> {
+        const struct Asc {
+            const Col  *col;
+            std::string name() const {
+                return col->name() + " asc";
+            }
+        } asc{static_cast<const Col *>(this)};
+
+        const struct Desc {
+            const Col  *col;
+            std::string name() const {
+                return col->name() + " desc";
+            }
+        } desc{static_cast<const Col *>(this)};
+    };
+
     template <size_t i>
     struct repeated_placeholders {
         static std::string value() {
@@ -2,8 +2,165 @@
 #define CPPXX_TAG_H
 
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace cppxx {
+    /// A compile-time string carried by a type. Used as the second template argument of `Tag` so that the tag is known
+    /// at compile time and is never stored nor parsed at runtime.
+    ///
+    /// Usually spelled with the `_tag` literal from `cppxx::literals`:
+    /// @code
+    /// using namespace cppxx::literals;
+    /// using NameTag = decltype("json:`name`"_tag);
+    /// @endcode
+    template <char... Cs>
+    struct tag_string {
+        static constexpr char             data[] = {Cs..., '\0'};
+        static constexpr std::string_view value  = {data, sizeof...(Cs)};
+    };
+} // namespace cppxx
+
+namespace cppxx::detail {
+#if __cpp_nontype_template_args >= 201911L
+    template <size_t N>
+    struct fixed_string {
+        char data[N] = {};
+
+        constexpr fixed_string(const char (&str)[N]) {
+            for (size_t i = 0; i < N; ++i)
+                data[i] = str[i];
+        }
+    };
+
+    template <fixed_string F, size_t... I>
+    constexpr tag_string<F.data[I]...> make_tag_string(std::index_sequence<I...>) {
+        return {};
+    }
+#endif
+
+    constexpr std::string_view find_tag(std::string_view tag, std::string_view key) {
+        for (size_t pos = 0; pos < tag.size();) {
+            // find next ":`"
+            const size_t sep = tag.find(":`", pos);
+            if (sep == std::string_view::npos)
+                break;
+
+            // left part before ":`"
+            std::string_view keys = tag.substr(pos, sep - pos);
+
+            // right part until next backtick
+            size_t end = tag.find('`', sep + 2);
+            if (end == std::string_view::npos)
+                break;
+
+            std::string_view value = tag.substr(sep + 2, end - (sep + 2));
+            for (size_t start = 0; start < keys.size();) {
+                size_t comma = keys.find(',', start);
+
+                std::string_view one = keys.substr(start, (comma == std::string_view::npos ? keys.size() : comma) - start);
+                if (one == key)
+                    return value;
+
+                if (comma == std::string_view::npos)
+                    break;
+
+                start = comma + 1;
+            }
+
+            // advance past this key–value pair
+            pos = end + 1;
+            // skip whitespace if any
+            while (pos < tag.size() && tag[pos] == ' ')
+                pos++;
+        }
+
+        return {};
+    }
+} // namespace cppxx::detail
+
+namespace cppxx::literals {
+#if __cpp_nontype_template_args >= 201911L
+    template <detail::fixed_string F>
+    constexpr auto operator""_tag() {
+        return detail::make_tag_string<F>(std::make_index_sequence<sizeof(F.data) - 1>{});
+    }
+#else
+#    if defined(__clang__)
+#        pragma clang diagnostic push
+#        pragma clang diagnostic ignored "-Wgnu-string-literal-operator-template"
+#    endif
+    template <typename C, C... Cs>
+    constexpr tag_string<Cs...> operator""_tag() {
+        return {};
+    }
+#    if defined(__clang__)
+#        pragma clang diagnostic pop
+#    endif
+#endif
+} // namespace cppxx::literals
 
 namespace cppxx {
+    /// A lightweight metadata wrapper for struct fields, inspired by Go-style struct tags.
+    ///
+    /// The tag is given as a type (see `tag_string`), so it is parsed at compile time and takes no room in the object.
+    ///
+    /// @code
+    /// using namespace cppxx::literals;
+    ///
+    /// struct User {
+    ///     Tag<std::string, decltype("json:`name`"_tag)> name;
+    ///     Tag<std::optional<std::string>, decltype("json:`email`"_tag)> email = {"user@example.com"}; // with default value
+    /// };
+    /// @endcode
+    template <typename T, typename S = void>
+    class Tag {
+    protected:
+        T value = {};
+
+    public:
+        using type     = T;
+        using tag_type = S;
+
+        constexpr Tag() = default;
+
+        constexpr Tag(const T &value)
+            : value(value) {}
+
+        constexpr Tag(T &&value)
+            : value(std::move(value)) {}
+
+        constexpr const T &operator()() const & {
+            return value;
+        }
+        constexpr T &operator()() & {
+            return value;
+        }
+        constexpr T &&operator()() && {
+            return std::move(value);
+        }
+
+        constexpr const T &get_value() const & {
+            return value;
+        }
+        constexpr T &get_value() & {
+            return value;
+        }
+        constexpr T &&get_value() && {
+            return std::move(value);
+        }
+
+        static constexpr std::string_view get_tag(std::string_view key) {
+            return detail::find_tag(S::value, key);
+        }
+
+        /// The whole tag, with the values of every key
+        static constexpr std::string_view get_tags() {
+            return S::value;
+        }
+    };
+
     /// A lightweight metadata wrapper for struct fields, inspired by Go-style struct tags.
     ///
     /// @code
@@ -16,13 +173,14 @@ namespace cppxx {
     /// };
     /// @endcode
     template <typename T>
-    class Tag {
+    class Tag<T, void> {
     protected:
         const char *tag;
         T           value = {};
 
     public:
-        using type = T;
+        using type     = T;
+        using tag_type = void;
 
         constexpr Tag(const char *tag)
             : tag(tag) {}
@@ -57,64 +215,43 @@ namespace cppxx {
             return std::move(value);
         }
 
-        std::string_view get_tag(std::string_view key) const {
-            const std::string_view tag = this->tag;
-
-            for (size_t pos = 0; pos < tag.size();) {
-                // find next ":`"
-                const size_t sep = tag.find(":`", pos);
-                if (sep == std::string_view::npos)
-                    break;
-
-                // left part before ":`"
-                std::string_view keys = tag.substr(pos, sep - pos);
-
-                // right part until next backtick
-                size_t end = tag.find('`', sep + 2);
-                if (end == std::string_view::npos)
-                    break;
-
-                std::string_view value = tag.substr(sep + 2, end - (sep + 2));
-                for (size_t start = 0; start < keys.size();) {
-                    size_t comma = keys.find(',', start);
-
-                    std::string_view one = keys.substr(start, (comma == std::string_view::npos ? keys.size() : comma) - start);
-                    if (one == key)
-                        return value;
-
-                    if (comma == std::string_view::npos)
-                        break;
-
-                    start = comma + 1;
-                }
-
-                // advance past this key–value pair
-                pos = end + 1;
-                // skip whitespace if any
-                while (pos < tag.size() && tag[pos] == ' ')
-                    pos++;
-            }
+        constexpr std::string_view get_tag(std::string_view key) const {
+            return detail::find_tag(tag, key);
+        }
 
-            return {};
+        /// The whole tag, with the values of every key
+        constexpr std::string_view get_tags() const {
+            return tag;
         }
     };
 
     template <typename T>
     struct is_tagged : std::false_type {};
 
-    template <typename T>
-    struct is_tagged<Tag<T>> : std::true_type {};
+    template <typename T, typename S>
+    struct is_tagged<Tag<T, S>> : std::true_type {};
 
     template <typename T>
     inline static constexpr bool is_tagged_v = is_tagged<T>::value;
 
 
+    /// True when the tag of `T` is part of its type rather than stored in each instance
+    template <typename T, typename = void>
+    struct is_static_tagged : std::false_type {};
+
     template <typename T>
-    struct remove_tag;
+    struct is_static_tagged<T, std::enable_if_t<is_tagged_v<T> && !std::is_void_v<typename T::tag_type>>> : std::true_type {};
 
     template <typename T>
-    struct remove_tag<Tag<T>> {
-        using type = typename Tag<T>::type;
+    inline static constexpr bool is_static_tagged_v = is_static_tagged<T>::value;
+
+
+    template <typename T>
+    struct remove_tag;
+
+    template <typename T, typename S>
+    struct remove_tag<Tag<T, S>> {
+        using type = typename Tag<T, S>::type;
     };
 
     template <typename T>
@@ -3,6 +3,7 @@
 
 #include <ctime>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 
 namespace cppxx {
@@ -16,23 +17,36 @@ namespace cppxx {
         return str;
     }
 
-    inline std::tm tm_from_string(const std::string &str) {
-        if (str.size() != 20 || str[4] != '-' || str[7] != '-' || str[10] != 'T' || str[13] != ':' || str[16] != ':' ||
-            str[19] != 'Z')
-            throw std::runtime_error("Invalid datetime format: " + str);
+    /// Parses `str` as written by `tm_to_string` into `tm`, returning false when it is not
+    inline bool tm_from_string(std::string_view str, std::tm &tm) {
+        static constexpr std::string_view format = "0000-00-00T00:00:00Z";
+        if (str.size() != format.size())
+            return false;
+        for (size_t i = 0; i < format.size(); ++i)
+            if (format[i] == '0' ? str[i] < '0' || str[i] > '9' : str[i] != format[i])
+                return false;
 
-        std::tm tm = {};
-        try {
-            tm.tm_year  = std::stoi(str.substr(0, 4)) - 1900;
-            tm.tm_mon   = std::stoi(str.substr(5, 2)) - 1;
-            tm.tm_mday  = std::stoi(str.substr(8, 2));
-            tm.tm_hour  = std::stoi(str.substr(11, 2));
-            tm.tm_min   = std::stoi(str.substr(14, 2));
-            tm.tm_sec   = std::stoi(str.substr(17, 2));
-            tm.tm_isdst = 0; // UTC
-        } catch (...) {
+        auto number = [&](size_t pos, size_t len) {
+            int n = 0;
+            for (size_t i = pos; i < pos + len; ++i)
+                n = n * 10 + (str[i] - '0');
+            return n;
+        };
+        tm          = {};
+        tm.tm_year  = number(0, 4) - 1900;
+        tm.tm_mon   = number(5, 2) - 1;
+        tm.tm_mday  = number(8, 2);
+        tm.tm_hour  = number(11, 2);
+        tm.tm_min   = number(14, 2);
+        tm.tm_sec   = number(17, 2);
+        tm.tm_isdst = 0; // UTC
+        return true;
+    }
+
+    inline std::tm tm_from_string(const std::string &str) {
+        std::tm tm;
+        if (!tm_from_string(std::string_view(str), tm))
             throw std::runtime_error("Invalid datetime format: " + str);
-        }
         return tm;
     }
 
@@ -0,0 +1,315 @@
+#ifndef CPPXX_TOML_LIVE_CONFIG_H
+#define CPPXX_TOML_LIVE_CONFIG_H
+
+#include <cpp++/toml/marzer_toml.h>
+#include <cpp++/serde/error.h>
+#include <cpp++/serde/result.h>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+extern "C" {
+#include <sha256.h>
+}
+
+#if __has_include(<sys/stat.h>) && __has_include(<unistd.h>) && __has_include(<fcntl.h>)
+#    include <fcntl.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#if __has_include(<sys/inotify.h>) && __has_include(<poll.h>) && __has_include(<unistd.h>) && __has_include(<fcntl.h>)
+#    define CPPXX_HAS_INOTIFY 1
+#    include <fcntl.h>
+#    include <poll.h>
+#    include <sys/inotify.h>
+#    include <unistd.h>
+#endif
+
+namespace cppxx::toml {
+    /// A TOML file decoded into `T`, and decoded again whenever its content changes.
+    ///
+    /// Each decoded `T` is an immutable snapshot. A new one is published only when the SHA-256 of the file changed and it
+    /// decoded without error; otherwise the previous snapshot is kept and the error is available from `last_error`.
+    /// Where inotify is available, a thread watches the directory of the file, so that editors replacing the file by a
+    /// rename are seen too. Elsewhere, or without `watch`, the file is read again by `reload` only.
+    ///
+    /// The file is read with plain reads, and read again when its size or modification time changed meanwhile. A file
+    /// written in place can still be seen between two writes, so writers should replace it by a rename.
+    ///
+    /// Hot paths read through a `reader`, which keeps the snapshot it saw last: as long as no new snapshot was
+    /// published, `get` is a single atomic load of the version, without any lock.
+    /// @code
+    /// toml::live_config<Config> config("/etc/app/config.toml");
+    ///
+    /// // on each worker thread
+    /// auto reader = config.make_reader();
+    /// while (serving)
+    ///     handle(next_request(), reader.get());
+    /// @endcode
+    template <typename T>
+    class live_config {
+    public:
+        /// Snapshot cache of a thread, not to be shared between threads
+        class reader {
+        public:
+            explicit reader(const live_config &config)
+                : config(&config) {}
+
+            /// The current config, valid until the next call
+            const T &get() {
+                const uint64_t version = config->version();
+                if (version != seen) {
+                    snap = config->snapshot();
+                    seen = version;
+                }
+                return *snap;
+            }
+
+            const T &operator*() {
+                return get();
+            }
+
+            const T *operator->() {
+                return &get();
+            }
+
+        protected:
+            const live_config       *config;
+            std::shared_ptr<const T> snap;
+            uint64_t                 seen = 0;
+        };
+
+        /// Decodes the file, throwing if it cannot. With `watch`, it is decoded again whenever it changes.
+        explicit live_config(std::string path, bool watch = true)
+            : path(std::move(path)) {
+#ifdef CPPXX_HAS_INOTIFY
+            // watched before the first read, so that no change is missed
+            try {
+                if (watch)
+                    add_watch();
+            } catch (...) {
+                close_fds();
+                throw;
+            }
+#endif
+            if (auto res = reload(); !res) {
+#ifdef CPPXX_HAS_INOTIFY
+                close_fds();
+#endif
+                throw res.error();
+            }
+#ifdef CPPXX_HAS_INOTIFY
+            if (watch)
+                watcher = std::thread([this]() { run(); });
+#endif
+        }
+
+        live_config(const live_config &)            = delete;
+        live_config &operator=(const live_config &) = delete;
+
+        ~live_config() {
+#ifdef CPPXX_HAS_INOTIFY
+            if (watcher.joinable()) {
+                const char c = 0;
+                (void)!::write(stop_fds[1], &c, 1);
+                watcher.join();
+            }
+            close_fds();
+#endif
+        }
+
+        /// The current config, kept alive by the returned pointer however many reloads follow
+        std::shared_ptr<const T> snapshot() const {
+            return std::atomic_load_explicit(&current, std::memory_order_acquire);
+        }
+
+        reader make_reader() const {
+            return reader(*this);
+        }
+
+        /// Incremented each time a snapshot is published, starting from 1
+        uint64_t version() const {
+            return published.load(std::memory_order_acquire);
+        }
+
+        /// Reads the file now. Returns whether a new snapshot was published, or the error that kept the previous one.
+        serde::result<bool> reload() {
+            std::lock_guard<std::mutex> lock(mtx);
+            auto                        res = serde::capture([&]() { return load(); });
+            error = res ? std::nullopt : std::optional<serde::error>(res.error());
+            return res;
+        }
+
+        /// Error of the last reload, none if it succeeded
+        std::optional<serde::error> last_error() const {
+            std::lock_guard<std::mutex> lock(mtx);
+            return error;
+        }
+
+        const std::string &get_path() const {
+            return path;
+        }
+
+    protected:
+        using digest_t = std::array<uint8_t, SHA256_BYTES_SIZE>;
+
+        std::string                 path;
+        std::shared_ptr<const T>    current;
+        std::atomic<uint64_t>       published{0};
+        mutable std::mutex          mtx; // serializes the reloads, never taken by the readers
+        digest_t                    digest = {};
+        std::optional<serde::error> error;
+
+        bool load() {
+            read_file();
+            const std::string_view content = buffer;
+
+            digest_t d;
+            sha256_bytes(content.data(), content.size(), d.data());
+            if (published.load(std::memory_order_relaxed) && d == digest)
+                return false;
+
+            ::toml::table tbl;
+            try {
+                tbl = ::toml::parse(content, path);
+            } catch (std::exception &e) {
+                throw serde::error(e.what());
+            }
+
+            auto                next = std::make_shared<T>();
+            const ::toml::node *node = &tbl;
+            serde::Deserialize<::toml::node, T>{node}.into(*next);
+
+            digest = d;
+            std::atomic_store_explicit(&current, std::shared_ptr<const T>(std::move(next)), std::memory_order_release);
+            published.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+
+        std::string buffer; // content of the file, kept to reuse its memory
+
+#if __has_include(<sys/stat.h>) && __has_include(<unistd.h>) && __has_include(<fcntl.h>)
+        void read_file() {
+            struct descriptor {
+                int fd;
+                ~descriptor() {
+                    ::close(fd);
+                }
+            };
+
+            for (int attempt = 0;; ++attempt) {
+                const descriptor f = {::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+                if (f.fd < 0)
+                    throw serde::error("failed to open " + path + ": " + std::strerror(errno));
+
+                struct stat before, after;
+                if (::fstat(f.fd, &before) < 0)
+                    throw serde::error("failed to read " + path + ": " + std::strerror(errno));
+
+                // one byte more than the size, to see a file that grows
+                buffer.resize(size_t(before.st_size) + 1);
+                size_t done = 0;
+                for (ssize_t n; (n = ::read(f.fd, &buffer[done], buffer.size() - done)) != 0;) {
+                    if (n < 0 && errno == EINTR)
+                        continue;
+                    if (n < 0)
+                        throw serde::error("failed to read " + path + ": " + std::strerror(errno));
+                    if ((done += size_t(n)) == buffer.size())
+                        buffer.resize(buffer.size() * 2);
+                }
+                buffer.resize(done);
+
+                if (::fstat(f.fd, &after) < 0)
+                    throw serde::error("failed to read " + path + ": " + std::strerror(errno));
+                // files in /proc and the like have a size of 0 whatever they hold
+                const bool sized = before.st_size > 0;
+                if ((!sized || done == size_t(before.st_size)) && after.st_size == before.st_size &&
+                    after.st_mtime == before.st_mtime)
+                    return;
+                if (attempt == 2)
+                    throw serde::error(path + " kept changing while being read");
+            }
+        }
+#else
+        void read_file() {
+            std::ifstream f(path, std::ios::binary);
+            if (!f)
+                throw serde::error("failed to open " + path);
+            buffer.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        }
+#endif
+
+#ifdef CPPXX_HAS_INOTIFY
+        int         notify_fd   = -1;
+        int         stop_fds[2] = {-1, -1};
+        std::string name; // of the file in its directory
+        std::thread watcher;
+
+        void add_watch() {
+            const size_t      slash = path.find_last_of('/');
+            const std::string dir   = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+            name                    = slash == std::string::npos ? path : path.substr(slash + 1);
+
+            notify_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (notify_fd < 0)
+                throw_errno("failed to watch " + path);
+            // written in place, or replaced by a rename
+            if (::inotify_add_watch(notify_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+                throw_errno("failed to watch " + dir);
+            if (::pipe2(stop_fds, O_CLOEXEC) < 0)
+                throw_errno("failed to watch " + path);
+        }
+
+        void close_fds() {
+            for (int *fd : {&notify_fd, &stop_fds[0], &stop_fds[1]})
+                if (*fd >= 0)
+                    ::close(std::exchange(*fd, -1));
+        }
+
+        void run() {
+            alignas(inotify_event) char buf[4096];
+            pollfd                      fds[2] = {{notify_fd, POLLIN, 0}, {stop_fds[0], POLLIN, 0}};
+
+            for (;;) {
+                if (::poll(fds, 2, -1) < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    return;
+                }
+                if (fds[1].revents)
+                    return;
+
+                bool changed = false;
+                for (ssize_t n; (n = ::read(notify_fd, buf, sizeof(buf))) > 0;)
+                    for (char *p = buf; p < buf + n;) {
+                        const auto *ev = reinterpret_cast<const inotify_event *>(p);
+                        changed |= ev->len && name == ev->name;
+                        p += sizeof(inotify_event) + ev->len;
+                    }
+
+                if (changed)
+                    (void)reload();
+            }
+        }
+
+        [[noreturn]] static void throw_errno(const std::string &what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+#endif
+    };
+} // namespace cppxx::toml
+
+#endif
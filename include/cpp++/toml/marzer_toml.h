@@ -2,13 +2,19 @@
 #define CPPXX_TOML_MARZER_TOML_H
 
 #include <cpp++/toml/toml.h>
+#include <cpp++/toml/marzer_toml_writer.h>
 #include <cpp++/serde/serialize.h>
 #include <cpp++/serde/deserialize.h>
+#include <cpp++/serde/enum.h>
 #include <cpp++/serde/error.h>
+#include <cpp++/serde/result.h>
+#include <cpp++/serde/variant.h>
+#include <cpp++/mmap.h>
 #include <array>
 #include <variant>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <ctime>
 
 #ifndef TOMLPLUSPLUS_HPP
@@ -44,22 +50,37 @@ namespace cppxx::toml::marzer_toml {
     template <typename T>
     [[nodiscard]]
     std::enable_if_t<std::is_default_constructible_v<T>, T> parse_from_file(const std::string &path);
+
+    template <typename T>
+    [[nodiscard]]
+    serde::result<void> try_parse(const std::string &str, T &val);
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, serde::result<T>> try_parse(const std::string &str);
+
+    template <typename T>
+    [[nodiscard]]
+    serde::result<std::string> try_dump(const T &val);
 } // namespace cppxx::toml::marzer_toml
 
 
 namespace cppxx::serde {
     template <>
     struct Dump<::toml::table, std::string> {
+        /// Written straight from the value, the same as printing its `toml::table`
         template <typename T>
         std::string from(const T &v) const {
-            auto val = Serialize<::toml::node, T>{}.from(v);
+            std::string                      res;
+            cppxx::toml::marzer_toml::Writer w(&res);
+            w.document(Serialize<cppxx::toml::marzer_toml::Writer, T>{w}, v);
+            return res;
+        }
 
-            if (::toml::table *tbl = val->as_table()) {
-                std::ostringstream oss;
-                oss << *tbl;
-                return oss.str();
-            } else
-                throw type_mismatch_error("table", std::string(::toml::impl::node_type_friendly_names[(int)val->type()]));
+        /// Same as `from`, with the errors caught and returned instead of thrown
+        template <typename T>
+        result<std::string> try_from(const T &v) const {
+            return capture([&]() { return from(v); });
         }
     };
 
@@ -67,17 +88,59 @@ namespace cppxx::serde {
     struct Parse<::toml::table, std::string> {
         const std::string &src;
 
+        /// When `src_is_path` and the file can be mapped, it is parsed straight from the mapping instead of being read into
+        /// a buffer
         template <typename T>
         void into(T &val, bool src_is_path = false) const {
             ::toml::table tbl;
+            read(tbl, nullptr, src_is_path);
+            Deserialize<::toml::node, T>{&tbl}.into(val);
+        }
+
+        /// Same as `into`, with the errors returned instead of thrown. The table is decoded with an error out-parameter,
+        /// see `detail::fail`, so that an invalid document throws nothing while decoding. Syntax errors are thrown by
+        /// toml++ itself and caught here, unless it is built with `TOML_EXCEPTIONS=0`.
+        template <typename T>
+        result<void> try_into(T &val, bool src_is_path = false) const {
+            ::toml::table tbl;
+            error         err("");
+            if (!read(tbl, &err, src_is_path) || !Deserialize<::toml::node, T>{&tbl}.into(val, &err))
+                return err;
+            return {};
+        }
+
+    protected:
+        /// `toml::parse_result` when toml++ is built with `TOML_EXCEPTIONS=0`, `toml::table` otherwise
+        auto parse(bool src_is_path) const {
+#ifdef CPPXX_HAS_MMAP
+            if (src_is_path && MappedFile::is_mappable(src)) {
+                const MappedFile file(src);
+                return ::toml::parse(std::string_view(file.data(), file.size()), src);
+            }
+#endif
+            return src_is_path ? ::toml::parse_file(src) : ::toml::parse(src);
+        }
+
+        /// Parses the source into `tbl`, the errors being thrown when `err` is null, see `detail::fail`
+        bool read(::toml::table &tbl, error *err, bool src_is_path) const {
+#if defined(TOML_EXCEPTIONS) && !TOML_EXCEPTIONS
+            ::toml::parse_result res;
+#else
+            ::toml::table res;
+#endif
             try {
-                tbl = src_is_path ? ::toml::parse_file(src) : ::toml::parse(src);
+                res = parse(src_is_path);
             } catch (std::exception &e) {
-                throw error(e.what());
+                return detail::fail(err, error(e.what()));
             }
-
-            ::toml::node *node = &tbl;
-            Deserialize<::toml::node, T>{node}.into(val);
+#if defined(TOML_EXCEPTIONS) && !TOML_EXCEPTIONS
+            if (!res)
+                return detail::fail(err, error(std::string(res.error().description())));
+            tbl = std::move(res).table();
+#else
+            tbl = std::move(res);
+#endif
+            return true;
         }
     };
 
@@ -93,11 +156,14 @@ namespace cppxx::serde {
     struct Deserialize<::toml::node, bool> {
         const ::toml::node *node;
 
-        void into(bool &v) const {
-            if (auto val = node->as_boolean())
+        bool into(bool &v, error *err = nullptr) const {
+            if (auto val = node->as_boolean()) {
                 v = val->get();
-            else
-                throw type_mismatch_error("bool", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]));
+                return true;
+            }
+            return detail::fail(
+                err, type_mismatch_error("bool", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]))
+            );
         }
     };
 
@@ -113,11 +179,14 @@ namespace cppxx::serde {
     struct Deserialize<::toml::node, T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
         const ::toml::node *node;
 
-        void into(T &v) const {
-            if (auto val = node->as_integer())
+        bool into(T &v, error *err = nullptr) const {
+            if (auto val = node->as_integer()) {
                 v = (T)val->get();
-            else
-                throw type_mismatch_error("int", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]));
+                return true;
+            }
+            return detail::fail(
+                err, type_mismatch_error("int", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]))
+            );
         }
     };
 
@@ -133,11 +202,14 @@ namespace cppxx::serde {
     struct Deserialize<::toml::node, T, std::enable_if_t<std::is_floating_point_v<T>>> {
         const ::toml::node *node;
 
-        void into(T &v) const {
-            if (auto val = node->as_floating_point())
+        bool into(T &v, error *err = nullptr) const {
+            if (auto val = node->as_floating_point()) {
                 v = (T)val->get();
-            else
-                throw type_mismatch_error("float", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]));
+                return true;
+            }
+            return detail::fail(
+                err, type_mismatch_error("float", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]))
+            );
         }
     };
 
@@ -174,28 +246,38 @@ namespace cppxx::serde {
     struct Deserialize<::toml::node, std::string> {
         const ::toml::node *node;
 
-        void into(std::string &v) const {
-            if (auto val = node->as_string())
+        bool into(std::string &v, error *err = nullptr) const {
+            if (auto val = node->as_string()) {
                 v = val->get();
-            else
-                throw type_mismatch_error("string", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]));
+                return true;
+            }
+            return detail::fail(
+                err, type_mismatch_error("string", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]))
+            );
         }
 
-        void into_raw(std::string &v) const {
+        bool into_raw(std::string &v, error *err = nullptr) const {
             if (auto tbl = node->as_table()) {
                 std::ostringstream oss;
                 oss << *tbl;
                 v = oss.str();
-            } else
-                throw type_mismatch_error("table", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]));
+                return true;
+            }
+            return detail::fail(
+                err, type_mismatch_error("table", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]))
+            );
         }
     };
 
     // optional
     template <typename T>
     struct Serialize<::toml::node, std::optional<T>, std::enable_if_t<std::is_default_constructible_v<T>>> {
+        bool as_int = false; ///< from the `int` option of the field, for an optional enum
+
         std::unique_ptr<::toml::node> from(const std::optional<T> &v) const {
             Serialize<::toml::node, T> ser = {};
+            if constexpr (detail::is_named_enum_v<T>)
+                ser.as_int = as_int;
             if (v.has_value())
                 return ser.from(*v);
             else
@@ -206,14 +288,19 @@ namespace cppxx::serde {
     template <typename T>
     struct Deserialize<::toml::node, std::optional<T>, std::enable_if_t<std::is_default_constructible_v<T>>> {
         const ::toml::node *node;
+        bool                as_int = false; ///< from the `int` option of the field, for an optional enum
 
-        void into(std::optional<T> &v) const {
+        bool into(std::optional<T> &v, error *err = nullptr) const {
             if (!node) {
                 v = std::nullopt;
-                return;
+                return true;
             }
-            v = T{};
-            Deserialize<::toml::node, T>{node}.into(*v);
+            if (!v)
+                v.emplace();
+            if constexpr (detail::is_named_enum_v<T>)
+                return Deserialize<::toml::node, T>{node, as_int}.into(*v, err);
+            else
+                return Deserialize<::toml::node, T>{node}.into(*v, err);
         }
     };
 
@@ -232,22 +319,23 @@ namespace cppxx::serde {
     struct Deserialize<::toml::node, std::array<T, N>> {
         const ::toml::node *node;
 
-        void into(std::array<T, N> &v) const {
+        bool into(std::array<T, N> &v, error *err = nullptr) const {
             auto arr = node->as_array();
             if (!arr)
-                throw type_mismatch_error("array", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]));
+                return detail::fail(
+                    err, type_mismatch_error("array", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]))
+                );
 
             const size_t n = arr->size();
             if (n != N)
-                throw size_mismatch_error(N, n);
+                return detail::fail(err, size_mismatch_error(N, n));
 
             for (size_t i = 0; i < n; ++i)
-                try {
-                    Deserialize<::toml::node, T>{arr->get(i)}.into(v[i]);
-                } catch (error &e) {
-                    e.add_context(i);
-                    throw;
-                }
+                if (!detail::with_context(err, i, [&] {
+                        return Deserialize<::toml::node, T>{arr->get(i)}.into(v[i], err);
+                    }))
+                    return false;
+            return true;
         };
     };
 
@@ -265,65 +353,83 @@ namespace cppxx::serde {
     struct Deserialize<::toml::node, std::vector<T>, std::enable_if_t<std::is_default_constructible_v<T>>> {
         const ::toml::node *node;
 
-        void into(std::vector<T> &v) const {
+        bool into(std::vector<T> &v, error *err = nullptr) const {
             auto arr = node->as_array();
             if (!arr)
-                throw type_mismatch_error("array", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]));
+                return detail::fail(
+                    err, type_mismatch_error("array", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]))
+                );
 
             const size_t n = arr->size();
+            // the elements already there are decoded over in place, keeping their memory
             v.resize(n);
             for (size_t i = 0; i < n; ++i)
-                try {
-                    Deserialize<::toml::node, T>{arr->get(i)}.into(v[i]);
-                } catch (error &e) {
-                    e.add_context(i);
-                    throw;
-                }
+                if (!detail::with_context(err, i, [&] {
+                        return Deserialize<::toml::node, T>{arr->get(i)}.into(v[i], err);
+                    }))
+                    return false;
+            return true;
         }
     };
 
     template <typename... Ts>
     struct Serialize<::toml::node, std::tuple<Ts...>> {
         std::unique_ptr<::toml::node> from(const std::tuple<Ts...> &tpl) {
-            const TagInfoTuple<sizeof...(Ts)>         ti     = cppxx::toml::get_tag_info_from_tuple(tpl);
-            const std::array<TagInfo, sizeof...(Ts)> &ts     = ti.ts;
-            const bool                                is_obj = ti.is_obj;
-
-            std::unique_ptr<::toml::node> node =
-                is_obj ? std::unique_ptr<::toml::node>(new ::toml::table) : std::unique_ptr<::toml::node>(new ::toml::array);
-            tuple_for_each(tpl, [&](const auto &item, const size_t i) {
-                const TagInfo &t = ts[i];
-                const auto    &v = detail::get_underlying_value(item);
-                using T          = std::decay_t<decltype(v)>;
-
-                if (!is_serializable_v<::toml::node, T> || (is_obj && t.key == "") || (t.omitempty && detail::is_empty_value(v)))
-                    return;
-
-                std::unique_ptr<::toml::node> val;
-                try {
-                    if (t.noserde)
-                        if constexpr (std::is_same_v<T, std::string>)
-                            val = Serialize<::toml::node, std::string>{}.from_raw(v);
+            return cppxx::toml::with_tag_info_tuple(tpl, [&](const TagInfoTuple<sizeof...(Ts)> &ti) {
+                const std::array<TagInfo, sizeof...(Ts)> &ts     = ti.ts;
+                const bool                                is_obj = ti.is_obj;
+
+                std::unique_ptr<::toml::node> node =
+                    is_obj ? std::unique_ptr<::toml::node>(new ::toml::table) : std::unique_ptr<::toml::node>(new ::toml::array);
+                tuple_for_each(tpl, [&](const auto &item, auto i) {
+                    const TagInfo &t = ts[i];
+                    const auto    &v = detail::get_underlying_value(item);
+                    using T          = std::decay_t<decltype(v)>;
+
+                    constexpr TagFlags f = tag_flags_v<cppxx::toml::TagKey, std::tuple<Ts...>, i>;
+
+                    if constexpr (is_serializable_v<::toml::node, T>) {
+                        if constexpr (f.unkeyed)
+                            if (is_obj && t.key == "")
+                                return;
+                        if constexpr (f.omitempty)
+                            if (t.omitempty && detail::is_empty_value(v))
+                                return;
+
+                        auto encode = [&]() -> std::unique_ptr<::toml::node> {
+                            if constexpr (f.noserde)
+                                if (t.noserde) {
+                                    if constexpr (std::is_same_v<T, std::string>)
+                                        return Serialize<::toml::node, std::string>{}.from_raw(v);
+                                    else
+                                        throw error("field with tag `noserde` can only be serialized from std::string");
+                                }
+                            detail::check_as_int<T, f.is_static, f.as_int>(t.as_int);
+                            if constexpr (detail::takes_as_int_v<T> && f.as_int)
+                                return Serialize<::toml::node, T>{t.as_int}.from(v);
+                            else
+                                return Serialize<::toml::node, T>{}.from(v);
+                        };
+
+                        std::unique_ptr<::toml::node> val;
+                        try {
+                            val = encode();
+                        } catch (error &e) {
+                            if (is_obj)
+                                e.add_context(t.key);
+                            else
+                                e.add_context(i);
+                            throw;
+                        }
+                        if (is_obj)
+                            node->as_table()->insert_or_assign(t.key, std::move(*val));
                         else
-                            throw error("field with tag `noserde` can only be serialized from std::string");
-                    else {
-                        if constexpr (is_serializable_v<::toml::node, T>)
-                            val = Serialize<::toml::node, T>{}.from(v);
+                            node->as_array()->push_back(std::move(*val));
                     }
-                } catch (error &e) {
-                    if (is_obj)
-                        e.add_context(t.key);
-                    else
-                        e.add_context(i);
-                    throw;
-                }
-                if (is_obj)
-                    node->as_table()->insert_or_assign(t.key, std::move(*val));
-                else
-                    node->as_array()->push_back(std::move(*val));
-            });
+                });
 
-            return node;
+                return node;
+            });
         }
     };
 
@@ -331,47 +437,91 @@ namespace cppxx::serde {
     struct Deserialize<::toml::node, std::tuple<Ts...>> {
         const ::toml::node *node;
 
-        void into(std::tuple<Ts...> &tpl) const {
-            const TagInfoTuple<sizeof...(Ts)>         ti     = cppxx::toml::get_tag_info_from_tuple(tpl);
-            const std::array<TagInfo, sizeof...(Ts)> &ts     = ti.ts;
-            const bool                                is_obj = ti.is_obj;
-
-            auto arr = node->as_array();
-            auto tbl = node->as_table();
-            if (!is_obj && !arr)
-                throw type_mismatch_error("array", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]));
-            if (is_obj && !tbl)
-                throw type_mismatch_error("table", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]));
-
-            tuple_for_each(tpl, [&](auto &item, const size_t i) {
-                const TagInfo &t = ts[i];
-                auto          &v = detail::get_underlying_value(item);
-                using T          = std::decay_t<decltype(v)>;
-
-                if (is_obj && t.key == "")
-                    return;
-
-                const ::toml::node *val = is_obj ? tbl->get(t.key) : arr->get(i);
-                if (!val && t.skipmissing)
-                    return;
-
-                try {
-                    if (t.noserde)
-                        if constexpr (std::is_same_v<T, std::string>)
-                            Deserialize<::toml::node, std::string>{val}.into_raw(v);
-                        else
-                            throw error("field with tag `noserde` can only be deserialized into std::string");
-                    else {
-                        if constexpr (is_deserializable_v<::toml::node, T>)
-                            Deserialize<::toml::node, T>{val}.into(v);
+        bool into(std::tuple<Ts...> &tpl, error *err = nullptr) const {
+            return cppxx::toml::with_tag_info_tuple(tpl, [&](const TagInfoTuple<sizeof...(Ts)> &ti) {
+                const std::array<TagInfo, sizeof...(Ts)> &ts     = ti.ts;
+                const bool                                is_obj = ti.is_obj;
+
+                auto arr = node->as_array();
+                auto tbl = node->as_table();
+                if (!is_obj && !arr)
+                    return detail::fail(
+                        err, type_mismatch_error("array", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]))
+                    );
+                if (is_obj && !tbl)
+                    return detail::fail(
+                        err, type_mismatch_error("table", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]))
+                    );
+
+                // the fields after a failed one are left as they are
+                bool ok    = true;
+                auto field = [&](auto &item, auto i, const ::toml::node *val) {
+                    const TagInfo &t = ts[i];
+                    auto          &v = detail::get_underlying_value(item);
+                    using T          = std::decay_t<decltype(v)>;
+
+                    constexpr TagFlags f = tag_flags_v<cppxx::toml::TagKey, std::tuple<Ts...>, i>;
+
+                    if constexpr (is_deserializable_v<::toml::node, T>) {
+                        if constexpr (f.unkeyed)
+                            if (is_obj && t.key == "")
+                                return;
+                        if constexpr (f.skipmissing)
+                            if (!val && t.skipmissing)
+                                return;
+
+                        auto decode = [&] {
+                            if constexpr (f.noserde)
+                                if (t.noserde) {
+                                    if constexpr (std::is_same_v<T, std::string>)
+                                        return Deserialize<::toml::node, std::string>{val}.into_raw(v, err);
+                                    else
+                                        return detail::fail(
+                                            err, error("field with tag `noserde` can only be deserialized into std::string")
+                                        );
+                                }
+                            if (!detail::check_as_int<T, f.is_static, f.as_int>(t.as_int, err))
+                                return false;
+                            if constexpr (detail::is_variant<T>::value)
+                                return Deserialize<::toml::node, T>{val, t.tag}.into(v, err);
+                            else if constexpr (detail::takes_as_int_v<T> && f.as_int)
+                                return Deserialize<::toml::node, T>{val, t.as_int}.into(v, err);
+                            else
+                                return Deserialize<::toml::node, T>{val}.into(v, err);
+                        };
+
+                        ok = is_obj ? detail::with_context(err, t.key, decode) : detail::with_context(err, i, decode);
                     }
-                } catch (error &e) {
-                    if (is_obj)
-                        e.add_context(t.key);
-                    else
-                        e.add_context(i);
-                    throw;
+                };
+
+                if (!is_obj) {
+                    tuple_for_each(tpl, [&](auto &item, auto i) {
+                        if (ok)
+                            field(item, i, arr->get(i));
+                    });
+                    return ok;
                 }
+
+                // walk the table once, dispatching each key to its field
+                cppxx::toml::with_key_map(tpl, ti, [&](const KeyMap<sizeof...(Ts)> &km) {
+                    std::array<bool, sizeof...(Ts)> seen = {};
+
+                    for (auto &&[key, val] : *tbl) {
+                        const size_t i = km.find(std::string_view(key));
+                        if (i == km.npos || std::exchange(seen[i], true))
+                            continue;
+                        tuple_visit(tpl, i, [&](auto &item, auto i) { field(item, i, &val); });
+                        if (!ok)
+                            break;
+                    }
+
+                    // missing fields
+                    tuple_for_each(tpl, [&](auto &item, auto i) {
+                        if (ok && !seen[i])
+                            field(item, i, nullptr);
+                    });
+                });
+                return ok;
             });
         }
     };
@@ -388,37 +538,60 @@ namespace cppxx::serde {
     template <typename... T>
     struct Deserialize<::toml::node, std::variant<T...>, std::enable_if_t<(std::is_default_constructible_v<T> && ...)>> {
         const ::toml::node *node;
+        std::string_view    tag = {}; ///< key naming the alternative, from the `tag=` option of the field
 
-        void into(std::variant<T...> &v) const {
-            try_for_each(v, std::index_sequence_for<T...>{});
+        bool into(std::variant<T...> &v, error *err = nullptr) const {
+            return detail::deserialize_variant<::toml::node, cppxx::toml::TagKey>(v, view{node}, tag, err);
         }
 
     protected:
-        template <size_t... I>
-        void try_for_each(std::variant<T...> &v, std::index_sequence<I...>) const {
-            bool        done = false;
-            std::string type_names;
-            (
-                [&]() {
-                    using Elem = std::tuple_element_t<I, std::tuple<T...>>;
-                    try {
-                        if (!done) {
-                            auto element = Elem{};
-                            Deserialize<::toml::node, Elem>{node}.into(element);
-                            v    = std::move(element);
-                            done = true;
-                        }
-                    } catch (type_mismatch_error &e) {
-                        type_names += e.expected_type + '|';
-                    }
-                }(),
-                ...
-            );
-            if (!done) {
-                type_names.pop_back();
-                throw type_mismatch_error(type_names, std::string(::toml::impl::node_type_friendly_names[(int)node->type()]));
+        struct view {
+            const ::toml::node *node;
+
+            unsigned kinds() const {
+                if (!node)
+                    return node_kind::null;
+                switch (node->type()) {
+                    case ::toml::node_type::table:
+                        return node_kind::object;
+                    case ::toml::node_type::array:
+                        return node_kind::array;
+                    case ::toml::node_type::string:
+                        return node_kind::string;
+                    case ::toml::node_type::integer:
+                        return node_kind::uint | node_kind::sint;
+                    case ::toml::node_type::floating_point:
+                        return node_kind::real;
+                    case ::toml::node_type::boolean:
+                        return node_kind::boolean;
+                    case ::toml::node_type::date:
+                    case ::toml::node_type::time:
+                    case ::toml::node_type::date_time:
+                        return node_kind::datetime;
+                    default:
+                        return 0;
+                }
             }
-        }
+
+            std::string type_name() const {
+                return node ? std::string(::toml::impl::node_type_friendly_names[(int)node->type()]) : "none";
+            }
+
+            bool has_key(std::string_view key) const {
+                return node->as_table()->contains(key);
+            }
+
+            std::optional<std::string_view> string_at(std::string_view key) const {
+                if (auto str = node->as_table()->get_as<std::string>(key))
+                    return std::string_view(str->get());
+                return std::nullopt;
+            }
+
+            template <typename A>
+            bool into(A &a, error *err) const {
+                return Deserialize<::toml::node, A>{node}.into(a, err);
+            }
+        };
     };
 
     // table
@@ -436,21 +609,29 @@ namespace cppxx::serde {
     struct Deserialize<::toml::node, std::unordered_map<std::string, T>, std::enable_if_t<std::is_default_constructible_v<T>>> {
         const ::toml::node *node;
 
-        void into(std::unordered_map<std::string, T> &v) const {
+        /// The map ends up with the keys of the table only. The entries whose key is not in the table are erased and the
+        /// others are decoded over in place, so that decoding a same-shaped table again allocates nothing.
+        bool into(std::unordered_map<std::string, T> &v, error *err = nullptr) const {
             auto table = node->as_table();
             if (!table)
-                throw type_mismatch_error("table", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]));
-
-            for (auto [key, node] : *table) {
-                auto item = T{};
-                try {
-                    Deserialize<::toml::node, T>{&node}.into(item);
-                } catch (error &e) {
-                    e.add_context(std::string_view(key));
-                    throw;
-                }
-                v.emplace(std::string(key), std::move(item));
+                return detail::fail(
+                    err, type_mismatch_error("table", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]))
+                );
+
+            for (auto it = v.begin(); it != v.end();)
+                it = table->contains(it->first) ? std::next(it) : v.erase(it);
+            v.reserve(table->size());
+
+            std::string key_str;
+            for (auto &&[key, node] : *table) {
+                key_str.assign(key.str());
+                auto it = v.try_emplace(key_str).first;
+                if (!detail::with_context(err, std::string_view(key), [&] {
+                        return Deserialize<::toml::node, T>{&node}.into(it->second, err);
+                    }))
+                    return false;
             }
+            return true;
         }
     };
 
@@ -476,7 +657,7 @@ namespace cppxx::serde {
     struct Deserialize<::toml::node, std::tm> {
         const ::toml::node *node;
 
-        void into(std::tm &v) const {
+        bool into(std::tm &v, error *err = nullptr) const {
             if (auto val = node->as_time())
                 to_tm(val->get(), v);
             else if (auto val = node->as_date())
@@ -485,7 +666,10 @@ namespace cppxx::serde {
                 to_tm(val->get().time, v);
                 to_tm(val->get().date, v);
             } else
-                throw type_mismatch_error("time", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]));
+                return detail::fail(
+                    err, type_mismatch_error("time", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]))
+                );
+            return true;
         }
 
         static void to_tm(const ::toml::date &d, std::tm &tm) {
@@ -514,9 +698,9 @@ namespace cppxx::serde {
     struct Deserialize<::toml::node, S, std::enable_if_t<std::is_aggregate_v<S> && !std::is_same_v<S, std::tm>>> {
         const ::toml::node *node;
 
-        void into(S &v) const {
+        bool into(S &v, error *err = nullptr) const {
             auto tpl = boost::pfr::structure_tie(v);
-            Deserialize<::toml::node, decltype(tpl)>{node}.into(tpl);
+            return Deserialize<::toml::node, decltype(tpl)>{node}.into(tpl, err);
         }
     };
 #endif
@@ -525,7 +709,11 @@ namespace cppxx::serde {
     // enum
     template <typename S>
     struct Serialize<::toml::node, S, std::enable_if_t<std::is_enum_v<S>>> {
+        bool as_int = false; ///< from the `int` option of the field
+
         std::unique_ptr<::toml::node> from(const S &v) const {
+            if (as_int)
+                return Serialize<::toml::node, std::underlying_type_t<S>>{}.from(std::underlying_type_t<S>(v));
             return Serialize<::toml::node, std::string_view>{}.from(magic_enum::enum_name(v));
         }
     };
@@ -533,21 +721,19 @@ namespace cppxx::serde {
     template <typename S>
     struct Deserialize<::toml::node, S, std::enable_if_t<std::is_enum_v<S>>> {
         const ::toml::node *node;
+        bool                as_int = false; ///< from the `int` option of the field
 
-        void into(S &v) const {
-            auto str = std::string();
-            Deserialize<::toml::node, std::string>{node}.into(str);
-
-            auto e = magic_enum::enum_cast<S>(str);
-            if (!e.has_value()) {
-                std::string what = "invalid value `" + str + "`, expected one of {";
-                for (std::string_view name : magic_enum::enum_names<S>()) {
-                    what += std::string(name) + ",";
-                }
-                what += "}";
-                throw error(std::move(what));
+        bool into(S &v, error *err = nullptr) const {
+            if (as_int) {
+                std::underlying_type_t<S> n;
+                return Deserialize<::toml::node, std::underlying_type_t<S>>{node}.into(n, err) &&
+                       detail::enum_from_int<S>(n, v, err);
             }
-            v = *e;
+            if (auto str = node->as_string())
+                return detail::enum_from_name<S>(str->get(), v, err);
+            return detail::fail(
+                err, type_mismatch_error("string", std::string(::toml::impl::node_type_friendly_names[(int)node->type()]))
+            );
         }
     };
 #endif
@@ -585,5 +771,59 @@ namespace cppxx::toml::marzer_toml {
     std::string dump(const T &val) {
         return cppxx::serde::Dump<::toml::table, std::string>{}.from(val);
     }
+
+    template <typename T>
+    [[nodiscard]]
+    serde::result<void> try_parse(const std::string &str, T &val) {
+        return cppxx::serde::Parse<::toml::table, std::string>{str}.try_into(val);
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    std::enable_if_t<std::is_default_constructible_v<T>, serde::result<T>> try_parse(const std::string &str) {
+        T    val = {};
+        auto res = cppxx::serde::Parse<::toml::table, std::string>{str}.try_into(val);
+        if (!res)
+            return res.error();
+        return serde::result<T>(std::move(val));
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    serde::result<std::string> try_dump(const T &val) {
+        return cppxx::serde::Dump<::toml::table, std::string>{}.try_from(val);
+    }
+
+    /// Reusable dumper. The output buffer and the writer state are kept between calls, so dumping many values of
+    /// similar size allocates only while the buffer grows.
+    ///
+    /// A dumper must not be used by several threads at once, see `Dumper::local` for a per-thread instance.
+    class Dumper {
+    public:
+        /// Dumps `val` into the internal buffer. The returned string is valid until the next call.
+        template <typename T>
+        const std::string &dump(const T &val) {
+            dump(val, buffer);
+            return buffer;
+        }
+
+        /// Dumps `val` into `out`, replacing its content but keeping its capacity
+        template <typename T>
+        void dump(const T &val, std::string &out) {
+            out.clear();
+            writer.reset(&out);
+            writer.document(cppxx::serde::Serialize<Writer, T>{writer}, val);
+        }
+
+        /// Dumper of the calling thread
+        static Dumper &local() {
+            static thread_local Dumper dumper;
+            return dumper;
+        }
+
+    protected:
+        Writer      writer{nullptr};
+        std::string buffer;
+    };
 } // namespace cppxx::toml::marzer_toml
 #endif
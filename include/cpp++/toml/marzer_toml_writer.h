@@ -0,0 +1,1151 @@
+#ifndef CPPXX_TOML_MARZER_TOML_WRITER_H
+#define CPPXX_TOML_MARZER_TOML_WRITER_H
+
+#include <cpp++/toml/toml.h>
+#include <cpp++/serde/serialize.h>
+#include <cpp++/serde/enum.h>
+#include <cpp++/serde/error.h>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#ifndef TOMLPLUSPLUS_HPP
+#    include <toml++/toml.h>
+#endif
+
+#ifndef BOOST_PFR_HPP
+#    if __has_include(<boost/pfr.hpp>)
+#        include <boost/pfr.hpp>
+#    endif
+#endif
+
+#ifndef NEARGYE_MAGIC_ENUM_HPP
+#    if __has_include(<magic_enum/magic_enum.hpp>)
+#        include <magic_enum/magic_enum.hpp>
+#    endif
+#endif
+
+namespace cppxx::toml::marzer_toml {
+    /// Writes TOML text straight into a string, without building a `toml::table` first.
+    ///
+    /// The output is the same as printing the equivalent table with the default `toml::toml_formatter`: keys sorted,
+    /// values before sub-tables and arrays of tables, sub-tables indented, literal strings where possible, and arrays
+    /// broken over several lines when toml++ estimates them wider than 120 columns.
+    ///
+    /// Since a table is written in several passes, `Serialize<Writer, T>` tells what a value becomes with its `kind`:
+    /// - `value`: `from(v)` writes it, `columns(v)` is its width as estimated by toml++
+    /// - `array`: `size(v)` and `at(v, i, fn)`, which calls `fn(ser, item)` with the i-th element
+    /// - `table`: `members(v, fn)`, which calls `fn(key, ser, item)` for every member, sorted by key
+    /// - `any`: `visit(v, fn)`, which calls `fn(ser, item)` with what the value holds, e.g. the alternative of a variant
+    class Writer {
+    public:
+        enum class kind { value, array, table, any };
+
+        explicit Writer(std::string *out)
+            : out(out) {}
+
+        /// Starts a new document into `out`, keeping the memory of the previous one
+        void reset(std::string *out) {
+            this->out = out;
+            indent    = 0;
+            naked     = true;
+            pending   = false;
+            path.clear();
+            raws.clear();
+        }
+
+        /// Writes `v` as the root table
+        template <typename Ser, typename T>
+        void document(const Ser &ser, const T &v) {
+            resolve(ser, v, [&](const auto &s, const auto &u) {
+                using S = std::decay_t<decltype(s)>;
+                if constexpr (S::kind == kind::table) {
+                    if (is_inline(u))
+                        return inline_table(s, u);
+
+                    // so that the values and the tables of the root have the same indent
+                    indent = -1;
+                    table(s, u, sections_of(s, u, 0), 0);
+                } else
+                    throw serde::type_mismatch_error("table", type_name(s, u));
+            });
+        }
+
+        /// Writes `v` inline, as the value of a key or an element of an array
+        template <typename Ser, typename T>
+        void value(const Ser &ser, const T &v) {
+            resolve(ser, v, [&](const auto &s, const auto &u) {
+                using S = std::decay_t<decltype(s)>;
+                if constexpr (S::kind == kind::value)
+                    s.from(u);
+                else if constexpr (S::kind == kind::array)
+                    array(s, u);
+                else
+                    inline_table(s, u);
+            });
+        }
+
+        void boolean(bool v) {
+            v ? put("true") : put("false");
+        }
+
+        /// Decimal, or with the base of a parsed integer
+        void integer(int64_t v, ::toml::value_flags flags = ::toml::value_flags::none) {
+            const auto base_mask = ::toml::value_flags::format_as_binary | ::toml::value_flags::format_as_octal |
+                                   ::toml::value_flags::format_as_hexadecimal;
+            const auto fmt  = flags & base_mask;
+            int        base = 10;
+            if (v >= 0) {
+                if (fmt == ::toml::value_flags::format_as_binary)
+                    (base = 2, put("0b"));
+                else if (fmt == ::toml::value_flags::format_as_octal)
+                    (base = 8, put("0o"));
+                else if (fmt == ::toml::value_flags::format_as_hexadecimal)
+                    (base = 16, put("0x"));
+            }
+
+            char buf[72];
+            auto [end, _] = std::to_chars(buf, buf + sizeof(buf), v, base);
+            if (base == 16)
+                std::transform(buf, end, buf, [](char c) { return c >= 'a' ? char(c - 32) : c; });
+            put({buf, size_t(end - buf)});
+        }
+
+        /// With 17 significant digits, as toml++ prints through iostreams
+        void real(double v) {
+            if (std::isnan(v))
+                return put("nan");
+            if (std::isinf(v))
+                return v < 0 ? put("-inf") : put("inf");
+
+            char buf[32];
+            auto [end, _] = std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::general, 17);
+            put({buf, size_t(end - buf)});
+
+            // keep the number a float, e.g. `1.0` instead of `1`
+            if (std::string_view(buf, end - buf).find_first_of(".eE") == std::string_view::npos)
+                put(".0");
+        }
+
+        /// A string value, or a key when `allow_bare`
+        void str(std::string_view v, bool allow_multi_line = true, bool allow_bare = false);
+
+        void date(const ::toml::date &d) {
+            put_padded(d.year, 4);
+            put("-");
+            put_padded(d.month, 2);
+            put("-");
+            put_padded(d.day, 2);
+        }
+
+        void time(const ::toml::time &t) {
+            put_padded(t.hour, 2);
+            put(":");
+            put_padded(t.minute, 2);
+            put(":");
+            put_padded(t.second, 2);
+
+            if (t.nanosecond && t.nanosecond <= 999999999u) {
+                uint32_t ns     = t.nanosecond;
+                size_t   digits = 9;
+                for (; ns % 10 == 0; ns /= 10)
+                    --digits;
+                put(".");
+                put_padded(ns, digits);
+            }
+        }
+
+        void date_time(const ::toml::date_time &dt) {
+            date(dt.date);
+            put("T");
+            time(dt.time);
+            if (!dt.offset)
+                return;
+
+            int mins = dt.offset->minutes;
+            if (mins == 0)
+                return put("Z");
+            put(mins < 0 ? "-" : "+");
+            mins = std::abs(mins);
+            put_padded(unsigned(mins / 60), 2);
+            put(":");
+            put_padded(unsigned(mins % 60), 2);
+        }
+
+        /// Width of an integer, as estimated by toml++ to decide whether an array fits on one line
+        static size_t columns(int64_t v) {
+            if (!v)
+                return 1;
+            size_t weight = 0;
+            double d      = static_cast<double>(v);
+            if (d < 0) {
+                weight += 1;
+                d *= -1;
+            }
+            return weight + static_cast<size_t>(std::log10(d)) + 1;
+        }
+
+        static size_t columns(double v) {
+            if (v == 0.0)
+                return 3;
+            size_t weight = 2;
+            if (v < 0.0) {
+                weight += 1;
+                v *= -1.0;
+            }
+            return weight + static_cast<size_t>(std::log10(v)) + 1;
+        }
+
+        static size_t columns(std::string_view v) {
+            return v.size() + 2;
+        }
+
+        /// The table parsed from the text of a `noserde` field, parsed once per document
+        const ::toml::table &raw(const std::string &v) {
+            auto it = raws.find(v);
+            if (it != raws.end())
+                return it->second;
+
+            ::toml::table tbl;
+            try {
+                tbl = ::toml::parse(v);
+            } catch (std::exception &e) {
+                throw serde::error(e.what());
+            }
+            return raws.emplace(v, std::move(tbl)).first->second;
+        }
+
+    protected:
+        static constexpr size_t           line_wrap = 120;
+        static constexpr std::string_view indent_str = "    ";
+
+        enum class section { kvp, table, table_array };
+
+        std::string                                   *out;
+        int                                            indent  = 0;
+        bool                                           naked   = true;  // nothing written since the last newline
+        bool                                           pending = false; // a blank line is due before the next table
+        std::vector<std::string_view>                  path;
+        std::unordered_map<std::string, ::toml::table> raws;
+        std::deque<std::vector<section>>               member_sections; // by depth, kept to reuse their memory
+
+        void put(std::string_view s) {
+            out->append(s);
+            naked = false;
+        }
+
+        void put_padded(unsigned v, size_t digits) {
+            char buf[16];
+            auto [end, _] = std::to_chars(buf, buf + sizeof(buf), v);
+            for (size_t len = end - buf; len < digits; ++len)
+                out->push_back('0');
+            put({buf, size_t(end - buf)});
+        }
+
+        void newline(bool force = false) {
+            if (!naked || force) {
+                out->push_back('\n');
+                naked = true;
+            }
+        }
+
+        void put_indent() {
+            for (int i = 0; i < indent; ++i)
+                out->append(indent_str);
+            naked = false;
+        }
+
+        void key(std::string_view k) {
+            str(k, false, true);
+        }
+
+        void key_path() {
+            for (size_t i = 0; i < path.size(); ++i) {
+                if (i)
+                    put(".");
+                key(path[i]);
+            }
+        }
+
+        void table_separator() {
+            if (pending) {
+                newline(true);
+                newline(true);
+                pending = false;
+            }
+        }
+
+        /// Calls `fn(ser, v)` with the serializer of a value, an array or a table, through what the value holds
+        template <typename Ser, typename T, typename F>
+        static decltype(auto) resolve(const Ser &ser, const T &v, F &&fn) {
+            if constexpr (Ser::kind == kind::any)
+                return ser.visit(v, [&](const auto &s, const auto &u) { return resolve(s, u, fn); });
+            else
+                return fn(ser, v);
+        }
+
+        template <typename T>
+        static bool is_inline(const T &tbl) {
+            if constexpr (std::is_same_v<T, ::toml::table>)
+                return tbl.is_inline();
+            else
+                return false;
+        }
+
+        template <typename Ser, typename T>
+        static std::string type_name(const Ser &, const T &) {
+            if constexpr (Ser::kind == kind::array)
+                return "array";
+            else if constexpr (std::is_same_v<T, bool>)
+                return "boolean";
+            else if constexpr (std::is_integral_v<T>)
+                return "integer";
+            else if constexpr (std::is_floating_point_v<T>)
+                return "floating-point";
+            else if constexpr (std::is_same_v<T, std::tm>)
+                return "date-time";
+            else
+                return "string";
+        }
+
+        /// Non-empty arrays of tables, the first of which is not inline, are written as `[[key]]` sections
+        template <typename Ser, typename T>
+        static bool is_table_array(const Ser &ser, const T &arr) {
+            const size_t n = ser.size(arr);
+            if (n == 0)
+                return false;
+
+            bool tables = true, first_inline = false;
+            for (size_t i = 0; i < n && tables; ++i)
+                ser.at(arr, i, [&](const auto &s, const auto &e) {
+                    resolve(s, e, [&](const auto &es, const auto &u) {
+                        using S = std::decay_t<decltype(es)>;
+                        if constexpr (S::kind == kind::table) {
+                            if (i == 0)
+                                first_inline = is_inline(u);
+                        } else
+                            tables = false;
+                    });
+                });
+            return tables && !first_inline;
+        }
+
+        template <typename Ser, typename T>
+        static section section_of(const Ser &ser, const T &v) {
+            return resolve(ser, v, [&](const auto &s, const auto &u) {
+                using S = std::decay_t<decltype(s)>;
+                if constexpr (S::kind == kind::table)
+                    return is_inline(u) ? section::kvp : section::table;
+                else if constexpr (S::kind == kind::array)
+                    return is_table_array(s, u) ? section::table_array : section::kvp;
+                else
+                    return section::kvp;
+            });
+        }
+
+        /// Sections of the members of `tbl` in the order of `members`, in the slot of `depth`. A table is laid out once,
+        /// by its parent, and the sections are handed down to `table`.
+        template <typename Ser, typename T>
+        const std::vector<section> &sections_of(const Ser &ser, const T &tbl, size_t depth) {
+            while (member_sections.size() <= depth)
+                member_sections.emplace_back();
+
+            std::vector<section> &res = member_sections[depth];
+            res.clear();
+            ser.members(tbl, [&](std::string_view, const auto &s, const auto &v) { res.push_back(section_of(s, v)); });
+            return res;
+        }
+
+        /// Width of the value written inline, as estimated by toml++, counted up to `line_wrap`
+        template <typename Ser, typename T>
+        static size_t columns_of(const Ser &ser, const T &v) {
+            return resolve(ser, v, [&](const auto &s, const auto &u) -> size_t {
+                using S = std::decay_t<decltype(s)>;
+                if constexpr (S::kind == kind::value)
+                    return s.columns(u);
+                else if constexpr (S::kind == kind::array) {
+                    const size_t n = s.size(u);
+                    if (n == 0)
+                        return 2; // []
+
+                    size_t weight = 3; // [ ]
+                    for (size_t i = 0; i < n && weight < line_wrap; ++i)
+                        s.at(u, i, [&](const auto &es, const auto &e) { weight += columns_of(es, e) + 2; });
+                    return weight;
+                } else {
+                    size_t n = 0, weight = 3; // { }
+                    s.members(u, [&](std::string_view k, const auto &ms, const auto &m) {
+                        ++n;
+                        if (weight < line_wrap)
+                            weight += k.size() + columns_of(ms, m) + 2;
+                    });
+                    return n == 0 ? 2 : weight; // {}
+                }
+            });
+        }
+
+        template <typename Ser, typename T>
+        void array(const Ser &ser, const T &arr) {
+            const size_t n = ser.size(arr);
+            if (n == 0)
+                return put("[]");
+
+            const int  original  = indent;
+            const bool multiline = columns_of(ser, arr) + size_t(original < 0 ? 0 : original) * indent_str.size() >= line_wrap;
+
+            put("[");
+            if (multiline) {
+                if (original < 0)
+                    indent = 0;
+                ++indent;
+            } else
+                put(" ");
+
+            for (size_t i = 0; i < n; ++i) {
+                if (i > 0)
+                    multiline ? put(",") : put(", ");
+                if (multiline) {
+                    newline(true);
+                    put_indent();
+                }
+                ser.at(arr, i, [&](const auto &s, const auto &e) { value(s, e); });
+            }
+
+            if (multiline) {
+                indent = original;
+                newline(true);
+                put_indent();
+            } else
+                put(" ");
+            put("]");
+        }
+
+        template <typename Ser, typename T>
+        void inline_table(const Ser &ser, const T &tbl) {
+            bool first = true;
+            ser.members(tbl, [&](std::string_view k, const auto &s, const auto &v) {
+                put(first ? "{ " : ", ");
+                first = false;
+                key(k);
+                put(" = ");
+                value(s, v);
+            });
+            put(first ? "{}" : " }");
+        }
+
+        /// Writes the members of `tbl`, whose sections are `sections`, see `sections_of`
+        template <typename Ser, typename T>
+        void table(const Ser &ser, const T &tbl, const std::vector<section> &sections, size_t depth) {
+            // values, arrays and inline tables
+            size_t i = 0;
+            ser.members(tbl, [&](std::string_view k, const auto &s, const auto &v) {
+                if (sections[i++] != section::kvp)
+                    return;
+
+                pending = true;
+                newline();
+                put_indent();
+                key(k);
+                put(" = ");
+                value(s, v);
+            });
+
+            // tables, without a header of their own when they only hold tables
+            i = 0;
+            ser.members(tbl, [&](std::string_view k, const auto &s, const auto &v) {
+                if (sections[i++] != section::table)
+                    return;
+
+                resolve(s, v, [&](const auto &cs, const auto &child) {
+                    using S = std::decay_t<decltype(cs)>;
+                    if constexpr (S::kind == kind::table) {
+                        const std::vector<section> &children = sections_of(cs, child, depth + 1);
+
+                        const size_t values    = std::count(children.begin(), children.end(), section::kvp);
+                        const bool   skip_self = values == 0 && !children.empty();
+
+                        path.push_back(k);
+                        if (!skip_self) {
+                            table_separator();
+                            ++indent;
+                            put_indent();
+                            put("[");
+                            key_path();
+                            put("]");
+                            pending = true;
+                        }
+
+                        table(cs, child, children, depth + 1);
+
+                        path.pop_back();
+                        if (!skip_self)
+                            --indent;
+                    }
+                });
+            });
+
+            // arrays of tables
+            i = 0;
+            ser.members(tbl, [&](std::string_view k, const auto &s, const auto &v) {
+                if (sections[i++] != section::table_array)
+                    return;
+
+                resolve(s, v, [&](const auto &cs, const auto &arr) {
+                    using S = std::decay_t<decltype(cs)>;
+                    if constexpr (S::kind == kind::array) {
+                        ++indent;
+                        path.push_back(k);
+                        for (size_t i = 0, n = cs.size(arr); i < n; ++i)
+                            cs.at(arr, i, [&](const auto &es, const auto &e) {
+                                resolve(es, e, [&](const auto &ts, const auto &t) {
+                                    using TS = std::decay_t<decltype(ts)>;
+                                    if constexpr (TS::kind == kind::table) {
+                                        table_separator();
+                                        put_indent();
+                                        put("[[");
+                                        key_path();
+                                        put("]]");
+                                        pending = true;
+                                        table(ts, t, sections_of(ts, t, depth + 1), depth + 1);
+                                    }
+                                });
+                            });
+                        path.pop_back();
+                        --indent;
+                    }
+                });
+            });
+        }
+    };
+
+    inline void Writer::str(std::string_view v, bool allow_multi_line, bool allow_bare) {
+        if (v.empty())
+            return put("''");
+
+        constexpr unsigned line_breaks = 1, tabs = 2, single_quotes = 4, control_chars = 8, non_bare = 16, non_ascii = 32;
+
+        auto is_bare = [](uint32_t c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+        };
+        auto is_nonchar = [](uint32_t c) { return (c >= 0xfdd0 && c <= 0xfdef) || (c & 0xfffe) == 0xfffe; };
+
+        // decodes the code point at `i`, advancing `i`, or returns false on malformed UTF-8
+        auto decode = [&](size_t &i, uint32_t &cp) {
+            const auto c = static_cast<unsigned char>(v[i]);
+            size_t     n = c < 0x80 ? 0 : (c & 0xe0) == 0xc0 ? 1 : (c & 0xf0) == 0xe0 ? 2 : (c & 0xf8) == 0xf0 ? 3 : 4;
+            if (n == 4 || i + n >= v.size())
+                return (++i, false);
+
+            cp = n == 0 ? c : n == 1 ? c & 0x1f : n == 2 ? c & 0x0f : c & 0x07;
+            for (size_t k = 1; k <= n; ++k) {
+                const auto cc = static_cast<unsigned char>(v[i + k]);
+                if ((cc & 0xc0) != 0x80)
+                    return (i += k, false);
+                cp = (cp << 6) | (cc & 0x3f);
+            }
+            i += n + 1;
+            return true;
+        };
+
+        // how the string can be written
+        unsigned traits          = allow_bare ? 0 : non_bare;
+        bool     unicode_allowed = true;
+        for (size_t i = 0; i < v.size();) {
+            uint32_t cp = 0;
+            if (static_cast<unsigned char>(v[i]) >= 0x80)
+                traits |= non_ascii;
+            if (!decode(i, cp)) {
+                // malformed, written as a single-line basic string with the bad bytes escaped
+                traits          = (traits & ~line_breaks) | control_chars | non_bare | non_ascii;
+                unicode_allowed = false;
+                break;
+            }
+
+            if (cp == '\n')
+                traits |= line_breaks;
+            else if (cp == '\t')
+                traits |= tabs;
+            else if (cp == '\'')
+                traits |= single_quotes;
+            else {
+                if (cp <= 0x1f || cp == 0x7f || (cp >= 0x80 && is_nonchar(cp)))
+                    traits |= control_chars;
+                if (!is_bare(cp))
+                    traits |= non_bare;
+            }
+        }
+        if (traits & (line_breaks | tabs | single_quotes))
+            traits |= non_bare;
+
+        if (!(traits & non_bare))
+            return put(v);
+
+        const bool multi_line = allow_multi_line && (traits & line_breaks);
+        const bool literal    = !(traits & control_chars) && (!(traits & single_quotes) || multi_line) &&
+                             (!(traits & line_breaks) || multi_line) && (!(traits & non_ascii) || unicode_allowed);
+        if (literal) {
+            put(multi_line ? "'''" : "'");
+            put(v);
+            put(multi_line ? "'''" : "'");
+            return;
+        }
+
+        static constexpr std::string_view control_escapes[] = {
+            "\\u0000", "\\u0001", "\\u0002", "\\u0003", "\\u0004", "\\u0005", "\\u0006", "\\u0007",
+            "\\b",     "\\t",     "\\n",     "\\u000B", "\\f",     "\\r",     "\\u000E", "\\u000F",
+            "\\u0010", "\\u0011", "\\u0012", "\\u0013", "\\u0014", "\\u0015", "\\u0016", "\\u0017",
+            "\\u0018", "\\u0019", "\\u001A", "\\u001B", "\\u001C", "\\u001D", "\\u001E", "\\u001F",
+        };
+
+        auto put_hex = [&](std::string_view prefix, uint32_t cp, size_t digits) {
+            char buf[8];
+            put(prefix);
+            for (size_t k = digits; k > 0; --k, cp >>= 4)
+                buf[k - 1] = "0123456789ABCDEF"[cp & 0xf];
+            put({buf, digits});
+        };
+
+        put(multi_line ? "\"\"\"" : "\"");
+        for (size_t i = 0; i < v.size();) {
+            const size_t start = i;
+            uint32_t     cp    = 0;
+            if (!decode(i, cp)) {
+                for (size_t k = start; k < i; ++k)
+                    put_hex("\\u", static_cast<unsigned char>(v[k]), 4);
+                continue;
+            }
+
+            if (cp == '"')
+                put("\\\"");
+            else if (cp == '\\')
+                put("\\\\");
+            else if (cp == 0x7f)
+                put("\\u007F");
+            else if (cp == '\t')
+                put("\t");
+            else if (cp == '\n')
+                put(multi_line ? "\n" : "\\n");
+            else if (cp <= 0x1f)
+                put(control_escapes[cp]);
+            else if (cp > 0x7f && (!unicode_allowed || is_nonchar(cp)))
+                cp > 0xffff ? put_hex("\\U", cp, 8) : put_hex("\\u", cp, 4);
+            else
+                put(v.substr(start, i - start));
+        }
+        put(multi_line ? "\"\"\"" : "\"");
+    }
+} // namespace cppxx::toml::marzer_toml
+
+
+namespace cppxx::serde {
+    // bool
+    template <>
+    struct Serialize<toml::marzer_toml::Writer, bool> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::value;
+        toml::marzer_toml::Writer &w;
+
+        void from(bool v) const {
+            w.boolean(v);
+        }
+
+        size_t columns(bool) const {
+            return 5;
+        }
+    };
+
+    // int
+    template <typename T>
+    struct Serialize<toml::marzer_toml::Writer, T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::value;
+        toml::marzer_toml::Writer &w;
+
+        void from(T v) const {
+            w.integer(int64_t(v));
+        }
+
+        size_t columns(T v) const {
+            return toml::marzer_toml::Writer::columns(int64_t(v));
+        }
+    };
+
+    // float
+    template <typename T>
+    struct Serialize<toml::marzer_toml::Writer, T, std::enable_if_t<std::is_floating_point_v<T>>> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::value;
+        toml::marzer_toml::Writer &w;
+
+        void from(T v) const {
+            w.real(double(v));
+        }
+
+        size_t columns(T v) const {
+            return toml::marzer_toml::Writer::columns(double(v));
+        }
+    };
+
+    // string
+    template <>
+    struct Serialize<toml::marzer_toml::Writer, std::string_view> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::value;
+        toml::marzer_toml::Writer &w;
+
+        void from(std::string_view v) const {
+            w.str(v);
+        }
+
+        size_t columns(std::string_view v) const {
+            return toml::marzer_toml::Writer::columns(v);
+        }
+    };
+
+    template <>
+    struct Serialize<toml::marzer_toml::Writer, std::string> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::value;
+        toml::marzer_toml::Writer &w;
+
+        void from(const std::string &v) const {
+            w.str(v);
+        }
+
+        size_t columns(const std::string &v) const {
+            return toml::marzer_toml::Writer::columns(v);
+        }
+    };
+
+    // parsed nodes, for `noserde` fields
+    template <>
+    struct Serialize<toml::marzer_toml::Writer, ::toml::node> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::any;
+        toml::marzer_toml::Writer &w;
+
+        void from(const ::toml::node &v) const {
+            w.value(*this, v);
+        }
+
+        template <typename F>
+        decltype(auto) visit(const ::toml::node &v, F &&fn) const;
+    };
+
+    template <>
+    struct Serialize<toml::marzer_toml::Writer, ::toml::table> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::table;
+        toml::marzer_toml::Writer &w;
+
+        void from(const ::toml::table &v) const {
+            w.value(*this, v);
+        }
+
+        template <typename F>
+        void members(const ::toml::table &v, F &&fn) const {
+            for (auto &&[key, node] : v)
+                fn(std::string_view(key.str()), Serialize<toml::marzer_toml::Writer, ::toml::node>{w}, node);
+        }
+    };
+
+    template <>
+    struct Serialize<toml::marzer_toml::Writer, ::toml::array> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::array;
+        toml::marzer_toml::Writer &w;
+
+        void from(const ::toml::array &v) const {
+            w.value(*this, v);
+        }
+
+        size_t size(const ::toml::array &v) const {
+            return v.size();
+        }
+
+        template <typename F>
+        void at(const ::toml::array &v, size_t i, F &&fn) const {
+            fn(Serialize<toml::marzer_toml::Writer, ::toml::node>{w}, v[i]);
+        }
+    };
+
+    template <typename T>
+    struct Serialize<toml::marzer_toml::Writer, ::toml::value<T>> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::value;
+        toml::marzer_toml::Writer &w;
+
+        void from(const ::toml::value<T> &v) const {
+            if constexpr (std::is_same_v<T, std::string>)
+                w.str(v.get());
+            else if constexpr (std::is_same_v<T, int64_t>)
+                w.integer(v.get(), v.flags());
+            else if constexpr (std::is_same_v<T, double>)
+                w.real(v.get());
+            else if constexpr (std::is_same_v<T, bool>)
+                w.boolean(v.get());
+            else if constexpr (std::is_same_v<T, ::toml::date>)
+                w.date(v.get());
+            else if constexpr (std::is_same_v<T, ::toml::time>)
+                w.time(v.get());
+            else
+                w.date_time(v.get());
+        }
+
+        size_t columns(const ::toml::value<T> &v) const {
+            if constexpr (std::is_same_v<T, std::string>)
+                return toml::marzer_toml::Writer::columns(std::string_view(v.get()));
+            else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, double>)
+                return toml::marzer_toml::Writer::columns(v.get());
+            else if constexpr (std::is_same_v<T, bool>)
+                return 5;
+            else if constexpr (std::is_same_v<T, ::toml::date_time>)
+                return 30;
+            else
+                return 10;
+        }
+    };
+
+    template <typename F>
+    decltype(auto) Serialize<toml::marzer_toml::Writer, ::toml::node>::visit(const ::toml::node &v, F &&fn) const {
+        switch (v.type()) {
+            case ::toml::node_type::table:
+                return fn(Serialize<toml::marzer_toml::Writer, ::toml::table>{w}, *v.as_table());
+            case ::toml::node_type::array:
+                return fn(Serialize<toml::marzer_toml::Writer, ::toml::array>{w}, *v.as_array());
+            case ::toml::node_type::string:
+                return fn(Serialize<toml::marzer_toml::Writer, ::toml::value<std::string>>{w}, *v.as_string());
+            case ::toml::node_type::integer:
+                return fn(Serialize<toml::marzer_toml::Writer, ::toml::value<int64_t>>{w}, *v.as_integer());
+            case ::toml::node_type::floating_point:
+                return fn(Serialize<toml::marzer_toml::Writer, ::toml::value<double>>{w}, *v.as_floating_point());
+            case ::toml::node_type::boolean:
+                return fn(Serialize<toml::marzer_toml::Writer, ::toml::value<bool>>{w}, *v.as_boolean());
+            case ::toml::node_type::date:
+                return fn(Serialize<toml::marzer_toml::Writer, ::toml::value<::toml::date>>{w}, *v.as_date());
+            case ::toml::node_type::time:
+                return fn(Serialize<toml::marzer_toml::Writer, ::toml::value<::toml::time>>{w}, *v.as_time());
+            case ::toml::node_type::date_time:
+                return fn(Serialize<toml::marzer_toml::Writer, ::toml::value<::toml::date_time>>{w}, *v.as_date_time());
+            default:
+                throw error("cannot write a node of no type");
+        }
+    }
+
+    // optional, written as the default value when empty
+    template <typename T>
+    struct Serialize<toml::marzer_toml::Writer, std::optional<T>, std::enable_if_t<std::is_default_constructible_v<T>>> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::any;
+        toml::marzer_toml::Writer &w;
+        bool                       as_int = false; ///< from the `int` option of the field, for an optional enum
+
+        void from(const std::optional<T> &v) const {
+            w.value(*this, v);
+        }
+
+        template <typename F>
+        decltype(auto) visit(const std::optional<T> &v, F &&fn) const {
+            const T empty = {};
+            if constexpr (detail::is_named_enum_v<T>)
+                return fn(Serialize<toml::marzer_toml::Writer, T>{w, as_int}, v.has_value() ? *v : empty);
+            else
+                return fn(Serialize<toml::marzer_toml::Writer, T>{w}, v.has_value() ? *v : empty);
+        }
+    };
+
+    // array
+    template <typename T, size_t N>
+    struct Serialize<toml::marzer_toml::Writer, std::array<T, N>> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::array;
+        toml::marzer_toml::Writer &w;
+
+        void from(const std::array<T, N> &v) const {
+            w.value(*this, v);
+        }
+
+        size_t size(const std::array<T, N> &) const {
+            return N;
+        }
+
+        template <typename F>
+        void at(const std::array<T, N> &v, size_t i, F &&fn) const {
+            try {
+                fn(Serialize<toml::marzer_toml::Writer, T>{w}, v[i]);
+            } catch (error &e) {
+                e.add_context(i);
+                throw;
+            }
+        }
+    };
+
+    template <typename T>
+    struct Serialize<toml::marzer_toml::Writer, std::vector<T>> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::array;
+        toml::marzer_toml::Writer &w;
+
+        void from(const std::vector<T> &v) const {
+            w.value(*this, v);
+        }
+
+        size_t size(const std::vector<T> &v) const {
+            return v.size();
+        }
+
+        template <typename F>
+        void at(const std::vector<T> &v, size_t i, F &&fn) const {
+            try {
+                fn(Serialize<toml::marzer_toml::Writer, T>{w}, v[i]);
+            } catch (error &e) {
+                e.add_context(i);
+                throw;
+            }
+        }
+    };
+
+    // tuple, a table with the keys of its tags, or an array without them
+    template <typename... Ts>
+    struct Serialize<toml::marzer_toml::Writer, std::tuple<Ts...>> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::any;
+        static constexpr size_t    N    = sizeof...(Ts);
+        toml::marzer_toml::Writer &w;
+
+        void from(const std::tuple<Ts...> &tpl) const {
+            w.value(*this, tpl);
+        }
+
+        template <typename F>
+        decltype(auto) visit(const std::tuple<Ts...> &tpl, F &&fn) const {
+            return cppxx::toml::with_tag_info_tuple(tpl, [&](const TagInfoTuple<N> &ti) {
+                if (ti.is_obj)
+                    return fn(as_table(w, ti, tpl), tpl);
+                return fn(as_array(w, ti, tpl), tpl);
+            });
+        }
+
+        /// The fields written, sorted once by key as in a table, for all the walks of the writer over the table
+        class as_table {
+        public:
+            static constexpr auto kind = toml::marzer_toml::Writer::kind::table;
+
+            as_table(toml::marzer_toml::Writer &w, const TagInfoTuple<N> &ti, const std::tuple<Ts...> &tpl)
+                : w(w)
+                , ti(ti) {
+                const std::array<TagInfo, N> &ts = ti.ts;
+                tuple_for_each(tpl, [&](const auto &item, auto i) {
+                    if (written(item, ts[i], true))
+                        order[n++] = i;
+                });
+
+                // the last of the fields with the same key wins
+                std::stable_sort(order.begin(), order.begin() + n, [&](size_t a, size_t b) { return ts[a].key < ts[b].key; });
+                size_t m = 0;
+                for (size_t j = 0; j < n; ++j)
+                    if (j + 1 == n || ts[order[j]].key != ts[order[j + 1]].key)
+                        order[m++] = order[j];
+                n = m;
+            }
+
+            template <typename F>
+            void members(const std::tuple<Ts...> &tpl, F &&fn) const {
+                for (size_t j = 0; j < n; ++j)
+                    tuple_visit(tpl, order[j], [&](const auto &item, auto i) {
+                        const TagInfo &t = ti.ts[i];
+                        try {
+                            field(w, t, detail::get_underlying_value(item), [&](const auto &s, const auto &v) {
+                                fn(t.key, s, v);
+                            });
+                        } catch (error &e) {
+                            e.add_context(t.key);
+                            throw;
+                        }
+                    });
+            }
+
+        protected:
+            toml::marzer_toml::Writer &w;
+            const TagInfoTuple<N>     &ti;
+            std::array<size_t, N>      order = {};
+            size_t                     n     = 0;
+        };
+
+        class as_array {
+        public:
+            static constexpr auto kind = toml::marzer_toml::Writer::kind::array;
+
+            as_array(toml::marzer_toml::Writer &w, const TagInfoTuple<N> &ti, const std::tuple<Ts...> &tpl)
+                : w(w)
+                , ti(ti) {
+                tuple_for_each(tpl, [&](const auto &item, auto i) {
+                    if (written(item, ti.ts[i], false))
+                        order[n++] = i;
+                });
+            }
+
+            size_t size(const std::tuple<Ts...> &) const {
+                return n;
+            }
+
+            template <typename F>
+            void at(const std::tuple<Ts...> &tpl, size_t index, F &&fn) const {
+                tuple_visit(tpl, order[index], [&](const auto &item, auto i) {
+                    try {
+                        field(w, ti.ts[i], detail::get_underlying_value(item), fn);
+                    } catch (error &e) {
+                        e.add_context(i);
+                        throw;
+                    }
+                });
+            }
+
+        protected:
+            toml::marzer_toml::Writer &w;
+            const TagInfoTuple<N>     &ti;
+            std::array<size_t, N>      order = {};
+            size_t                     n     = 0;
+        };
+
+    protected:
+        template <typename I>
+        static bool written(const I &item, const TagInfo &t, bool is_obj) {
+            const auto &v = detail::get_underlying_value(item);
+            using T       = std::decay_t<decltype(v)>;
+            return is_serializable_v<toml::marzer_toml::Writer, T> && !(is_obj && t.key == "") &&
+                   !(t.omitempty && detail::is_empty_value(v));
+        }
+
+        // calls `fn(ser, v)` with the serializer given by the options of the field
+        template <typename T, typename F>
+        static void field(toml::marzer_toml::Writer &w, const TagInfo &t, const T &v, F &&fn) {
+            if (t.noserde) {
+                if constexpr (std::is_same_v<T, std::string>)
+                    return fn(Serialize<toml::marzer_toml::Writer, ::toml::table>{w}, w.raw(v));
+                else
+                    throw error("field with tag `noserde` can only be serialized from std::string");
+            }
+
+            detail::check_as_int<T>(t.as_int);
+            if constexpr (detail::takes_as_int_v<T>)
+                fn(Serialize<toml::marzer_toml::Writer, T>{w, t.as_int}, v);
+            else if constexpr (is_serializable_v<toml::marzer_toml::Writer, T>)
+                fn(Serialize<toml::marzer_toml::Writer, T>{w}, v);
+        }
+    };
+
+    // variant
+    template <typename... T>
+    struct Serialize<toml::marzer_toml::Writer, std::variant<T...>> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::any;
+        toml::marzer_toml::Writer &w;
+
+        void from(const std::variant<T...> &v) const {
+            w.value(*this, v);
+        }
+
+        template <typename F>
+        decltype(auto) visit(const std::variant<T...> &v, F &&fn) const {
+            return std::visit(
+                [&](const auto &var) { return fn(Serialize<toml::marzer_toml::Writer, std::decay_t<decltype(var)>>{w}, var); },
+                v
+            );
+        }
+    };
+
+    // table
+    template <typename T>
+    struct Serialize<toml::marzer_toml::Writer, std::unordered_map<std::string, T>> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::table;
+        toml::marzer_toml::Writer &w;
+
+        void from(const std::unordered_map<std::string, T> &v) const {
+            w.value(*this, v);
+        }
+
+        template <typename F>
+        void members(const std::unordered_map<std::string, T> &v, F &&fn) const {
+            using item_t = typename std::unordered_map<std::string, T>::value_type;
+
+            std::vector<const item_t *> items;
+            items.reserve(v.size());
+            for (auto &item : v)
+                items.push_back(&item);
+            std::sort(items.begin(), items.end(), [](const item_t *a, const item_t *b) { return a->first < b->first; });
+
+            for (const item_t *item : items)
+                try {
+                    fn(std::string_view(item->first), Serialize<toml::marzer_toml::Writer, T>{w}, item->second);
+                } catch (error &e) {
+                    e.add_context(item->first);
+                    throw;
+                }
+        }
+    };
+
+    // std::tm, as a local date-time
+    template <>
+    struct Serialize<toml::marzer_toml::Writer, std::tm> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::value;
+        toml::marzer_toml::Writer &w;
+
+        void from(const std::tm &tm) const {
+            ::toml::date_time dt;
+
+            dt.date.year  = tm.tm_year + 1900;
+            dt.date.month = tm.tm_mon + 1;
+            dt.date.day   = tm.tm_mday;
+
+            dt.time.hour   = tm.tm_hour;
+            dt.time.minute = tm.tm_min;
+            dt.time.second = tm.tm_sec;
+
+            w.date_time(dt);
+        }
+
+        size_t columns(const std::tm &) const {
+            return 30;
+        }
+    };
+
+#ifdef BOOST_PFR_HPP
+    template <typename S>
+    struct Serialize<toml::marzer_toml::Writer, S, std::enable_if_t<std::is_aggregate_v<S> && !std::is_same_v<S, std::tm>>> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::any;
+        toml::marzer_toml::Writer &w;
+
+        void from(const S &v) const {
+            w.value(*this, v);
+        }
+
+        template <typename F>
+        decltype(auto) visit(const S &v, F &&fn) const {
+            auto tpl = boost::pfr::structure_tie(v);
+            return fn(Serialize<toml::marzer_toml::Writer, decltype(tpl)>{w}, tpl);
+        }
+    };
+#endif
+
+#ifdef NEARGYE_MAGIC_ENUM_HPP
+    // enum
+    template <typename S>
+    struct Serialize<toml::marzer_toml::Writer, S, std::enable_if_t<std::is_enum_v<S>>> {
+        static constexpr auto      kind = toml::marzer_toml::Writer::kind::value;
+        toml::marzer_toml::Writer &w;
+        bool                       as_int = false; ///< from the `int` option of the field
+
+        void from(const S &v) const {
+            if (as_int)
+                return w.integer(int64_t(std::underlying_type_t<S>(v)));
+            w.str(magic_enum::enum_name(v));
+        }
+
+        size_t columns(const S &v) const {
+            if (as_int)
+                return toml::marzer_toml::Writer::columns(int64_t(std::underlying_type_t<S>(v)));
+            return toml::marzer_toml::Writer::columns(magic_enum::enum_name(v));
+        }
+    };
+#endif
+} // namespace cppxx::serde
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
 namespace cppxx {
     template <typename T>
@@ -24,14 +25,36 @@ namespace cppxx {
     template <typename F, typename Tuple>
     inline constexpr bool is_invocable_with_tuple_v = is_invocable_with_tuple<F, Tuple>::value;
 
+    template <typename Tuple, typename F, std::size_t... I>
+    constexpr void tuple_for_each(Tuple &&tpl, F &&fn, std::index_sequence<I...>) {
+        (fn(std::get<I>(tpl), std::integral_constant<std::size_t, I>{}), ...);
+    }
+
+    /// Calls `fn(item, i)` for every item of the tuple, where `i` is a `std::integral_constant<size_t, I>` so that it can
+    /// be used in constant expressions.
     template <typename Tuple, typename F>
     constexpr void tuple_for_each(Tuple &&tpl, F &&fn) {
-        std::apply(
-            [&](auto &...item) {
-                std::size_t i = 0;
-                (fn(item, i++), ...);
-            },
-            std::forward<Tuple>(tpl)
+        tuple_for_each(
+            std::forward<Tuple>(tpl),
+            std::forward<F>(fn),
+            std::make_index_sequence<std::tuple_size_v<std::remove_reference_t<Tuple>>>{}
+        );
+    }
+
+    template <typename Tuple, typename F, std::size_t... I>
+    constexpr void tuple_visit(Tuple &&tpl, std::size_t i, F &&fn, std::index_sequence<I...>) {
+        ((i == I ? fn(std::get<I>(tpl), std::integral_constant<std::size_t, I>{}) : void()), ...);
+    }
+
+    /// Calls `fn(item, i)` for the item at runtime index `i` of the tuple, where `i` is passed to `fn` as a
+    /// `std::integral_constant<size_t, I>`. Does nothing if `i` is out of range.
+    template <typename Tuple, typename F>
+    constexpr void tuple_visit(Tuple &&tpl, std::size_t i, F &&fn) {
+        tuple_visit(
+            std::forward<Tuple>(tpl),
+            i,
+            std::forward<F>(fn),
+            std::make_index_sequence<std::tuple_size_v<std::remove_reference_t<Tuple>>>{}
         );
     }
 } // namespace cppxx
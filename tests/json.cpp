@@ -1,9 +1,19 @@
 #include <cpp++/json/yy_json.h>
+#include <cpp++/json/yy_json_ndjson.h>
+#include <cpp++/json/yy_json_lazy.h>
 #include <cpp++/json/nlohmann_json.h>
+#include <cpp++/json/nlohmann_json_binary.h>
+#include <cpp++/serde/snapshot.h>
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
 
 
 using namespace cppxx;
+using namespace cppxx::literals;
 
 namespace {
 
@@ -32,6 +42,52 @@ namespace {
 
     static_assert(std::is_aggregate_v<Person>, "Person must be pure aggregate");
 
+    // same as Person, with the tags given at compile time
+    struct StaticPerson {
+        Tag<std::string, decltype("json:`name`"_tag)>                   name;
+        Tag<int, decltype("json:`age`"_tag)>                            age;
+        Tag<std::optional<std::string>, decltype("json:`address`"_tag)> address;
+        Tag<std::string, decltype("json:`department,skipmissing`"_tag)> department = {"unset"};
+        Tag<int, decltype("json:`salary,omitempty`"_tag)>               salary;
+        Tag<std::tm, decltype("json:`createdAt`"_tag)>                  created_at;
+
+        int dummy = 42;
+    };
+
+    // the tags take no room, so the layout is the same as the plain struct
+    struct PlainPerson {
+        std::string                name;
+        int                        age;
+        std::optional<std::string> address;
+        std::string                department;
+        int                        salary;
+        std::tm                    created_at;
+        int                        dummy;
+    };
+
+    static_assert(sizeof(Tag<int, decltype("json:`age`"_tag)>) == sizeof(int));
+    static_assert(sizeof(StaticPerson) == sizeof(PlainPerson));
+
+    using StaticPersonTuple = decltype(boost::pfr::structure_tie(std::declval<StaticPerson &>()));
+
+    static_assert(cppxx::serde::has_static_tags_v<StaticPersonTuple>);
+    static_assert(!cppxx::serde::has_static_tags_v<decltype(boost::pfr::structure_tie(std::declval<Person &>()))>);
+
+    constexpr auto static_person_tags = cppxx::serde::static_tag_info_tuple_v<cppxx::json::TagKey, StaticPersonTuple>;
+
+    static_assert(static_person_tags.is_obj);
+    static_assert(static_person_tags.ts[0].key == "name");
+    static_assert(static_person_tags.ts[3].key == "department" && static_person_tags.ts[3].skipmissing);
+    static_assert(static_person_tags.ts[4].key == "salary" && static_person_tags.ts[4].omitempty);
+    static_assert(static_person_tags.ts[6].key == "");
+
+    constexpr auto static_person_keys = cppxx::serde::static_key_map_v<cppxx::json::TagKey, StaticPersonTuple>;
+
+    static_assert(static_person_keys.find("name") == 0);
+    static_assert(static_person_keys.find("createdAt") == 5);
+    static_assert(static_person_keys.find("dummy") == static_person_keys.npos);
+    static_assert(static_person_keys.find("") == static_person_keys.npos);
+
     static_assert(cppxx::serde::is_serializable<yyjson_mut_val, Person>::value);
     static_assert(cppxx::serde::is_deserializable<yyjson_val, Person>::value);
 
@@ -46,6 +102,106 @@ namespace {
 
     static_assert(cppxx::serde::is_serializable<nlohmann::json, std::unordered_map<std::string, std::string>>::value);
 
+    // borrowed strings, see `yy_json::parse_insitu`
+    struct LogLine {
+        Tag<std::string_view> level   = "json:`level`";
+        Tag<std::string_view> message = "json:`message`";
+        Tag<int>              code    = "json:`code`";
+    };
+
+    static_assert(cppxx::serde::is_deserializable<yyjson_val, LogLine>::value);
+
+    // only `yy_json::Document` may decode them, the other entry points free the document first
+    static_assert(json::yy_json::detail::borrows<LogLine>());
+    static_assert(json::yy_json::detail::borrows<std::vector<std::optional<LogLine>>>());
+    static_assert(!json::yy_json::detail::borrows<Person>());
+
+    // alternatives told apart by the kind of the node and by their keys
+    struct Click {
+        Tag<int> x = "json:`x`";
+        Tag<int> y = "json:`y`";
+    };
+
+    struct KeyPress {
+        Tag<std::string> key = "json:`key`";
+    };
+
+    using Input = std::variant<int, std::string, Click, KeyPress>;
+
+    // alternatives of the same shape told apart by a discriminator, see `tag=`
+    struct Login {
+        Tag<std::string> kind = {"json:`kind`", "login"};
+        Tag<std::string> user = "json:`user`";
+    };
+
+    struct Logout {
+        Tag<std::string> kind = {"json:`kind`", "logout"};
+        Tag<std::string> user = "json:`user`";
+    };
+
+    struct Audit {
+        Tag<std::variant<Login, Logout>> event = "json:`event,tag=kind`";
+    };
+
+    // the field options reach the value inside an optional, see `nlohmann_json_parse_sax`
+    struct MaybeAudit {
+        Tag<std::optional<std::variant<Login, Logout>>> event = "json:`event,tag=kind,skipmissing`";
+    };
+
+    static_assert(cppxx::serde::accepted_kinds_v<std::optional<int>> ==
+                  (cppxx::serde::node_kind::null | cppxx::serde::node_kind::uint | cppxx::serde::node_kind::sint));
+
+    enum class Status { active, suspended, deleted };
+
+    // by name, or by value with the `int` option
+    struct Account {
+        Tag<std::string> name   = "json:`name`";
+        Tag<Status>      status = "json:`status`";
+        Tag<Status>      prev   = "json:`prev,int`";
+    };
+
+    // `int` on an optional enum applies to the enum
+    struct Suspension {
+        Tag<std::optional<Status>> prev = "json:`prev,int`";
+        Tag<std::optional<Status>> next = "json:`next,int`";
+    };
+
+    // `int` on a field that is not an enum is an error
+    struct BadAccount {
+        Tag<std::string> prev = "json:`prev,int`";
+    };
+
+    static_assert(cppxx::serde::enum_name_map_v<Status>.find("deleted") == 2);
+    static_assert(cppxx::serde::enum_name_map_v<Status>.find("unknown") == cppxx::serde::enum_name_map_v<Status>.npos);
+
+    constexpr const char *json_account = R"json({"name":"Sucipto","status":"suspended","prev":0})json";
+
+    // sections decoded on first access
+    struct Order {
+        Tag<int>                          id    = "json:`id`";
+        Tag<json::lazy<std::vector<int>>> items = "json:`items`";
+    };
+
+    // opaque payload passed through as JSON text
+    struct Envelope {
+        Tag<std::string> kind    = "json:`kind`";
+        Tag<std::string> payload = "json:`payload,noserde`";
+    };
+
+    // snapshot layouts that differ only in an enum or a default
+    enum class Level { low, high };
+    enum class RenumberedLevel { low = 1, high };
+
+    struct Limits {
+        Tag<std::string> department = {"json:`department,skipmissing`", "unset"};
+    };
+
+    struct OtherDefaultLimits {
+        Tag<std::string> department = {"json:`department,skipmissing`", "none"};
+    };
+
+    constexpr const char *json_inputs = R"json([1, "a", {"key": "k"}, {"x": 1, "y": 2}])json";
+
     constexpr const char *json_full = R"json(
     {
       "name": "Sucipto",
@@ -68,6 +224,27 @@ namespace {
     }
     )json";
 
+
+    // keys out of order, unknown and duplicated keys
+    constexpr const char *json_shuffled = R"json(
+    {
+      "createdAt": "2024-01-02T03:04:05Z",
+      "unknown": [1, 2, 3],
+      "address": null,
+      "salary": 1000,
+      "name": "Sucipto",
+      "department": "Engineering",
+      "age": 24,
+      "name": "Sugeng"
+    }
+    )json";
+
+    constexpr const char *json_missing_age = R"json(
+    {
+      "name": "Sucipto",
+      "createdAt": "2024-01-02T03:04:05Z"
+    }
+    )json";
 } // namespace
 
 
@@ -165,3 +342,808 @@ TEST(cppxx, yy_json_round_trip) {
     EXPECT_EQ(p2.age(), p1.age());
     EXPECT_EQ(p2.department(), p1.department());
 }
+
+
+TEST(cppxx, yy_json_reuse_parser_dumper) {
+    auto &parser = json::yy_json::Parser::local();
+    auto &dumper = json::yy_json::Dumper::local();
+    EXPECT_EQ(&parser, &json::yy_json::Parser::local());
+
+    for (int i = 0; i < 3; ++i) {
+        Person p = parser.parse<Person>(json_full);
+        EXPECT_EQ(p.name(), "Sucipto");
+
+        const std::string &dumped = dumper.dump(p);
+        EXPECT_EQ(dumped, json::yy_json::dump(p));
+
+        Person p2 = parser.parse<Person>(dumped);
+        EXPECT_EQ(p2.age(), p.age());
+    }
+
+    // the parser stays usable after an error
+    EXPECT_THROW((void)parser.parse<Person>("{"), cppxx::serde::error);
+    EXPECT_EQ(parser.parse<Person>(json_full).age(), 24);
+}
+
+TEST(cppxx, yy_json_parse_insitu) {
+    auto line = json::yy_json::parse_insitu<LogLine>(R"({"level": "warn", "message": "disk \"sda\" full", "code": 28})");
+
+    EXPECT_EQ(line->level(), "warn");
+    EXPECT_EQ(line->message(), "disk \"sda\" full");
+    EXPECT_EQ(line->code(), 28);
+
+    // the views still point into the buffer owned by the moved document
+    auto moved = std::move(line);
+    EXPECT_EQ(moved->message(), "disk \"sda\" full");
+    EXPECT_EQ(json::yy_json::dump(*moved), R"({"level":"warn","message":"disk \"sda\" full","code":28})");
+
+    EXPECT_THROW((void)json::yy_json::parse_insitu<LogLine>(R"({"level": 1})"), cppxx::serde::error);
+}
+
+TEST(cppxx, yy_json_parse_from_file) {
+    const std::string path = ::testing::TempDir() + "cppxx_person.json";
+    {
+        std::ofstream file(path);
+        file << json_full;
+    }
+
+    // mapped and parsed in situ
+    Person p = json::yy_json::parse_from_file<Person>(path);
+    EXPECT_EQ(p.name(), "Sucipto");
+    EXPECT_EQ(p.age(), 24);
+
+    // the file itself is left untouched
+    EXPECT_EQ(json::yy_json::parse_from_file<Person>(path).name(), "Sucipto");
+    std::remove(path.c_str());
+
+    EXPECT_THROW((void)json::yy_json::parse_from_file<Person>(path), cppxx::serde::error);
+}
+
+TEST(cppxx, yy_json_ndjson) {
+    namespace ndjson = json::yy_json::ndjson;
+
+    const std::string path = ::testing::TempDir() + "cppxx_people.jsonl";
+    std::remove(path.c_str());
+    {
+        ndjson::writer<Person> out(path, YYJSON_WRITE_PRETTY, 64);
+        Person                 p = json::yy_json::parse<Person>(json_full);
+        for (int i = 0; i < 100; ++i) {
+            p.age() = i;
+            out.write(p);
+        }
+    }
+    {
+        std::ofstream file(path, std::ios::app);
+        file << "\n{\"name\": \"broken\"\n" << json::yy_json::dump(json::yy_json::parse<Person>(json_full))
+             << " // with a comment\n";
+    }
+
+    // small buffer, grown to fit a line, and the read flags allowing the comment
+    ndjson::reader<Person> in(path, ndjson::on_error::skip, YYJSON_READ_ALLOW_COMMENTS, 16);
+    int                    n = 0;
+    for (const Person &p : in) {
+        if (n < 100) {
+            EXPECT_EQ(p.name(), "Sucipto");
+            EXPECT_EQ(p.age(), n);
+        }
+        ++n;
+    }
+    EXPECT_EQ(n, 101);
+    EXPECT_EQ(in.lines(), 103u);
+    EXPECT_EQ(in.skipped(), 1u);
+
+    ndjson::reader<Person> strict(path);
+    Person                 p;
+    for (int i = 0; i < 100; ++i)
+        ASSERT_TRUE(strict.next(p));
+    try {
+        strict.next(p);
+        FAIL() << "expected an error";
+    } catch (const cppxx::serde::error &e) {
+        EXPECT_EQ(e.context, "[101]");
+    }
+
+    // every line is a record of its own, whatever the lines before it set, even a skipped one
+    {
+        std::ofstream file(path, std::ios::trunc);
+        const char   *created = R"("createdAt": "2024-01-02T03:04:05Z")";
+        file << R"({"name": "a", "age": 1, "address": null, "department": "HR", "salary": 1, )" << created << "}\n"
+             << R"({"name": "b", "address": null, "department": "Finance", )" << created << "}\n"
+             << R"({"name": "c", "age": 3, "address": null, "salary": 3, )" << created << "}\n";
+    }
+    ndjson::reader<Person> fresh(path, ndjson::on_error::skip);
+    ASSERT_TRUE(fresh.next(p));
+    EXPECT_EQ(p.department(), "HR");
+    ASSERT_TRUE(fresh.next(p));
+    EXPECT_EQ(p.name(), "c");
+    EXPECT_EQ(p.department(), "unset");
+    EXPECT_EQ(fresh.skipped(), 1u);
+
+    std::remove(path.c_str());
+}
+
+TEST(cppxx, yy_json_parse_parallel) {
+    std::vector<Person> people(2000);
+    for (size_t i = 0; i < people.size(); ++i) {
+        people[i]              = json::yy_json::parse<Person>(json_full);
+        people[i].age()        = int(i);
+        people[i].department() = i % 2 ? "Engineering" : "Finance";
+    }
+    std::string src = json::yy_json::dump(people);
+
+    std::vector<Person> parsed;
+    cppxx::serde::Parse<yyjson_doc, std::string>{src, YYJSON_READ_NOFLAG, nullptr, 4}.into(parsed);
+    ASSERT_EQ(parsed.size(), people.size());
+    for (size_t i = 0; i < people.size(); ++i) {
+        EXPECT_EQ(parsed[i].age(), int(i));
+        EXPECT_EQ(parsed[i].department(), people[i].department());
+    }
+
+    // the error of the lowest index is reported, whichever thread finds it first
+    people[1500].name() = "";
+    people[700].name()  = "";
+    src                 = json::yy_json::dump(people);
+    for (size_t at : {size_t(1500), size_t(700)}) {
+        const std::string needle = R"("name":"","age":)" + std::to_string(at);
+        src.replace(src.find(needle), needle.size(), R"("name":"","age":"x")");
+    }
+    try {
+        cppxx::serde::Parse<yyjson_doc, std::string>{src, YYJSON_READ_NOFLAG, nullptr, 0}.into(parsed);
+        FAIL() << "expected an error";
+    } catch (const cppxx::serde::error &e) {
+        EXPECT_EQ(e.context, "[700].age");
+    }
+}
+
+TEST(cppxx, yy_json_dump_parallel) {
+    std::vector<Person> people(2000);
+    for (size_t i = 0; i < people.size(); ++i) {
+        people[i]       = json::yy_json::parse<Person>(json_full);
+        people[i].age() = int(i);
+    }
+
+    for (yyjson_write_flag flag : {YYJSON_WRITE_NOFLAG, YYJSON_WRITE_PRETTY | YYJSON_WRITE_NEWLINE_AT_END}) {
+        const std::string sequential = json::yy_json::dump(people, flag);
+        EXPECT_EQ((cppxx::serde::Dump<yyjson_mut_doc, std::string>{flag, false, 4}.from(people)), sequential);
+        EXPECT_EQ((cppxx::serde::Dump<yyjson_mut_doc, std::string>{flag, true, 0}.from(people)), sequential);
+
+        const std::string path = ::testing::TempDir() + "cppxx_people.json";
+        {
+            std::FILE *file = std::fopen(path.c_str(), "w");
+            ASSERT_NE(file, nullptr);
+            json::yy_json::dump_to(fileno(file), people, flag, 3);
+            std::fclose(file);
+        }
+        std::ifstream     file(path);
+        std::stringstream written;
+        written << file.rdbuf();
+        EXPECT_EQ(written.str(), sequential);
+        std::remove(path.c_str());
+    }
+
+    // the error of the lowest index is reported
+    people[1500].name() = "\xff";
+    people[700].name()  = "\xff";
+    try {
+        (void)cppxx::serde::Dump<yyjson_mut_doc, std::string>{YYJSON_WRITE_NOFLAG, false, 4}.from(people);
+        FAIL() << "expected an error";
+    } catch (const cppxx::serde::error &e) {
+        EXPECT_EQ(e.context, "[700].name");
+    }
+}
+
+TEST(cppxx, yy_json_try_parse) {
+    auto ok = json::yy_json::try_parse<Person>(json_full);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(ok->name(), "Sucipto");
+
+    auto syntax = json::yy_json::try_parse<Person>("{\"name\": ");
+    ASSERT_FALSE(syntax);
+    EXPECT_TRUE(syntax.error().context.empty());
+
+    Person p;
+    auto   missing = json::yy_json::try_parse(json_missing_age, p);
+    ASSERT_FALSE(missing);
+    EXPECT_EQ(missing.error().context, ".age");
+
+    auto dumped = json::yy_json::try_dump(*ok);
+    ASSERT_TRUE(dumped);
+    EXPECT_EQ(*dumped, json::yy_json::dump(*ok));
+
+    ok->name() = "\xff";
+    EXPECT_FALSE(json::yy_json::try_dump(*ok));
+}
+
+
+TEST(cppxx, nlohmann_json_try_parse) {
+    Person p;
+    EXPECT_TRUE((cppxx::serde::Parse<nlohmann::json, std::string>{json_full}.try_into(p)));
+    EXPECT_EQ(p.name(), "Sucipto");
+
+    auto syntax = cppxx::serde::Parse<nlohmann::json, std::string>{"{\"name\": "}.try_into(p);
+    ASSERT_FALSE(syntax);
+    EXPECT_NE(syntax.error().msg.find("parse error"), std::string::npos);
+
+    auto missing = cppxx::serde::Parse<nlohmann::json, std::string>{json_missing_age}.try_into(p);
+    ASSERT_FALSE(missing);
+    EXPECT_EQ(missing.error().context, ".age");
+
+    auto dumped = cppxx::serde::Dump<nlohmann::json, std::string>{}.try_from(p);
+    ASSERT_TRUE(dumped);
+    EXPECT_EQ(*dumped, (cppxx::serde::Dump<nlohmann::json, std::string>{}.from(p)));
+}
+
+
+TEST(cppxx, serde_error_path) {
+    cppxx::serde::error e("name", "oops");
+    e.add_context(3).add_context("people");
+
+    EXPECT_EQ(e.context, ".people[3].name");
+    EXPECT_EQ(e.context.str(), ".people[3].name");
+    EXPECT_STREQ(e.what(), "Error at .people[3].name: oops");
+    EXPECT_STREQ(cppxx::serde::error("oops").what(), "Error at <root>: oops");
+}
+
+TEST(cppxx, yy_json_dump_flags) {
+    Person p;
+    p.name() = "Su\"cipto/\n é";
+    p.age()  = 24;
+
+    std::string dumped = json::yy_json::dump(p);
+    EXPECT_NE(dumped.find(R"("name":"Su\"cipto/\n é")"), std::string::npos);
+    EXPECT_EQ(dumped.front(), '{');
+    EXPECT_EQ(dumped.back(), '}');
+
+    std::string escaped = json::yy_json::dump(p, YYJSON_WRITE_ESCAPE_UNICODE | YYJSON_WRITE_ESCAPE_SLASHES);
+    EXPECT_NE(escaped.find(R"("name":"Su\"cipto\/\n \u00E9")"), std::string::npos);
+
+    std::string pretty = json::yy_json::dump(p, YYJSON_WRITE_PRETTY | YYJSON_WRITE_NEWLINE_AT_END);
+    EXPECT_NE(pretty.find("{\n    \"name\": "), std::string::npos);
+    EXPECT_EQ(pretty.back(), '\n');
+
+    std::string two_spaces = json::yy_json::dump(p, YYJSON_WRITE_PRETTY_TWO_SPACES);
+    EXPECT_NE(two_spaces.find("{\n  \"name\": "), std::string::npos);
+
+    // same output with the exact-size pre-pass
+    std::string exact = cppxx::serde::Dump<yyjson_mut_doc, std::string>{YYJSON_WRITE_PRETTY, true}.from(p);
+    EXPECT_EQ(exact, json::yy_json::dump(p, YYJSON_WRITE_PRETTY));
+
+    p.name() = "\xff";
+    EXPECT_THROW((void)json::yy_json::dump(p), cppxx::serde::error);
+}
+
+TEST(cppxx, yy_json_dump_reals) {
+    // written by yyjson from a mutable document
+    auto yyjson_write = [](const std::vector<double> &v, yyjson_write_flag flag) {
+        yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+        yyjson_mut_doc_set_root(doc, cppxx::serde::Serialize<yyjson_mut_val, std::vector<double>>{doc}.from(v));
+        size_t      len = 0;
+        char       *str = yyjson_mut_write_opts(doc, flag, nullptr, &len, nullptr);
+        std::string res = str ? std::string(str, len) : std::string();
+        std::free(str);
+        yyjson_mut_doc_free(doc);
+        return res;
+    };
+
+    // whole numbers, the bounds of the decimal notation, very large and very small numbers
+    const std::vector<double> reals = {
+        0.0,
+        -0.0,
+        1.0,
+        -1.0,
+        0.1,
+        1.5,
+        1e15,
+        1e16,
+        1e20,
+        1e21,
+        1.5e21,
+        1e-6,
+        1.5e-6,
+        1e-7,
+        1.25e-7,
+        1e300,
+        -2.5e-300,
+        0.30000000000000004,
+        9007199254740993.0,
+        std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::min(),
+        std::numeric_limits<double>::denorm_min(),
+    };
+    EXPECT_EQ(json::yy_json::dump(reals), yyjson_write(reals, YYJSON_WRITE_NOFLAG));
+    EXPECT_EQ(json::yy_json::dump(reals), "[0.0,-0.0,1.0,-1.0,0.1,1.5,1000000000000000.0,10000000000000000.0,"
+                                          "100000000000000000000.0,1e21,1.5e21,0.000001,0.0000015,1e-7,1.25e-7,1e300,"
+                                          "-2.5e-300,0.30000000000000004,9007199254740992.0,1.7976931348623157e308,"
+                                          "2.2250738585072014e-308,5e-324]");
+
+    const std::vector<double> special = {
+        std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity()
+    };
+    for (yyjson_write_flag flag : {YYJSON_WRITE_ALLOW_INF_AND_NAN, YYJSON_WRITE_INF_AND_NAN_AS_NULL})
+        EXPECT_EQ(json::yy_json::dump(special, flag), yyjson_write(special, flag));
+    EXPECT_THROW((void)json::yy_json::dump(special), cppxx::serde::error);
+
+#ifdef YYJSON_WRITE_FP_TO_FIXED
+    // single precision as yyjson writes it, fixed-point not supported
+    const std::vector<double> floats = {0.0, 1.0, 0.1, 1.0 / 3, 1e20, 1e21, 1e-7, 3.4e38, -1.5e-40};
+    EXPECT_EQ(json::yy_json::dump(floats, YYJSON_WRITE_FP_TO_FLOAT), yyjson_write(floats, YYJSON_WRITE_FP_TO_FLOAT));
+    EXPECT_THROW((void)json::yy_json::dump(reals, YYJSON_WRITE_FP_TO_FIXED(3)), cppxx::serde::error);
+#endif
+}
+
+
+TEST(cppxx, yy_json_static_tags) {
+    StaticPerson p = json::yy_json::parse<StaticPerson>(json_missing_department);
+
+    EXPECT_EQ(p.name(), "Sucipto");
+    EXPECT_EQ(p.age(), 24);
+    ASSERT_TRUE(p.address().has_value());
+    EXPECT_EQ(*p.address(), "Jakarta");
+    EXPECT_EQ(p.department(), "unset");
+    EXPECT_EQ(p.salary(), 1000);
+    EXPECT_EQ(p.created_at().tm_year + 1900, 2024);
+
+    p.salary() = 0;
+    EXPECT_EQ(json::yy_json::dump(p), json::yy_json::dump(json::yy_json::parse<Person>(json::yy_json::dump(p))));
+    EXPECT_EQ(json::yy_json::dump(p).find("salary"), std::string::npos);
+}
+
+
+TEST(cppxx, nlohmann_json_static_tags) {
+    StaticPerson p = nlohmann::json::parse(json_missing_department);
+
+    EXPECT_EQ(p.name(), "Sucipto");
+    EXPECT_EQ(p.age(), 24);
+    EXPECT_EQ(p.department(), "unset");
+    EXPECT_EQ(p.salary(), 1000);
+
+    EXPECT_EQ(nlohmann::json(p).dump(), nlohmann::json(nlohmann::json::parse(json_missing_department).get<Person>()).dump());
+}
+
+
+TEST(cppxx, yy_json_parse_shuffled) {
+    Person p = json::yy_json::parse<Person>(json_shuffled);
+
+    // the first of duplicated keys wins
+    EXPECT_EQ(p.name(), "Sucipto");
+    EXPECT_EQ(p.age(), 24);
+    EXPECT_EQ(p.department(), "Engineering");
+    EXPECT_EQ(p.salary(), 1000);
+
+    StaticPerson s = json::yy_json::parse<StaticPerson>(json_shuffled);
+
+    EXPECT_EQ(s.name(), "Sucipto");
+    EXPECT_EQ(s.age(), 24);
+    EXPECT_EQ(s.department(), "Engineering");
+    EXPECT_EQ(s.salary(), 1000);
+
+    try {
+        s = json::yy_json::parse<StaticPerson>(json_missing_age);
+        FAIL() << "expected an error";
+    } catch (const cppxx::serde::error &e) {
+        EXPECT_EQ(e.context, ".age");
+    }
+}
+
+
+TEST(cppxx, nlohmann_json_parse_shuffled) {
+    StaticPerson p = nlohmann::json::parse(json_shuffled);
+
+    EXPECT_EQ(p.age(), 24);
+    EXPECT_EQ(p.department(), "Engineering");
+    EXPECT_EQ(p.salary(), 1000);
+    EXPECT_FALSE(p.address().has_value());
+
+    try {
+        Person p = nlohmann::json::parse(json_missing_age);
+        FAIL() << "expected an error";
+    } catch (const cppxx::serde::error &e) {
+        EXPECT_EQ(e.context, ".age");
+    }
+}
+
+
+TEST(cppxx, yy_json_parse_variant) {
+    auto inputs = json::yy_json::parse<std::vector<Input>>(json_inputs);
+
+    ASSERT_EQ(inputs.size(), 4u);
+    EXPECT_EQ(std::get<int>(inputs[0]), 1);
+    EXPECT_EQ(std::get<std::string>(inputs[1]), "a");
+    EXPECT_EQ(std::get<KeyPress>(inputs[2]).key(), "k");
+    EXPECT_EQ(std::get<Click>(inputs[3]).y(), 2);
+
+    auto audit = json::yy_json::parse<Audit>(R"({"event": {"user": "joko", "kind": "logout"}})");
+    EXPECT_EQ(std::get<Logout>(audit.event()).user(), "joko");
+
+    auto unknown = json::yy_json::try_parse<Audit>(R"({"event": {"user": "joko", "kind": "reboot"}})");
+    ASSERT_FALSE(unknown);
+    EXPECT_EQ(unknown.error().context, ".event.kind");
+
+    auto mismatch = json::yy_json::try_parse<Input>("1.5");
+    ASSERT_FALSE(mismatch);
+    EXPECT_NE(mismatch.error().msg.find("got `real`"), std::string::npos);
+
+    auto nested = json::yy_json::try_parse<std::vector<Input>>(R"([1, {"x": 1, "y": "2"}])");
+    ASSERT_FALSE(nested);
+    EXPECT_EQ(nested.error().context, "[1].y");
+}
+
+
+TEST(cppxx, nlohmann_json_parse_variant) {
+    auto inputs = nlohmann::json::parse(json_inputs).get<std::vector<Input>>();
+
+    ASSERT_EQ(inputs.size(), 4u);
+    EXPECT_EQ(std::get<int>(inputs[0]), 1);
+    EXPECT_EQ(std::get<std::string>(inputs[1]), "a");
+    EXPECT_EQ(std::get<KeyPress>(inputs[2]).key(), "k");
+    EXPECT_EQ(std::get<Click>(inputs[3]).y(), 2);
+
+    Audit audit = nlohmann::json::parse(R"({"event": {"user": "joko", "kind": "logout"}})");
+    EXPECT_EQ(std::get<Logout>(audit.event()).user(), "joko");
+
+    try {
+        audit = nlohmann::json::parse(R"({"event": {"user": "joko", "kind": "reboot"}})");
+        FAIL() << "expected an error";
+    } catch (const cppxx::serde::error &e) {
+        EXPECT_EQ(e.context, ".event.kind");
+    }
+
+    // decoded through the sinks of the reader, the errors being returned with their position
+    using Parse = cppxx::serde::Parse<nlohmann::json, std::string>;
+    ASSERT_TRUE(Parse{json_inputs}.try_into(inputs));
+    EXPECT_EQ(std::get<Click>(inputs[3]).y(), 2);
+
+    auto unknown = Parse{R"({"event": {"user": "joko", "kind": "reboot"}})"}.try_into(audit);
+    ASSERT_FALSE(unknown);
+    EXPECT_EQ(unknown.error().context, ".event.kind");
+
+    auto mismatch = Parse{R"([1, "a", null])"}.try_into(inputs);
+    ASSERT_FALSE(mismatch);
+    EXPECT_EQ(mismatch.error().context, "[2]");
+    EXPECT_EQ(mismatch.error().expected_type, "uint|sint|string|array|object");
+
+    auto nested = Parse{R"([{"x": 1, "y": "2"}])"}.try_into(inputs);
+    ASSERT_FALSE(nested);
+    EXPECT_EQ(nested.error().context, "[0].y");
+}
+
+
+TEST(cppxx, yy_json_enum) {
+    auto account = json::yy_json::parse<Account>(json_account);
+    EXPECT_EQ(account.status(), Status::suspended);
+    EXPECT_EQ(account.prev(), Status::active);
+
+    EXPECT_EQ(json::yy_json::dump(account), json_account);
+    EXPECT_EQ(json::yy_json::Dumper().dump(account), json_account);
+
+    auto unknown = json::yy_json::try_parse<Account>(R"({"name":"Sucipto","status":"banned","prev":0})");
+    ASSERT_FALSE(unknown);
+    EXPECT_EQ(unknown.error().context, ".status");
+
+    auto out_of_range = json::yy_json::try_parse<Account>(R"({"name":"Sucipto","status":"active","prev":7})");
+    ASSERT_FALSE(out_of_range);
+    EXPECT_EQ(out_of_range.error().context, ".prev");
+
+    auto suspension = json::yy_json::parse<Suspension>(R"({"prev":1,"next":null})");
+    EXPECT_EQ(suspension.prev(), Status::suspended);
+    EXPECT_FALSE(suspension.next().has_value());
+    EXPECT_EQ(json::yy_json::dump(suspension), R"({"prev":1,"next":null})");
+    EXPECT_EQ(json::yy_json::Dumper().dump(suspension), R"({"prev":1,"next":null})");
+
+    auto not_enum = json::yy_json::try_parse<BadAccount>(R"({"prev":"0"})");
+    ASSERT_FALSE(not_enum);
+    EXPECT_EQ(not_enum.error().context, ".prev");
+}
+
+
+TEST(cppxx, nlohmann_json_enum) {
+    Account account = nlohmann::json::parse(json_account);
+    EXPECT_EQ(account.status(), Status::suspended);
+    EXPECT_EQ(account.prev(), Status::active);
+
+    EXPECT_EQ(nlohmann::json(account), nlohmann::json::parse(json_account));
+
+    try {
+        account = nlohmann::json::parse(R"({"name":"Sucipto","status":"active","prev":7})");
+        FAIL() << "expected an error";
+    } catch (const cppxx::serde::error &e) {
+        EXPECT_EQ(e.context, ".prev");
+    }
+
+    Suspension suspension = nlohmann::json::parse(R"({"prev":1,"next":null})");
+    EXPECT_EQ(suspension.prev(), Status::suspended);
+    EXPECT_FALSE(suspension.next().has_value());
+    EXPECT_EQ(nlohmann::json(suspension), nlohmann::json::parse(R"({"prev":1,"next":null})"));
+
+    try {
+        nlohmann::json::parse(R"({"prev":"0"})").get<BadAccount>();
+        FAIL() << "expected an error";
+    } catch (const cppxx::serde::error &e) {
+        EXPECT_EQ(e.context, ".prev");
+    }
+}
+
+
+TEST(cppxx, yy_json_parse_in_place) {
+    using Hosts = std::unordered_map<std::string, std::vector<std::string>>;
+
+    Hosts hosts;
+    json::yy_json::parse(R"({"primary": ["db-0001.internal.example.com"], "stale": ["db-0000.internal.example.com"]})", hosts);
+    ASSERT_EQ(hosts.size(), 2u);
+
+    const std::vector<std::string> *entry = &hosts.at("primary");
+    const char                     *chars = entry->at(0).data();
+
+    // same shape: the entry, the vector and the string are reused, the stale key is dropped
+    json::yy_json::parse(R"({"primary": ["db-0002.internal.example.com"]})", hosts);
+    ASSERT_EQ(hosts.size(), 1u);
+    EXPECT_EQ(&hosts.at("primary"), entry);
+    EXPECT_EQ(hosts.at("primary").at(0).data(), chars);
+    EXPECT_EQ(hosts.at("primary").at(0), "db-0002.internal.example.com");
+}
+
+
+TEST(cppxx, yy_json_lazy) {
+    constexpr const char *compact = R"json({"id":7,"items":[1,2,3]})json";
+
+    auto order = json::yy_json::parse<Order>(R"json({ "id": 7, "items": [1, 2, 3] })json");
+    EXPECT_EQ(order.id(), 7);
+    EXPECT_FALSE(order.items().is_decoded());
+    EXPECT_NE(order.items().get_raw(), nullptr);
+
+    // the document outlives the parse, owned by the lazy field
+    EXPECT_EQ(order.items().get(), (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(json::yy_json::dump(order), compact);
+
+    order.items().modify().push_back(4);
+    EXPECT_EQ(order.items().get_raw(), nullptr);
+    EXPECT_EQ(json::yy_json::dump(order), R"json({"id":7,"items":[1,2,3,4]})json");
+
+    // a custom allocator cannot be shared, the field is decoded right away
+    Order eager;
+    json::yy_json::Parser().parse(compact, eager);
+    EXPECT_TRUE(eager.items().is_decoded());
+    EXPECT_EQ(eager.items()->size(), 3u);
+}
+
+
+TEST(cppxx, yy_json_parse_projection) {
+    // `age` is required, but not selected
+    constexpr const char *src = R"json({"salary": 1000, "name": "John", "address": "Somewhere"})json";
+    EXPECT_THROW((void)json::yy_json::parse<Person>(src), cppxx::serde::error);
+
+    auto person = json::yy_json::parse<Person>(src, serde::fields(&Person::name, &Person::salary));
+    EXPECT_EQ(person.name(), "John");
+    EXPECT_EQ(person.salary(), 1000);
+    EXPECT_EQ(person.age(), 0);
+    EXPECT_EQ(person.address(), std::nullopt);
+    EXPECT_EQ(person.department(), "unset");
+
+    EXPECT_EQ(json::yy_json::get<int>(R"json({"a": {"b": [5, 6]}})json", "/a/b/1"), 6);
+    EXPECT_EQ(json::yy_json::get<std::string>(src, "/name"), "John");
+    EXPECT_THROW((void)json::yy_json::get<int>(src, "/age"), cppxx::serde::error);
+}
+
+
+TEST(cppxx, nlohmann_json_parse_projection) {
+    Person person;
+    serde::Parse<nlohmann::json, std::string>{json_missing_age}.into(person, serde::fields(&Person::name));
+    EXPECT_EQ(person.name(), "Sucipto");
+    EXPECT_EQ(person.age(), 0);
+    EXPECT_EQ(person.department(), "unset");
+}
+
+
+TEST(cppxx, yy_json_raw_passthrough) {
+    auto env = json::yy_json::parse<Envelope>(R"json({"kind": "event", "payload": {"a": [1, 2]}})json");
+    EXPECT_EQ(env.payload(), R"json({"a":[1,2]})json");
+
+    // spliced verbatim
+    env.payload() = R"json({ "b" : true })json";
+    EXPECT_EQ(json::yy_json::dump(env), R"json({"kind":"event","payload":{ "b" : true }})json");
+
+    env.payload() = "{";
+    EXPECT_THROW((void)json::yy_json::dump(env), cppxx::serde::error);
+
+    // not validated, only checked to be closed
+    json::yy_json::Dumper dumper(YYJSON_WRITE_NOFLAG, false);
+    EXPECT_THROW((void)dumper.dump(env), cppxx::serde::error);
+
+    env.payload() = R"json({"b": ["}", "\"]"]})json";
+    EXPECT_EQ(dumper.dump(env), R"json({"kind":"event","payload":{"b": ["}", "\"]"]}})json");
+}
+
+
+TEST(cppxx, yy_json_incremental_parse) {
+    const std::string_view src = json_full;
+
+    json::yy_json::IncrementalParser parser;
+    for (int message = 0; message < 2; ++message) {
+        parser.begin(src.size());
+
+        bool done = false;
+        for (size_t pos = 0; pos < src.size(); pos += 16) {
+            EXPECT_FALSE(done);
+            done = parser.feed(src.substr(pos, 16));
+        }
+        ASSERT_TRUE(done);
+
+        auto p = parser.get<Person>();
+        EXPECT_EQ(p.name(), "Sucipto");
+        EXPECT_EQ(p.salary(), 1000);
+    }
+
+    // unknown size, parsed when finished
+    parser.begin();
+    parser.feed(src.substr(0, 10));
+    EXPECT_FALSE(parser.feed(src.substr(10)));
+    EXPECT_EQ(parser.get<Person>().age(), 24);
+
+    parser.begin(src.size());
+    parser.feed(src.substr(0, 10));
+    EXPECT_THROW(parser.finish(), cppxx::serde::error);
+}
+
+
+TEST(cppxx, nlohmann_json_parse_sax) {
+    using Parse = cppxx::serde::Parse<nlohmann::json, std::string>;
+
+    // straight into the fields, unknown keys skipped whatever their shape, the last of duplicated keys wins as in the DOM
+    StaticPerson p;
+    Parse{json_shuffled}.into(p);
+    EXPECT_EQ(p.name(), "Sugeng");
+    EXPECT_EQ(p.age(), 24);
+    EXPECT_FALSE(p.address().has_value());
+    EXPECT_EQ(p.created_at().tm_year + 1900, 2024);
+
+    // variants and enums, the same as from the DOM
+    std::vector<Input> inputs;
+    Parse{json_inputs}.into(inputs);
+    ASSERT_EQ(inputs.size(), 4u);
+    EXPECT_EQ(std::get<KeyPress>(inputs[2]).key(), "k");
+    EXPECT_EQ(std::get<Click>(inputs[3]).y(), 2);
+
+    Audit audit;
+    Parse{R"({"event": {"user": "joko", "kind": "logout"}})"}.into(audit);
+    EXPECT_EQ(std::get<Logout>(audit.event()).user(), "joko");
+
+    MaybeAudit maybe;
+    Parse{R"({"event": {"user": "joko", "kind": "logout"}})"}.into(maybe);
+    ASSERT_TRUE(maybe.event().has_value());
+    EXPECT_EQ(std::get<Logout>(*maybe.event()).user(), "joko");
+
+    Account account;
+    Parse{json_account}.into(account);
+    EXPECT_EQ(account.status(), Status::suspended);
+
+    Suspension suspension;
+    Parse{R"({"prev": 2, "next": null})"}.into(suspension);
+    EXPECT_EQ(suspension.prev(), Status::deleted);
+    EXPECT_FALSE(suspension.next().has_value());
+
+    Envelope env;
+    Parse{R"({"kind": "event", "payload": {"a": [1, 2]}})"}.into(env);
+    EXPECT_EQ(env.payload(), R"({"a":[1,2]})");
+
+    std::unordered_map<std::string, std::vector<int>> groups;
+    Parse{R"({"a": [1, 2], "b": []})"}.into(groups);
+    EXPECT_EQ(groups.at("a"), (std::vector<int>{1, 2}));
+    EXPECT_TRUE(groups.at("b").empty());
+
+    // decoded again in place: the entry of "a" is kept, "b" is dropped
+    const std::vector<int> *a = &groups.at("a");
+    Parse{R"({"c": [], "a": [3], "a": [4]})"}.into(groups);
+    ASSERT_EQ(groups.size(), 2u);
+    EXPECT_EQ(&groups.at("a"), a);
+    EXPECT_EQ(groups.at("a"), (std::vector<int>{4}));
+    EXPECT_EQ(groups.count("b"), 0u);
+
+    // errors carry the position where they happened
+    std::vector<Person> people;
+    auto res = Parse{"[" + std::string(json_full) + R"(, {"name": "Joko", "age": "old"}])"}.try_into(people);
+    ASSERT_FALSE(res);
+    EXPECT_EQ(res.error().context, "[1].age");
+}
+
+
+TEST(cppxx, nlohmann_json_binary) {
+    namespace nl = cppxx::json::nlohmann_json;
+
+    Person p = nlohmann::json::parse(json_full);
+
+    // what nlohmann reads back is the same as the DOM of the value
+    EXPECT_EQ(nlohmann::json::from_msgpack(nl::dump_msgpack(p)), nlohmann::json(p));
+    EXPECT_EQ(nlohmann::json::from_cbor(nl::dump_cbor(p)), nlohmann::json(p));
+    EXPECT_EQ(nlohmann::json::from_bson(nl::dump_bson(p)), nlohmann::json(p));
+
+    for (auto fmt : {nl::format::msgpack, nl::format::cbor, nl::format::bson}) {
+        Person q = nl::parse_binary<Person>(nl::dump_binary(p, fmt), fmt);
+        EXPECT_EQ(q.name(), "Sucipto");
+        EXPECT_EQ(q.age(), 24);
+        EXPECT_EQ(q.address(), p.address());
+        EXPECT_EQ(q.salary(), 1000);
+        EXPECT_EQ(q.created_at().tm_year, p.created_at().tm_year);
+
+        Account account = nl::parse_binary<Account>(nl::dump_binary(nlohmann::json::parse(json_account).get<Account>(), fmt), fmt);
+        EXPECT_EQ(account.status(), Status::suspended);
+        EXPECT_EQ(account.prev(), Status::active);
+
+        Envelope env;
+        env.kind()    = "event";
+        env.payload() = R"({"a":[1,-2.5,null]})";
+        EXPECT_EQ(nl::parse_binary<Envelope>(nl::dump_binary(env, fmt), fmt).payload(), env.payload());
+    }
+
+    // numbers take the smallest encoding
+    EXPECT_EQ(nl::dump_msgpack(std::vector<int64_t>{1, -1, 200, -200, 70000}),
+              nlohmann::json::to_msgpack(nlohmann::json{1, -1, 200, -200, 70000}));
+    EXPECT_EQ(nl::dump_cbor(std::vector<double>{0.5, 0.1}), nlohmann::json::to_cbor(nlohmann::json{0.5, 0.1}));
+
+    // BSON has no top level array
+    EXPECT_THROW((void)nl::dump_bson(std::vector<int>{1}), cppxx::serde::error);
+}
+
+TEST(cppxx, serde_snapshot) {
+    namespace snapshot = cppxx::serde::snapshot;
+
+    const std::string path = ::testing::TempDir() + "cppxx_person_snapshot.json";
+    const std::string snap = snapshot::path_of(path);
+    auto              save = [&](const std::string &content) { std::ofstream(path, std::ios::trunc) << content; };
+    std::remove(snap.c_str());
+    save(json_full);
+
+    // parsed, then written for the next time
+    Person p;
+    EXPECT_FALSE(snapshot::parse_from_file<nlohmann::json>(path, p));
+    EXPECT_EQ(p.name(), "Sucipto");
+
+    Person q;
+    EXPECT_TRUE(snapshot::parse_from_file<nlohmann::json>(path, q));
+    EXPECT_EQ(q.name(), "Sucipto");
+    EXPECT_EQ(q.age(), 24);
+    EXPECT_EQ(q.address(), "Jakarta");
+    EXPECT_EQ(q.department(), "Engineering");
+    EXPECT_EQ(q.salary(), 1000);
+    EXPECT_EQ(q.created_at().tm_year, 124);
+    EXPECT_EQ(q.created_at().tm_sec, 5);
+
+    // a changed source is parsed again
+    std::string changed = json_full;
+    changed.replace(changed.find("Sucipto"), 7, "Sutrisno");
+    save(changed);
+    EXPECT_FALSE(snapshot::parse_from_file<nlohmann::json>(path, q));
+    EXPECT_EQ(q.name(), "Sutrisno");
+    EXPECT_TRUE(snapshot::parse_from_file<nlohmann::json>(path, q));
+
+    // as is a truncated snapshot
+    {
+        std::ifstream     in(snap, std::ios::binary);
+        const std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream(snap, std::ios::binary | std::ios::trunc) << content.substr(0, content.size() - 1);
+    }
+    Person r;
+    EXPECT_FALSE(snapshot::parse_from_file<nlohmann::json>(path, r));
+    EXPECT_EQ(r.name(), "Sutrisno");
+
+    // a field missing from the source takes its default, not the value it had, in `val` and in the snapshot
+    save(json_missing_department);
+    Person stale;
+    stale.department() = "Finance";
+    EXPECT_FALSE(snapshot::parse_from_file<nlohmann::json>(path, stale));
+    EXPECT_EQ(stale.department(), "unset");
+    Person fresh;
+    EXPECT_TRUE(snapshot::parse_from_file<nlohmann::json>(path, fresh));
+    EXPECT_EQ(fresh.department(), "unset");
+
+    // the same fields and tags make the same layout, wherever the tags are kept
+    EXPECT_EQ(snapshot::fingerprint<Person>(), snapshot::fingerprint<StaticPerson>());
+    EXPECT_NE(snapshot::fingerprint<Person>(), snapshot::fingerprint<std::vector<Person>>());
+
+    // enums are stored by value, so renumbering one changes the layout, and so does a changed default
+    EXPECT_NE(snapshot::fingerprint<Level>(), snapshot::fingerprint<RenumberedLevel>());
+    EXPECT_NE(snapshot::fingerprint<Limits>(), snapshot::fingerprint<OtherDefaultLimits>());
+
+    std::remove(path.c_str());
+    std::remove(snap.c_str());
+}
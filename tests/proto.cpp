@@ -0,0 +1,201 @@
+#include <cpp++/proto/google_protobuf.h>
+#include <gtest/gtest.h>
+
+using namespace cppxx;
+using namespace cppxx::literals;
+
+namespace {
+    enum class Role { guest, member, admin };
+
+    struct Address {
+        Tag<std::string> street = "proto:`1`";
+        Tag<int>         number = "proto:`2`";
+    };
+
+    struct Person {
+        Tag<std::string>                name    = "proto:`1`";
+        Tag<int>                        age     = "proto:`2`";
+        Tag<double>                     score   = "proto:`3`";
+        Tag<float>                      ratio   = "proto:`4`";
+        Tag<bool>                       active  = "proto:`5`";
+        Tag<int64_t>                    balance = "proto:`6`";
+        Tag<Role>                       role    = "proto:`7`";
+        Tag<std::optional<std::string>> email   = "proto:`8`";
+        Tag<std::vector<std::string>>   tags    = "proto:`9`";
+        Tag<std::vector<int>>           scores  = "proto:`10`";
+        Tag<Address>                    address = "proto:`11`";
+        Tag<std::vector<uint8_t>>       avatar  = "proto:`12`";
+        Tag<std::vector<Address>>       homes   = "proto:`13`";
+
+        int dummy = 42;
+    };
+
+    // same fields as Person, with the tags given at compile time
+    struct StaticPerson {
+        Tag<std::string, decltype("proto:`1`"_tag)>              name;
+        Tag<int, decltype("proto:`2`"_tag)>                      age;
+        Tag<double, decltype("proto:`3`"_tag)>                   score;
+        Tag<std::vector<std::string>, decltype("proto:`9`"_tag)> tags;
+        Tag<std::vector<int>, decltype("proto:`10`"_tag)>        scores;
+    };
+
+    // an optional embedded message
+    struct Contact {
+        Tag<std::optional<Address>>   home   = "proto:`1`";
+        Tag<Address>                  office = "proto:`2`";
+        Tag<std::vector<std::string>> phones = "proto:`3`";
+    };
+
+    using StaticPersonTuple = decltype(boost::pfr::structure_tie(std::declval<StaticPerson &>()));
+
+    // field number to field index, the numbers of no field giving the number of fields
+    static_assert(proto::static_field_table_v<StaticPersonTuple>.size() == 11);
+    static_assert(proto::static_field_table_v<StaticPersonTuple>[9] == 3);
+    static_assert(proto::static_field_table_v<StaticPersonTuple>[4] == 5);
+
+    Person make_person() {
+        Person p;
+        p.name()             = "Sucipto";
+        p.age()              = -24;
+        p.score()            = 0.1;
+        p.ratio()            = 0.5f;
+        p.active()           = true;
+        p.balance()          = -(int64_t(1) << 40);
+        p.role()             = Role::admin;
+        p.email()            = "sucipto@example.com";
+        p.tags()             = {"a", "", "c"};
+        p.scores()           = {1, -2, 300};
+        p.address().street() = "Jl. Sudirman";
+        p.address().number() = 1;
+        p.avatar()           = {0x89, 'P', 'N', 'G', 0};
+        p.homes()            = {p.address(), Address{}};
+        return p;
+    }
+} // namespace
+
+TEST(cppxx, google_protobuf_round_trip) {
+    const Person      p   = make_person();
+    const std::string buf = proto::google_protobuf::dump(p);
+
+    Person q = proto::google_protobuf::parse<Person>(buf);
+    EXPECT_EQ(q.name(), "Sucipto");
+    EXPECT_EQ(q.age(), -24);
+    EXPECT_EQ(q.score(), 0.1);
+    EXPECT_EQ(q.ratio(), 0.5f);
+    EXPECT_TRUE(q.active());
+    EXPECT_EQ(q.balance(), p.balance());
+    EXPECT_EQ(q.role(), Role::admin);
+    EXPECT_EQ(q.email(), "sucipto@example.com");
+    EXPECT_EQ(q.tags(), p.tags());
+    EXPECT_EQ(q.scores(), p.scores());
+    EXPECT_EQ(q.address().street(), "Jl. Sudirman");
+    EXPECT_EQ(q.address().number(), 1);
+    EXPECT_EQ(q.avatar(), p.avatar());
+    ASSERT_EQ(q.homes().size(), 2u);
+    EXPECT_EQ(q.homes()[0].street(), "Jl. Sudirman");
+    EXPECT_EQ(q.homes()[1].street(), "");
+
+    // the fields of the same numbers, looked up in a table built at compile time
+    StaticPerson s = proto::google_protobuf::parse<StaticPerson>(buf);
+    EXPECT_EQ(s.name(), "Sucipto");
+    EXPECT_EQ(s.age(), -24);
+    EXPECT_EQ(s.score(), 0.1);
+    EXPECT_EQ(s.tags(), p.tags());
+    EXPECT_EQ(s.scores(), p.scores());
+}
+
+TEST(cppxx, google_protobuf_parse_wire) {
+    using WireFormatLite = google::protobuf::internal::WireFormatLite;
+
+    // written as libprotobuf does: packed repeated numbers, sign-extended negative int32 and unknown fields of every
+    // wire type in between
+    std::string buf;
+    {
+        google::protobuf::io::StringOutputStream os(&buf);
+        google::protobuf::io::CodedOutputStream  out(&os);
+
+        WireFormatLite::WriteString(100, "unknown", &out);
+        WireFormatLite::WriteString(1, "Sucipto", &out);
+        WireFormatLite::WriteInt32(2, -24, &out);
+        WireFormatLite::WriteFixed32(101, 7, &out);
+        WireFormatLite::WriteDouble(3, 0.25, &out);
+        WireFormatLite::WriteFixed64(102, 7, &out);
+        WireFormatLite::WriteUInt64(103, 7, &out);
+
+        out.WriteTag(WireFormatLite::MakeTag(10, WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+        out.WriteVarint32(WireFormatLite::Int32Size(1) + WireFormatLite::Int32Size(-2) + WireFormatLite::Int32Size(300));
+        WireFormatLite::WriteInt32NoTag(1, &out);
+        WireFormatLite::WriteInt32NoTag(-2, &out);
+        WireFormatLite::WriteInt32NoTag(300, &out);
+    }
+
+    StaticPerson s = proto::google_protobuf::parse<StaticPerson>(buf);
+    EXPECT_EQ(s.name(), "Sucipto");
+    EXPECT_EQ(s.age(), -24);
+    EXPECT_EQ(s.score(), 0.25);
+    EXPECT_TRUE(s.tags().empty());
+    EXPECT_EQ(s.scores(), (std::vector<int>{1, -2, 300}));
+
+    // the first required field missing
+    Person p;
+    auto   res = proto::google_protobuf::try_parse(buf, p);
+    ASSERT_FALSE(res);
+    EXPECT_EQ(res.error().context, ".4");
+
+    // a field of the wrong wire type, and a truncated message
+    std::string bad;
+    {
+        google::protobuf::io::StringOutputStream os(&bad);
+        google::protobuf::io::CodedOutputStream  out(&os);
+        WireFormatLite::WriteInt32(1, 5, &out);
+    }
+    EXPECT_THROW((void)proto::google_protobuf::parse<StaticPerson>(bad), serde::error);
+    res = proto::google_protobuf::try_parse(bad, p);
+    ASSERT_FALSE(res);
+    EXPECT_EQ(res.error().context, ".1");
+
+    // repeated fields are cleared on their first occurrence and appended to by the next ones, whatever comes in
+    // between, and messages given twice are merged
+    auto street = [](const std::string &v) {
+        std::string                              msg;
+        google::protobuf::io::StringOutputStream os(&msg);
+        google::protobuf::io::CodedOutputStream  out(&os);
+        WireFormatLite::WriteString(1, v, &out);
+        out.Trim();
+        return msg;
+    };
+    auto number = [](int v) {
+        std::string                              msg;
+        google::protobuf::io::StringOutputStream os(&msg);
+        google::protobuf::io::CodedOutputStream  out(&os);
+        WireFormatLite::WriteInt32(2, v, &out);
+        out.Trim();
+        return msg;
+    };
+
+    std::string parts;
+    {
+        google::protobuf::io::StringOutputStream os(&parts);
+        google::protobuf::io::CodedOutputStream  out(&os);
+
+        WireFormatLite::WriteString(3, "1", &out);
+        WireFormatLite::WriteString(1, street("Jl. Sudirman") + number(7), &out);
+        WireFormatLite::WriteString(2, street("Jl. Sudirman") + number(7), &out);
+        WireFormatLite::WriteString(3, "2", &out);
+        WireFormatLite::WriteString(1, number(1), &out);
+        WireFormatLite::WriteString(2, street("Jl. Thamrin"), &out);
+    }
+
+    Contact c;
+    c.phones() = {"0"};
+    proto::google_protobuf::parse(parts, c);
+    EXPECT_EQ(c.phones(), (std::vector<std::string>{"1", "2"}));
+    ASSERT_TRUE(c.home().has_value());
+    EXPECT_EQ(c.home()->street(), "Jl. Sudirman");
+    EXPECT_EQ(c.home()->number(), 1);
+    EXPECT_EQ(c.office().street(), "Jl. Thamrin");
+    EXPECT_EQ(c.office().number(), 7);
+
+    const std::string full = proto::google_protobuf::dump(make_person());
+    EXPECT_THROW((void)proto::google_protobuf::parse<Person>(full.substr(0, full.size() - 3)), serde::error);
+}
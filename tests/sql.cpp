@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 
 namespace sql = cppxx::sql;
+using namespace cppxx::literals;
 
 namespace {
     struct User {
@@ -19,6 +20,18 @@ namespace {
         sql::Column<double> price = "sql:`price real`";
         sql::Column<int>    stock = "sql:`stock integer`";
     };
+
+    // same as Product, with the column definitions given at compile time
+    struct StaticProduct {
+        static constexpr const char *TableName = "Products";
+
+        sql::Column<int, decltype("sql:`id integer primary key`"_tag)> id;
+        sql::Column<double, decltype("sql:`price real`"_tag)>          price;
+        sql::Column<int, decltype("sql:`stock integer`"_tag)>          stock;
+    };
+
+    static_assert(sizeof(sql::Column<int, decltype("sql:`id integer`"_tag)>) == sizeof(int));
+    static_assert(sizeof(StaticProduct) == sizeof(std::tuple<int, double, int>));
 } // namespace
 
 TEST(sql, create_table) {
@@ -81,3 +94,18 @@ TEST(sql, insert_from_select) {
     EXPECT_EQ(s.params, (std::tuple<int>{42}));
     EXPECT_EQ(decltype(s)::row_type{}, std::tuple<>{});
 }
+
+TEST(sql, static_columns) {
+    const StaticProduct products;
+
+    auto c = sql::create_table<StaticProduct>;
+    EXPECT_EQ(c.query, "create table Products (id integer primary key, price real, stock integer)");
+
+    auto s = sql::select(products.price, products.stock)
+                 .from(products)
+                 .where(products.price > 4.99 or products.stock <= 10)
+                 .order_by(products.stock, products.price.desc);
+    EXPECT_EQ(s.query, "select price, stock from Products where (price > ? or stock <= ?) order by stock, price desc");
+    EXPECT_EQ(s.params, (std::tuple<double, int>{4.99, 10}));
+    EXPECT_EQ(decltype(s)::row_type{}, (std::tuple<double, int>{0.0, 0}));
+}
@@ -1,7 +1,15 @@
 #include <cpp++/toml/marzer_toml.h>
+#include <cpp++/toml/live_config.h>
 #include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
 
 using namespace cppxx;
+using namespace cppxx::literals;
 
 namespace {
     struct Person {
@@ -26,6 +34,27 @@ namespace {
         void *ptr   = nullptr;
     };
 
+    struct StaticPerson {
+        Tag<std::string, decltype("toml:`name`"_tag)>                   name;
+        Tag<int, decltype("toml:`age`"_tag)>                            age;
+        Tag<std::string, decltype("toml:`department,skipmissing`"_tag)> department = {"unset"};
+        Tag<std::tm, decltype("toml:`createdAt`"_tag)>                  created_at;
+    };
+
+    struct Server {
+        Tag<std::string>              host  = "toml:`host`";
+        Tag<int>                      port  = "toml:`port`";
+        Tag<std::vector<std::string>> paths = "toml:`paths`";
+    };
+
+    struct Tenant {
+        Tag<std::string>                             name    = "toml:`name`";
+        Tag<Server>                                  server  = "toml:`server`";
+        Tag<std::vector<Server>>                     mirrors = "toml:`mirrors`";
+        Tag<std::unordered_map<std::string, double>> limits  = "toml:`limits`";
+        Tag<std::optional<Person>>                   owner   = "toml:`owner`";
+    };
+
     constexpr const char *toml_full = R"toml(
     name = "Sucipto"
     age = 24
@@ -42,6 +71,14 @@ namespace {
     salary = 1000
     createdAt = 2024-01-02T03:04:05Z
     )toml";
+
+    constexpr const char *toml_shuffled = R"toml(
+    createdAt = 2024-01-02T03:04:05Z
+    unknown = [1, 2, 3]
+    salary = 1000
+    age = 24
+    name = "Sucipto"
+    )toml";
 } // namespace
 
 TEST(cppxx, marzer_toml_parse_full) {
@@ -77,3 +114,107 @@ TEST(cppxx, marzer_toml_parse_missing_department) {
     // fallback value
     EXPECT_EQ(p.department(), "unset");
 }
+
+
+TEST(cppxx, marzer_toml_static_tags) {
+    StaticPerson p = cppxx::toml::marzer_toml::parse<StaticPerson>(toml_missing_department);
+
+    EXPECT_EQ(p.name(), "Sucipto");
+    EXPECT_EQ(p.age(), 24);
+    EXPECT_EQ(p.department(), "unset");
+    EXPECT_EQ(p.created_at().tm_mday, 2);
+}
+
+
+TEST(cppxx, marzer_toml_parse_shuffled) {
+    Person p = cppxx::toml::marzer_toml::parse<Person>(toml_shuffled);
+
+    EXPECT_EQ(p.name(), "Sucipto");
+    EXPECT_EQ(p.age(), 24);
+    EXPECT_FALSE(p.address().has_value());
+    EXPECT_EQ(p.department(), "unset");
+    EXPECT_EQ(p.salary(), 1000);
+
+    StaticPerson s = cppxx::toml::marzer_toml::parse<StaticPerson>(toml_shuffled);
+
+    EXPECT_EQ(s.name(), "Sucipto");
+    EXPECT_EQ(s.age(), 24);
+    EXPECT_EQ(s.department(), "unset");
+    EXPECT_EQ(s.created_at().tm_mday, 2);
+}
+
+
+TEST(cppxx, marzer_toml_dump) {
+    Tenant t;
+    t.name()           = "it's \"quoted\"";
+    t.server().host()  = "localhost";
+    t.server().port()  = 8080;
+    t.server().paths() = {"/", "/api"};
+    for (int i = 0; i < 20; ++i)
+        t.server().paths().push_back("/api/v1/resource-" + std::to_string(i));
+    t.mirrors() = {t.server(), t.server()};
+    t.mirrors()[1].paths().clear();
+    t.limits() = {{"rate", 0.1}, {"burst size", 100.0}};
+    t.owner()  = cppxx::toml::marzer_toml::parse<Person>(toml_full);
+
+    // the same text as printing the table built from the value
+    auto               tbl = cppxx::serde::Serialize<::toml::node, Tenant>{}.from(t);
+    std::ostringstream oss;
+    oss << *tbl->as_table();
+    EXPECT_EQ(cppxx::toml::marzer_toml::dump(t), oss.str());
+
+    Tenant back = cppxx::toml::marzer_toml::parse<Tenant>(oss.str());
+    EXPECT_EQ(back.name(), t.name());
+    EXPECT_EQ(back.mirrors().size(), 2u);
+    EXPECT_EQ(back.server().paths(), t.server().paths());
+    EXPECT_EQ(back.owner()->created_at().tm_sec, 5);
+
+    // a reused dumper gives the same text
+    cppxx::toml::marzer_toml::Dumper dumper;
+    EXPECT_EQ(dumper.dump(t), oss.str());
+    t.owner()->salary() = 0;
+    EXPECT_EQ(dumper.dump(t).find("salary"), std::string::npos);
+}
+
+TEST(cppxx, marzer_toml_live_config) {
+    const auto path = std::filesystem::temp_directory_path() / "cppxx_live_config.toml";
+    auto       save = [&](const char *content) {
+        // replaced by a rename, as editors do
+        const auto tmp = path.string() + ".tmp";
+        std::ofstream(tmp) << content;
+        std::filesystem::rename(tmp, path);
+    };
+    auto wait_version = [](const auto &config, uint64_t version) {
+        for (int i = 0; i < 200 && config.version() < version; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return config.version();
+    };
+
+    save("host = 'localhost'\nport = 8080\npaths = ['/']\n");
+    cppxx::toml::live_config<Server> config(path.string());
+    auto                             reader = config.make_reader();
+    EXPECT_EQ(config.version(), 1u);
+    EXPECT_EQ(reader->port(), 8080);
+
+    auto old = config.snapshot();
+    save("host = 'localhost'\nport = 9090\npaths = ['/']\n");
+    EXPECT_EQ(wait_version(config, 2), 2u);
+    EXPECT_EQ(reader->port(), 9090);
+    EXPECT_EQ(old->port(), 8080);
+
+    // same content, nothing published
+    auto res = config.reload();
+    ASSERT_TRUE(res);
+    EXPECT_FALSE(*res);
+    EXPECT_EQ(config.version(), 2u);
+
+    // invalid content keeps the previous snapshot
+    save("port = 'not a number'\n");
+    res = config.reload();
+    EXPECT_FALSE(res);
+    EXPECT_TRUE(config.last_error());
+    EXPECT_EQ(config.version(), 2u);
+    EXPECT_EQ(reader->port(), 9090);
+
+    std::filesystem::remove(path);
+}